@@ -0,0 +1,253 @@
+/*
+ * Filename: arctic_nord_bench.c
+ *
+ * Description: Measures libarcticnord: the time per color of formatting in
+ * each format, one at a time and in batches, of parsing each format back, of
+ * the color-space conversions and palette transforms, of nearest-palette
+ * search and of k-d tree search in a table the size of the color name lists,
+ * and the time to export a palette of EXPORT_COLORS colors with each
+ * exporter, into a buffer and into /dev/null. The colors are spread over
+ * the whole sRGB cube.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arctic_nord.h"
+#include "arctic_nord_export.h"
+#include "arctic_nord_index.h"
+
+#define BATCH 256
+#define DEFAULT_ITERATIONS 1000000U
+#define EXPORT_COLORS 100000U
+#define EXPORT_LABEL_SIZE 12
+#define EXPORT_RUNS 10
+#define INDEX_COLORS 1000U
+
+static uint32_t colors[BATCH];
+static char texts[NORD_FORMAT_COUNT][BATCH][NORD_TEXT_SIZE];
+static size_t lengths[NORD_FORMAT_COUNT][BATCH];
+
+// Folded into every result and printed, so no work is optimized away.
+static uint64_t sink;
+
+// The palette exported: labels and texts in every format.
+static char export_labels[EXPORT_COLORS][EXPORT_LABEL_SIZE];
+static uint32_t export_colors[EXPORT_COLORS];
+static char export_texts[NORD_FORMAT_COUNT][EXPORT_COLORS][NORD_TEXT_SIZE];
+static char export_buf[EXPORT_COLORS * 128];
+static NordWriter writer;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t start_ns, uint32_t count) {
+    double ns = (double)(now_ns() - start_ns) / count;
+    (void)printf("%-24s %8.1f ns\n", name, ns);
+}
+
+static NordExportPalette export_palette(NordExport kind) {
+    NordFormat format = nord_export_format(kind, NORD_FORMAT_HTML_HEX);
+    return (NordExportPalette){ .count        = EXPORT_COLORS,
+                                .labels       = export_labels[0],
+                                .label_stride = EXPORT_LABEL_SIZE,
+                                .texts        = export_texts[format][0],
+                                .text_stride  = NORD_TEXT_SIZE };
+}
+
+// Milliseconds per export of the whole palette with each exporter.
+static void bench_exports(void) {
+    for (uint32_t i = 0; i < EXPORT_COLORS; i++) {  // NOLINT
+        export_colors[i] = (i * 2654435761U) & 0xFFFFFFU;
+        (void)snprintf(export_labels[i], EXPORT_LABEL_SIZE, "color%u", i);
+    }
+    for (int f = 0; f < NORD_FORMAT_COUNT; f++) {  // NOLINT
+        nord_format_colors(export_colors, EXPORT_COLORS, (NordFormat)f,
+                           export_texts[f], nullptr);
+    }
+    int null_fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+
+    (void)printf("per export, %u colors\n", EXPORT_COLORS);
+    char name[64];
+    for (int k = 0; k < NORD_EXPORT_COUNT; k++) {  // NOLINT
+        NordExport kind           = (NordExport)k;
+        NordExportPalette palette = export_palette(kind);
+
+        uint64_t start = now_ns();
+        for (int run = 0; run < EXPORT_RUNS; run++) {  // NOLINT
+            nord_writer_buffer(&writer, export_buf, sizeof(export_buf));
+            sink += (uint64_t)nord_export(&writer, kind, &palette) +
+                    writer.total;
+        }
+        double ms = (double)(now_ns() - start) / EXPORT_RUNS / 1e6;
+        (void)snprintf(name, sizeof(name), "export %s",
+                       nord_export_name(kind));
+        (void)printf("%-24s %8.2f ms  %zu bytes\n", name, ms, writer.total);
+
+        if (null_fd < 0) {
+            continue;
+        }
+        start = now_ns();
+        for (int run = 0; run < EXPORT_RUNS; run++) {  // NOLINT
+            nord_writer_fd(&writer, null_fd);
+            sink += (uint64_t)nord_export(&writer, kind, &palette);
+        }
+        ms = (double)(now_ns() - start) / EXPORT_RUNS / 1e6;
+        (void)snprintf(name, sizeof(name), "writev %s",
+                       nord_export_name(kind));
+        (void)printf("%-24s %8.2f ms\n", name, ms);
+    }
+    if (null_fd >= 0) {
+        close(null_fd);
+    }
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    for (int i = 1; i < argc; i++) {  // NOLINT(altera-unroll-loops)
+        if (strncmp(argv[i], "--iterations=", 13) == 0) {
+            iterations = (uint32_t)strtoul(argv[i] + 13, nullptr, 10);
+        } else {
+            (void)fprintf(stderr, "Usage: %s [--iterations=N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    iterations = (iterations + BATCH - 1) / BATCH * BATCH;
+    if (iterations == 0) {
+        iterations = BATCH;
+    }
+
+    // A fixed multiplicative walk over the cube.
+    for (uint32_t i = 0; i < BATCH; i++) {  // NOLINT(altera-unroll-loops)
+        colors[i] = (i * 2654435761U) & 0xFFFFFFU;
+    }
+    for (int f = 0; f < NORD_FORMAT_COUNT; f++) {  // NOLINT
+        nord_format_colors(colors, BATCH, (NordFormat)f, texts[f], lengths[f]);
+    }
+
+    (void)printf("per color, %u colors\n", iterations);
+    char name[64];
+    for (int f = 0; f < NORD_FORMAT_COUNT; f++) {  // NOLINT
+        NordFormat format = (NordFormat)f;
+        char text[NORD_TEXT_SIZE];
+        uint64_t start = now_ns();
+        for (uint32_t i = 0; i < iterations; i++) {  // NOLINT
+            sink += nord_format_color(colors[i % BATCH], format, text,
+                                      sizeof(text));
+        }
+        (void)snprintf(name, sizeof(name), "format %s",
+                       nord_format_name(format));
+        report(name, start, iterations);
+
+        start = now_ns();
+        for (uint32_t i = 0; i < iterations; i += BATCH) {  // NOLINT
+            nord_format_colors(colors, BATCH, format, texts[f], lengths[f]);
+            sink += lengths[f][i % BATCH];
+        }
+        (void)snprintf(name, sizeof(name), "batch %s",
+                       nord_format_name(format));
+        report(name, start, iterations);
+
+        start = now_ns();
+        for (uint32_t i = 0; i < iterations; i++) {  // NOLINT
+            uint32_t color = 0;
+            size_t n       = i % BATCH;
+            sink += (uint64_t)nord_parse_color(texts[f][n], lengths[f][n],
+                                               &color, nullptr) +
+                    color;
+        }
+        (void)snprintf(name, sizeof(name), "parse %s",
+                       nord_format_name(format));
+        report(name, start, iterations);
+    }
+
+    NordOklab labs[BATCH];
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iterations; i += BATCH) {  // NOLINT
+        nord_rgb_to_oklab_n(colors, BATCH, labs);
+        sink += (uint64_t)(labs[i % BATCH].l * 1000.0F);
+    }
+    report("sRGB to OKLab", start, iterations);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {  // NOLINT
+        sink += nord_oklab_to_rgb(labs[i % BATCH]);
+    }
+    report("OKLab to sRGB", start, iterations);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {  // NOLINT
+        NordOklch lch = nord_oklab_to_oklch(labs[i % BATCH]);
+        sink += nord_oklab_to_rgb(nord_oklch_to_oklab(lch));
+    }
+    report("OKLCH round trip", start, iterations);
+
+    NordTransform transform = { .hue         = 30.0F,
+                                .lightness   = 1.1F,
+                                .chroma      = 0.9F,
+                                .temperature = 0.2F };
+    uint32_t transformed[BATCH];
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i += BATCH) {  // NOLINT
+        nord_transform_n(labs, BATCH, &transform, transformed);
+        sink += transformed[i % BATCH];
+    }
+    report("transform", start, iterations);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {  // NOLINT
+        sink += nord_hsl_to_rgb(nord_rgb_to_hsl(colors[i % BATCH]));
+    }
+    report("HSL round trip", start, iterations);
+
+    NordOklab palette[NORD_PALETTE_LENGTH];
+    nord_rgb_to_oklab_n(nord_palette, NORD_PALETTE_LENGTH, palette);
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {  // NOLINT
+        sink += nord_nearest(palette, NORD_PALETTE_LENGTH, labs[i % BATCH]);
+    }
+    report("nearest of 16", start, iterations);
+
+    static uint32_t table[INDEX_COLORS];
+    static NordOklab table_labs[INDEX_COLORS];
+    static NordIndexNode nodes[INDEX_COLORS];
+    for (uint32_t i = 0; i < INDEX_COLORS; i++) {  // NOLINT
+        table[i] = (i * 40503U * 2654435761U) & 0xFFFFFFU;
+    }
+    nord_rgb_to_oklab_n(table, INDEX_COLORS, table_labs);
+    NordIndex index;
+    start = now_ns();
+    nord_index_build(&index, table, INDEX_COLORS, nodes);
+    report("k-d tree build of 1000", start, 1);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {  // NOLINT
+        sink += nord_index_nearest(&index, labs[i % BATCH]);
+    }
+    report("k-d tree of 1000", start, iterations);
+
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {  // NOLINT
+        sink += nord_nearest(table_labs, INDEX_COLORS, labs[i % BATCH]);
+    }
+    report("nearest of 1000", start, iterations);
+
+    bench_exports();
+
+    (void)printf("checksum %llu\n", (unsigned long long)sink);
+    return EXIT_SUCCESS;
+}
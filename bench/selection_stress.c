@@ -0,0 +1,312 @@
+/*
+ * Filename: selection_stress.c
+ *
+ * Description: Stress test for the dock's CLIPBOARD serving. It opens many
+ * requestor clients, each with its own connection and window, has them all
+ * paste at the same time, round after round, and reports throughput and the
+ * worst paste latency. Large clipboards are read through INCR. Optionally
+ * half of the requests ask for TARGETS, like polling clipboard managers,
+ * and some requestors destroy their window right after asking to paste.
+ * With a latency limit it fails if any paste took longer, which
+ * make check-paste-latency uses while the dock runs a job on a worker.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_CLIENTS 1000
+#define DEFAULT_CLIENTS 100
+#define DEFAULT_ROUNDS 20
+#define PASTE_TIMEOUT_NS 10000000000ULL
+#define POLL_INTERVAL_MS 100
+
+typedef enum {
+    ATOM_CLIPBOARD,
+    ATOM_UTF8_STRING,
+    ATOM_TARGETS,
+    ATOM_INCR,
+    ATOM_PROPERTY,
+    ATOM_COUNT
+} StressAtom;
+
+static char *atom_names[ATOM_COUNT] = { "CLIPBOARD", "UTF8_STRING", "TARGETS",
+                                        "INCR", "ARCTIC_NORD_STRESS" };
+
+typedef enum {
+    CLIENT_IDLE,
+    CLIENT_WAIT_NOTIFY,  // Waiting for SelectionNotify.
+    CLIENT_WAIT_CHUNK,   // Reading an INCR transfer.
+    CLIENT_DONE
+} ClientPhase;
+
+typedef struct {
+    Display *display;
+    Window window;
+    Atom atoms[ATOM_COUNT];
+    ClientPhase phase;
+    uint32_t rounds_left;
+    uint64_t start_ns;
+    size_t bytes;
+    bool incr;
+} Client;
+
+static struct {
+    uint32_t targets_every;  // Ask for TARGETS every n-th paste, or never.
+    uint32_t abandon_every;  // Destroy the window every n-th paste, or never.
+    uint64_t limit_ns;       // Worst latency allowed, or 0 for any.
+    uint64_t requests;
+    uint64_t pastes;
+    uint64_t incr_pastes;
+    uint64_t failed;
+    uint64_t timed_out;
+    uint64_t abandoned;
+    uint64_t bytes;
+    uint64_t total_ns;
+    uint64_t worst_ns;
+} run;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static Window create_requestor(Display *display) {
+    Window window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0,
+                                        0, 1, 1, 0, 0, 0);
+    XSelectInput(display, window, PropertyChangeMask);
+    return window;
+}
+
+static void start_paste(Client *client) {
+    if (client->rounds_left == 0) {
+        client->phase = CLIENT_DONE;
+        return;
+    }
+    client->rounds_left--;
+    run.requests++;
+
+    Atom target = client->atoms[ATOM_UTF8_STRING];
+    if (run.targets_every && run.requests % run.targets_every == 0) {
+        target = client->atoms[ATOM_TARGETS];
+    }
+    XConvertSelection(client->display, client->atoms[ATOM_CLIPBOARD], target,
+                      client->atoms[ATOM_PROPERTY], client->window,
+                      CurrentTime);
+    client->phase    = CLIENT_WAIT_NOTIFY;
+    client->start_ns = now_ns();
+    client->bytes    = 0;
+    client->incr     = false;
+
+    // Walk away mid-paste; the owner must cope with the missing window.
+    if (run.abandon_every && run.requests % run.abandon_every == 0) {
+        XDestroyWindow(client->display, client->window);
+        client->window = create_requestor(client->display);
+        run.abandoned++;
+        start_paste(client);
+        return;
+    }
+    XFlush(client->display);
+}
+
+static void finish_paste(Client *client, bool ok) {
+    uint64_t elapsed = now_ns() - client->start_ns;
+    if (ok) {
+        run.pastes++;
+        run.incr_pastes += client->incr ? 1 : 0;
+        run.bytes += client->bytes;
+        run.total_ns += elapsed;
+        if (elapsed > run.worst_ns) {
+            run.worst_ns = elapsed;
+        }
+    } else {
+        run.failed++;
+    }
+    start_paste(client);
+}
+
+// Read and delete the property. Returns its size in bytes, and sets incr if
+// it announces an INCR transfer.
+static size_t take_property(Client *client, bool *incr) {
+    Atom type           = None;
+    int format          = 0;
+    unsigned long items = 0;
+    unsigned long after = 0;
+    unsigned char *data = nullptr;
+    if (XGetWindowProperty(client->display, client->window,
+                           client->atoms[ATOM_PROPERTY], 0, LONG_MAX / 4, True,
+                           AnyPropertyType, &type, &format, &items, &after,
+                           &data) != Success) {
+        return 0;
+    }
+    if (data) {
+        XFree(data);
+    }
+    *incr = type == client->atoms[ATOM_INCR];
+    return items * (size_t)(format / 8);
+}
+
+static void handle_event(Client *client, const XEvent *event) {
+    bool incr = false;
+    if (event->type == SelectionNotify &&
+        client->phase == CLIENT_WAIT_NOTIFY &&
+        event->xselection.requestor == client->window) {
+        if (event->xselection.property == None) {
+            finish_paste(client, false);
+            return;
+        }
+        size_t size = take_property(client, &incr);
+        if (incr) {
+            // Deleting the INCR property asked for the first chunk.
+            client->incr  = true;
+            client->phase = CLIENT_WAIT_CHUNK;
+            return;
+        }
+        client->bytes = size;
+        finish_paste(client, true);
+    } else if (event->type == PropertyNotify &&
+               client->phase == CLIENT_WAIT_CHUNK &&
+               event->xproperty.window == client->window &&
+               event->xproperty.atom == client->atoms[ATOM_PROPERTY] &&
+               event->xproperty.state == PropertyNewValue) {
+        size_t size = take_property(client, &incr);
+        client->bytes += size;
+        if (size == 0) {
+            finish_paste(client, true);
+        }
+    }
+}
+
+static void drain(Client *client) {
+    while (XPending(client->display) > 0) {  // NOLINT(altera-unroll-loops)
+        XEvent event;
+        XNextEvent(client->display, &event);
+        handle_event(client, &event);
+    }
+    XFlush(client->display);
+}
+
+static uint32_t parse_count(const char *arg, const char *prefix) {
+    return (uint32_t)strtoul(arg + strlen(prefix), nullptr, 10);
+}
+
+int main(int argc, char **argv) {
+    uint32_t client_count = DEFAULT_CLIENTS;
+    uint32_t rounds       = DEFAULT_ROUNDS;
+    for (int i = 1; i < argc; i++) {  // NOLINT(altera-unroll-loops)
+        if (strncmp(argv[i], "--clients=", 10) == 0) {
+            client_count = parse_count(argv[i], "--clients=");
+        } else if (strncmp(argv[i], "--rounds=", 9) == 0) {
+            rounds = parse_count(argv[i], "--rounds=");
+        } else if (strcmp(argv[i], "--targets") == 0) {
+            run.targets_every = 2;
+        } else if (strncmp(argv[i], "--abandon=", 10) == 0) {
+            run.abandon_every = parse_count(argv[i], "--abandon=");
+        } else if (strncmp(argv[i], "--max-latency=", 14) == 0) {
+            run.limit_ns =
+                (uint64_t)parse_count(argv[i], "--max-latency=") * 1000000U;
+        } else {
+            (void)fprintf(stderr,
+                          "Usage: %s [--clients=N] [--rounds=N] [--targets] "
+                          "[--abandon=N] [--max-latency=MS]\n"
+                          "  --targets    ask for TARGETS in every other "
+                          "request\n"
+                          "  --abandon=N  destroy the requestor window in "
+                          "every N-th request\n"
+                          "  --max-latency=MS\n"
+                          "               fail if any paste took longer\n",
+                          argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (client_count == 0 || client_count > MAX_CLIENTS) {
+        client_count = DEFAULT_CLIENTS;
+    }
+
+    static Client clients[MAX_CLIENTS];
+    static struct pollfd fds[MAX_CLIENTS];
+    for (uint32_t i = 0; i < client_count; i++) {  // NOLINT
+        Client *client  = &clients[i];
+        client->display = XOpenDisplay(nullptr);
+        if (!client->display) {
+            (void)fprintf(stderr, "Cannot open connection %u.\n", i + 1);
+            return EXIT_FAILURE;
+        }
+        XInternAtoms(client->display, atom_names, ATOM_COUNT, False,
+                     client->atoms);
+        client->window      = create_requestor(client->display);
+        client->rounds_left = rounds;
+        fds[i].fd           = ConnectionNumber(client->display);
+        fds[i].events       = POLLIN;
+    }
+    Window owner = XGetSelectionOwner(clients[0].display,
+                                      clients[0].atoms[ATOM_CLIPBOARD]);
+    if (owner == None) {
+        (void)fprintf(stderr, "Nothing owns the CLIPBOARD; click a color in "
+                              "the dock first.\n");
+        return EXIT_FAILURE;
+    }
+
+    uint64_t start_ns = now_ns();
+    for (uint32_t i = 0; i < client_count; i++) {  // NOLINT
+        start_paste(&clients[i]);
+    }
+    uint32_t active = client_count;
+    while (active > 0) {  // NOLINT(altera-unroll-loops)
+        (void)poll(fds, (nfds_t)client_count, POLL_INTERVAL_MS);
+        active         = 0;
+        uint64_t check = now_ns();
+        for (uint32_t i = 0; i < client_count; i++) {  // NOLINT
+            Client *client = &clients[i];
+            drain(client);
+            if (client->phase != CLIENT_DONE &&
+                check - client->start_ns > PASTE_TIMEOUT_NS) {
+                run.timed_out++;
+                start_paste(client);
+                XFlush(client->display);
+            }
+            active += client->phase != CLIENT_DONE ? 1 : 0;
+        }
+    }
+    double elapsed = (double)(now_ns() - start_ns) / 1e9;
+
+    uint64_t avg_ns = run.pastes ? run.total_ns / run.pastes : 0;
+    (void)printf("clients:      %u x %u pastes\n"
+                 "pastes:       %llu (%llu through INCR)\n"
+                 "failed:       %llu (%llu timed out, %llu windows "
+                 "abandoned)\n"
+                 "throughput:   %.0f pastes/s, %.2f MB/s\n"
+                 "latency:      avg %.2f ms, worst %.2f ms\n",
+                 client_count, rounds, (unsigned long long)run.pastes,
+                 (unsigned long long)run.incr_pastes,
+                 (unsigned long long)(run.failed + run.timed_out),
+                 (unsigned long long)run.timed_out,
+                 (unsigned long long)run.abandoned,
+                 (double)run.pastes / elapsed,
+                 (double)run.bytes / elapsed / 1e6, (double)avg_ns / 1e6,
+                 (double)run.worst_ns / 1e6);
+
+    for (uint32_t i = 0; i < client_count; i++) {  // NOLINT
+        XCloseDisplay(clients[i].display);
+    }
+    if (run.limit_ns && run.worst_ns > run.limit_ns) {
+        (void)fprintf(stderr, "Worst paste took %.2f ms, over %.2f ms.\n",
+                      (double)run.worst_ns / 1e6,
+                      (double)run.limit_ns / 1e6);
+        return EXIT_FAILURE;
+    }
+    return run.timed_out == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
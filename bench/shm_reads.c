@@ -0,0 +1,199 @@
+/*
+ * Filename: shm_reads.c
+ *
+ * Description: Measures how many palette snapshots per second readers get
+ * from the published segment. It reads from a running dock, or with --writer
+ * from a private segment that a thread rewrites the given number of times per
+ * second, checking every snapshot for torn reads.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arctic_nord_shm.h"
+
+#define MAX_THREADS 64
+#define DEFAULT_WRITES_PER_S 1000
+
+static atomic_bool stop;
+
+typedef struct {
+    pthread_t thread;
+    const char *name;
+    bool check;
+    uint64_t reads;
+    uint64_t failures;
+    uint64_t torn;
+} Reader;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+// The writer gives every entry of a snapshot the same color, so a snapshot
+// mixing two updates shows up as differing colors.
+static bool consistent(const NordShmPalette *palette) {
+    for (uint32_t i = 1; i < NORD_SHM_COLORS; i++) {  // NOLINT
+        if (palette->entries[i].color != palette->entries[0].color) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *read_loop(void *arg) {
+    Reader *reader = arg;
+    NordShm shm;
+    if (nord_shm_open(&shm, reader->name) != 0) {
+        reader->failures++;
+        return nullptr;
+    }
+    // Count locally; readers share cache lines in the readers array.
+    NordShmPalette palette;
+    uint64_t reads    = 0;
+    uint64_t failures = 0;
+    uint64_t torn     = 0;
+    while (!atomic_load_explicit(&stop,  // NOLINT(altera-unroll-loops)
+                                 memory_order_relaxed)) {
+        if (nord_shm_read(&shm, &palette) != 0) {
+            failures++;
+        } else if (reader->check && !consistent(&palette)) {
+            torn++;
+        }
+        reads++;
+    }
+    nord_shm_close(&shm);
+    reader->reads    = reads;
+    reader->failures = failures;
+    reader->torn     = torn;
+    return nullptr;
+}
+
+static NordShm writer_shm;
+static long writes_per_s;
+
+static void *write_loop(void *arg) {
+    (void)arg;
+    struct timespec period = { .tv_nsec = 0 };
+    if (writes_per_s > 1) {
+        period.tv_nsec = 1000000000L / writes_per_s;
+    } else if (writes_per_s == 1) {
+        period.tv_sec = 1;
+    }
+    NordShmPalette palette;
+    memset(&palette, 0, sizeof(palette));
+    palette.count = NORD_SHM_COLORS;
+    for (uint32_t n = 0;  // NOLINT(altera-unroll-loops)
+         !atomic_load_explicit(&stop, memory_order_relaxed); n++) {
+        palette.format = n;
+        for (uint32_t i = 0; i < NORD_SHM_COLORS; i++) {  // NOLINT
+            palette.entries[i].color = n;
+        }
+        nord_shm_publish(&writer_shm, &palette);
+        if (writes_per_s > 0) {
+            (void)nanosleep(&period, nullptr);
+        }
+    }
+    return nullptr;
+}
+
+int main(int argc, char **argv) {
+    double seconds  = 1.0;
+    long threads    = 1;
+    bool own_writer = false;
+    for (int i = 1; i < argc; i++) {  // NOLINT(altera-unroll-loops)
+        if (strncmp(argv[i], "--seconds=", 10) == 0) {
+            seconds = strtod(argv[i] + 10, nullptr);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = strtol(argv[i] + 10, nullptr, 10);
+        } else if (strcmp(argv[i], "--writer") == 0) {
+            own_writer   = true;
+            writes_per_s = DEFAULT_WRITES_PER_S;
+        } else if (strncmp(argv[i], "--writer=", 9) == 0) {
+            own_writer   = true;
+            writes_per_s = strtol(argv[i] + 9, nullptr, 10);
+        } else {
+            (void)fprintf(stderr,
+                          "Usage: %s [--seconds=F] [--threads=N] "
+                          "[--writer[=WRITES_PER_S]]\n"
+                          "  --writer=0 rewrites the palette nonstop\n",
+                          argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (threads < 1 || threads > MAX_THREADS) {
+        threads = 1;
+    }
+
+    char name[NORD_SHM_NAME_SIZE];
+    pthread_t writer;
+    if (own_writer) {
+        (void)snprintf(name, sizeof(name), "/arctic-nord-bench-%d",
+                       (int)getpid());
+        if (nord_shm_create(&writer_shm, name) != 0) {
+            perror("nord_shm_create");
+            return EXIT_FAILURE;
+        }
+        (void)pthread_create(&writer, nullptr, write_loop, nullptr);
+    } else {
+        nord_shm_default_name(name, sizeof(name));
+    }
+
+    static Reader readers[MAX_THREADS];
+    uint64_t start_ns = now_ns();
+    for (long i = 0; i < threads; i++) {  // NOLINT(altera-unroll-loops)
+        readers[i].name  = name;
+        readers[i].check = own_writer;
+        (void)pthread_create(&readers[i].thread, nullptr, read_loop,
+                             &readers[i]);
+    }
+    struct timespec duration = {
+        .tv_sec  = (time_t)seconds,
+        .tv_nsec = (long)((seconds - (double)(time_t)seconds) * 1e9),
+    };
+    (void)nanosleep(&duration, nullptr);
+    atomic_store(&stop, true);
+
+    uint64_t reads    = 0;
+    uint64_t failures = 0;
+    uint64_t torn     = 0;
+    for (long i = 0; i < threads; i++) {  // NOLINT(altera-unroll-loops)
+        (void)pthread_join(readers[i].thread, nullptr);
+        reads += readers[i].reads;
+        failures += readers[i].failures;
+        torn += readers[i].torn;
+    }
+    double elapsed = (double)(now_ns() - start_ns) / 1e9;
+    if (own_writer) {
+        (void)pthread_join(writer, nullptr);
+        nord_shm_destroy(&writer_shm, name);
+    }
+
+    if (reads == 0) {
+        (void)fprintf(stderr, "No palette is published under %s.\n", name);
+        return EXIT_FAILURE;
+    }
+    (void)printf("readers:      %ld%s\n"
+                 "reads:        %llu (%.1f M/s, %.1f M/s per reader)\n"
+                 "failed reads: %llu\n"
+                 "torn reads:   %llu\n",
+                 threads, own_writer ? " (with a writer)" : "",
+                 (unsigned long long)reads, (double)reads / elapsed / 1e6,
+                 (double)reads / elapsed / 1e6 / (double)threads,
+                 (unsigned long long)failures, (unsigned long long)torn);
+    return torn == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
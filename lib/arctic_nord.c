@@ -0,0 +1,743 @@
+/*
+ * Filename: arctic_nord.c
+ *
+ * Description: Implements libarcticnord: formatting and parsing colors,
+ * conversion between sRGB, HSL, OKLab and OKLCH, nearest-color search and
+ * gradients between two colors. OKLab follows Björn Ottosson's definition.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "arctic_nord.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DEGREES_PER_RADIAN 57.29577951308232
+
+NORD_API const uint32_t nord_palette[NORD_PALETTE_LENGTH] = {
+    NORD0, NORD1, NORD2,  NORD3,  NORD4,  NORD5,  NORD6,  NORD7,
+    NORD8, NORD9, NORD10, NORD11, NORD12, NORD13, NORD14, NORD15
+};
+
+// Format names, in NordFormat order, as shown in the menu.
+static const char *format_names[NORD_FORMAT_COUNT] = {
+    "HTML HEX", "Raw HEX", "CSS RGB", "CSS RGBA", "HSL", "Float", "Vec3", "Vec4"
+};
+
+NORD_API const char *nord_format_name(NordFormat format) {
+    return format < NORD_FORMAT_COUNT ? format_names[format] : "";
+}
+
+// HSL in double precision, as written by the HSL format.
+static void rgb_to_hsl(uint32_t color, double *h, double *s, double *l) {
+    double r_norm = ((color >> 16U) & 0xFFU) / 255.0;
+    double g_norm = ((color >> 8U) & 0xFFU) / 255.0;
+    double b_norm = (color & 0xFFU) / 255.0;
+    double max    = fmax(r_norm, fmax(g_norm, b_norm));
+    double min    = fmin(r_norm, fmin(g_norm, b_norm));
+    double delta  = max - min;
+    *h            = 0.0;
+    *s            = 0.0;
+    *l            = (max + min) / 2.0;
+
+    if (delta != 0.0) {
+        *s = (*l < 0.5) ? delta / (max + min) : delta / (2.0 - max - min);
+        if (max == r_norm) {
+            *h = (g_norm - b_norm) / delta;
+        } else if (max == g_norm) {
+            *h = 2.0 + (b_norm - r_norm) / delta;
+        } else {  // max == b_norm
+            *h = 4.0 + (r_norm - g_norm) / delta;
+        }
+        *h *= 60.0;
+        if (*h < 0) {
+            *h += 360.0;
+        }
+    }
+}
+
+static char *put_text(char *p, const char *text) {
+    while (*text) {  // NOLINT(altera-unroll-loops)
+        *p++ = *text++;
+    }
+    return p;
+}
+
+static char *put_hex(char *p, unsigned int byte, const char *digits) {
+    *p++ = digits[byte >> 4U];
+    *p++ = digits[byte & 0xFU];
+    return p;
+}
+
+static char *put_byte(char *p, unsigned int byte) {
+    if (byte >= 100) {
+        *p++ = (char)('0' + (byte / 100));
+    }
+    if (byte >= 10) {
+        *p++ = (char)('0' + (byte / 10 % 10));
+    }
+    *p++ = (char)('0' + (byte % 10));
+    return p;
+}
+
+// The channel as "%.2ff" would write byte / 255.0. The exact hundredths
+// are never a tie, and the double is far closer to them than to one, so
+// rounding in integers gives the same digits.
+static char *put_unit(char *p, unsigned int byte) {
+    unsigned int hundredths = ((byte * 200U) + 255U) / 510U;
+    *p++                    = (char)('0' + (hundredths / 100));
+    *p++                    = '.';
+    *p++                    = (char)('0' + (hundredths / 10 % 10));
+    *p++                    = (char)('0' + (hundredths % 10));
+    *p++                    = 'f';
+    return p;
+}
+
+static char *put_units(char *p, unsigned int r, unsigned int g,
+                       unsigned int b) {
+    p = put_text(put_unit(p, r), ", ");
+    p = put_text(put_unit(p, g), ", ");
+    return put_unit(p, b);
+}
+
+NORD_API size_t nord_format_color(uint32_t color, NordFormat format, char *buf,
+                                  size_t buf_size) {
+    unsigned int r = (color >> 16U) & 0xFFU;
+    unsigned int g = (color >> 8U) & 0xFFU;
+    unsigned int b = color & 0xFFU;
+    char text[NORD_TEXT_SIZE];
+    char *p = text;
+
+    // Everything but HSL is written by hand; snprintf() would take most of
+    // the time.
+    switch (format) {
+        case NORD_FORMAT_HTML_HEX:
+            *p++ = '#';
+            p    = put_hex(p, r, "0123456789ABCDEF");
+            p    = put_hex(p, g, "0123456789ABCDEF");
+            p    = put_hex(p, b, "0123456789ABCDEF");
+            break;
+        case NORD_FORMAT_RAW_HEX:
+            p = put_text(p, "0x");
+            p = put_hex(p, r, "0123456789abcdef");
+            p = put_hex(p, g, "0123456789abcdef");
+            p = put_hex(p, b, "0123456789abcdef");
+            break;
+        case NORD_FORMAT_CSS_RGB:
+        case NORD_FORMAT_CSS_RGBA:
+            p = put_text(p, format == NORD_FORMAT_CSS_RGB ? "rgb(" : "rgba(");
+            p = put_text(put_byte(p, r), ", ");
+            p = put_text(put_byte(p, g), ", ");
+            p = put_byte(p, b);
+            p = put_text(p, format == NORD_FORMAT_CSS_RGB ? ");" : ", 1);");
+            break;
+        case NORD_FORMAT_HSL: {
+            double h = 0.0;
+            double s = 0.0;
+            double l = 0.0;
+            rgb_to_hsl(color, &h, &s, &l);
+            int len = snprintf(text, sizeof(text), "hsl(%d, %d%%, %d%%);",
+                               (int)round(h), (int)round(s * 100),
+                               (int)round(l * 100));
+            p += len > 0 ? len : 0;
+            break;
+        }
+        case NORD_FORMAT_FLOAT:
+            p = put_units(p, r, g, b);
+            break;
+        case NORD_FORMAT_VEC3:
+            p = put_text(put_units(put_text(p, "vec3("), r, g, b), ")");
+            break;
+        case NORD_FORMAT_VEC4:
+            p = put_text(put_units(put_text(p, "vec4("), r, g, b),
+                         ", 1.00f)");
+            break;
+        default:
+            break;
+    }
+
+    // Truncate like snprintf().
+    size_t len = (size_t)(p - text);
+    if (buf_size > 0) {
+        size_t copy = len < buf_size ? len : buf_size - 1;
+        memcpy(buf, text, copy);
+        buf[copy] = '\0';
+    }
+    return len;
+}
+
+NORD_API void nord_format_colors(const uint32_t *colors, size_t count,
+                                 NordFormat format,
+                                 char (*texts)[NORD_TEXT_SIZE],
+                                 size_t *lengths) {
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        size_t len = nord_format_color(colors[i], format, texts[i],
+                                       NORD_TEXT_SIZE);
+        if (lengths) {
+            lengths[i] = len;
+        }
+    }
+}
+
+// Parsing works on a cursor over the trimmed text and never reads past its
+// end, so the text does not need to be NUL-terminated.
+typedef struct {
+    const char *p;
+    const char *end;
+} Cursor;
+
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static void skip_blanks(Cursor *cur) {
+    while (cur->p < cur->end && is_blank(*cur->p)) {  // NOLINT
+        cur->p++;
+    }
+}
+
+// Consume word, ignoring case, if the text continues with it.
+static bool accept(Cursor *cur, const char *word) {
+    size_t len = strlen(word);
+    if ((size_t)(cur->end - cur->p) < len) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {  // NOLINT(altera-unroll-loops)
+        if (lower(cur->p[i]) != word[i]) {
+            return false;
+        }
+    }
+    cur->p += len;
+    return true;
+}
+
+static int hex_digit(char c) {
+    c = lower(c);
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    return (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+}
+
+// Read exactly the rest of the text as hex digits.
+static bool read_hex(Cursor *cur, size_t digits, uint32_t *value) {
+    if ((size_t)(cur->end - cur->p) != digits) {
+        return false;
+    }
+    *value = 0;
+    for (size_t i = 0; i < digits; i++) {  // NOLINT(altera-unroll-loops)
+        int digit = hex_digit(cur->p[i]);
+        if (digit < 0) {
+            return false;
+        }
+        *value = (*value << 4U) | (uint32_t)digit;
+    }
+    cur->p += digits;
+    return true;
+}
+
+// Read a non-negative decimal such as "12", "0.5" or ".5". Independent of
+// the locale, unlike strtod().
+static bool read_number(Cursor *cur, double *value) {
+    double result = 0.0;
+    bool digits   = false;
+    while (cur->p < cur->end && *cur->p >= '0' &&  // NOLINT
+           *cur->p <= '9') {
+        result = (result * 10.0) + (*cur->p++ - '0');
+        digits = true;
+    }
+    if (cur->p < cur->end && *cur->p == '.') {
+        cur->p++;
+        double scale = 0.1;
+        while (cur->p < cur->end && *cur->p >= '0' &&  // NOLINT
+               *cur->p <= '9') {
+            result += (*cur->p++ - '0') * scale;
+            scale *= 0.1;
+            digits = true;
+        }
+    }
+    *value = result;
+    return digits;
+}
+
+// Read count comma-separated numbers. Each suffix says what follows its
+// number: 'f' for an optional "f" as in C float literals, '%' for a
+// required percent sign, or NUL for nothing.
+static bool read_args(Cursor *cur, double *values, size_t count,
+                      const char *suffixes) {
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        skip_blanks(cur);
+        if (i > 0) {
+            if (!accept(cur, ",")) {
+                return false;
+            }
+            skip_blanks(cur);
+        }
+        if (!read_number(cur, &values[i])) {
+            return false;
+        }
+        if (suffixes[i] == 'f') {
+            (void)accept(cur, "f");
+        } else if (suffixes[i] == '%' && !accept(cur, "%")) {
+            return false;
+        }
+    }
+    skip_blanks(cur);
+    return true;
+}
+
+static bool read_call_end(Cursor *cur) {
+    return accept(cur, ")") && cur->p == cur->end;
+}
+
+static uint8_t unit_to_byte(double value) {
+    return (uint8_t)lround(value * 255.0);
+}
+
+static uint32_t pack_rgb(const double *values) {
+    return ((uint32_t)unit_to_byte(values[0]) << 16U) |
+           ((uint32_t)unit_to_byte(values[1]) << 8U) |
+           (uint32_t)unit_to_byte(values[2]);
+}
+
+static bool in_unit_range(const double *values, size_t count) {
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        if (values[i] > 1.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parse_rgb(Cursor *cur, size_t count, uint32_t *color) {
+    double values[4] = { 0 };
+    if (!read_args(cur, values, count, "\0\0\0\0") || !read_call_end(cur)) {
+        return false;
+    }
+    for (size_t i = 0; i < 3; i++) {  // NOLINT(altera-unroll-loops)
+        if (values[i] > 255.0 || values[i] != floor(values[i])) {
+            return false;
+        }
+    }
+    if (count == 4 && values[3] > 1.0) {
+        return false;
+    }
+    *color = ((uint32_t)values[0] << 16U) | ((uint32_t)values[1] << 8U) |
+             (uint32_t)values[2];
+    return true;
+}
+
+static bool parse_hsl(Cursor *cur, uint32_t *color) {
+    double values[3] = { 0 };
+    if (!read_args(cur, values, 3, "\0%%") || !read_call_end(cur) ||
+        values[0] > 360.0 || values[1] > 100.0 || values[2] > 100.0) {
+        return false;
+    }
+    *color = nord_hsl_to_rgb((NordHsl){ .h = (float)values[0],
+                                        .s = (float)(values[1] / 100.0),
+                                        .l = (float)(values[2] / 100.0) });
+    return true;
+}
+
+static bool parse_floats(Cursor *cur, size_t count, bool call,
+                         uint32_t *color) {
+    double values[4] = { 0 };
+    if (!read_args(cur, values, count, "ffff") ||
+        !(call ? read_call_end(cur) : cur->p == cur->end) ||
+        !in_unit_range(values, count)) {
+        return false;
+    }
+    *color = pack_rgb(values);
+    return true;
+}
+
+NORD_API int nord_parse_color(const char *text, size_t len, uint32_t *color,
+                              NordFormat *format) {
+    Cursor cur = { .p = text, .end = text + len };
+    skip_blanks(&cur);
+    while (cur.end > cur.p && is_blank(cur.end[-1])) {  // NOLINT
+        cur.end--;
+    }
+    if (cur.end > cur.p && cur.end[-1] == ';') {
+        cur.end--;
+        while (cur.end > cur.p && is_blank(cur.end[-1])) {  // NOLINT
+            cur.end--;
+        }
+    }
+
+    uint32_t value  = 0;
+    NordFormat kind = NORD_FORMAT_COUNT;
+    bool ok         = false;
+    if (accept(&cur, "#")) {
+        kind = NORD_FORMAT_HTML_HEX;
+        if (cur.end - cur.p == 3 && read_hex(&cur, 3, &value)) {
+            uint32_t r = (value >> 8U) & 0xFU;
+            uint32_t g = (value >> 4U) & 0xFU;
+            uint32_t b = value & 0xFU;
+            value      = (r * 0x110000U) | (g * 0x1100U) | (b * 0x11U);
+            ok         = true;
+        } else {
+            ok = read_hex(&cur, 6, &value);
+        }
+    } else if (accept(&cur, "0x")) {
+        kind = NORD_FORMAT_RAW_HEX;
+        ok   = read_hex(&cur, 6, &value);
+    } else if (accept(&cur, "rgba(")) {
+        kind = NORD_FORMAT_CSS_RGBA;
+        ok   = parse_rgb(&cur, 4, &value);
+    } else if (accept(&cur, "rgb(")) {
+        kind = NORD_FORMAT_CSS_RGB;
+        ok   = parse_rgb(&cur, 3, &value);
+    } else if (accept(&cur, "hsl(")) {
+        kind = NORD_FORMAT_HSL;
+        ok   = parse_hsl(&cur, &value);
+    } else if (accept(&cur, "vec3(")) {
+        kind = NORD_FORMAT_VEC3;
+        ok   = parse_floats(&cur, 3, true, &value);
+    } else if (accept(&cur, "vec4(")) {
+        kind = NORD_FORMAT_VEC4;
+        ok   = parse_floats(&cur, 4, true, &value);
+    } else {
+        kind = NORD_FORMAT_FLOAT;
+        ok   = parse_floats(&cur, 3, false, &value);
+    }
+    if (!ok) {
+        return -1;
+    }
+    *color = value;
+    if (format) {
+        *format = kind;
+    }
+    return 0;
+}
+
+NORD_API NordHsl nord_rgb_to_hsl(uint32_t color) {
+    double h = 0.0;
+    double s = 0.0;
+    double l = 0.0;
+    rgb_to_hsl(color, &h, &s, &l);
+    return (NordHsl){ .h = (float)h, .s = (float)s, .l = (float)l };
+}
+
+static float hue_to_channel(float p, float q, float t) {
+    if (t < 0.0F) {
+        t += 1.0F;
+    } else if (t > 1.0F) {
+        t -= 1.0F;
+    }
+    if (t < 1.0F / 6.0F) {
+        return p + ((q - p) * 6.0F * t);
+    }
+    if (t < 0.5F) {
+        return q;
+    }
+    if (t < 2.0F / 3.0F) {
+        return p + ((q - p) * (2.0F / 3.0F - t) * 6.0F);
+    }
+    return p;
+}
+
+static uint32_t channel_to_byte(float value) {
+    if (!(value > 0.0F)) {  // Also catches NaN.
+        return 0;
+    }
+    return value >= 1.0F ? 255U : (uint32_t)lroundf(value * 255.0F);
+}
+
+NORD_API uint32_t nord_hsl_to_rgb(NordHsl hsl) {
+    float h = fmodf(hsl.h, 360.0F) / 360.0F;
+    float s = fminf(fmaxf(hsl.s, 0.0F), 1.0F);
+    float l = fminf(fmaxf(hsl.l, 0.0F), 1.0F);
+    if (h < 0.0F) {
+        h += 1.0F;
+    }
+    float r = l;
+    float g = l;
+    float b = l;
+    if (s > 0.0F) {
+        float q = l < 0.5F ? l * (1.0F + s) : l + s - (l * s);
+        float p = (2.0F * l) - q;
+        r       = hue_to_channel(p, q, h + (1.0F / 3.0F));
+        g       = hue_to_channel(p, q, h);
+        b       = hue_to_channel(p, q, h - (1.0F / 3.0F));
+    }
+    return (channel_to_byte(r) << 16U) | (channel_to_byte(g) << 8U) |
+           channel_to_byte(b);
+}
+
+static float srgb_to_linear(uint32_t byte) {
+    float c = (float)byte / 255.0F;
+    return c <= 0.04045F ? c / 12.92F : powf((c + 0.055F) / 1.055F, 2.4F);
+}
+
+static float linear_to_srgb(float c) {
+    return c <= 0.0031308F ? c * 12.92F
+                           : (1.055F * powf(c, 1.0F / 2.4F)) - 0.055F;
+}
+
+NORD_API NordOklab nord_rgb_to_oklab(uint32_t color) {
+    float r = srgb_to_linear((color >> 16U) & 0xFFU);
+    float g = srgb_to_linear((color >> 8U) & 0xFFU);
+    float b = srgb_to_linear(color & 0xFFU);
+
+    float l = cbrtf((0.4122214708F * r) + (0.5363325363F * g) +
+                    (0.0514459929F * b));
+    float m = cbrtf((0.2119034982F * r) + (0.6806995451F * g) +
+                    (0.1073969566F * b));
+    float s = cbrtf((0.0883024619F * r) + (0.2817188376F * g) +
+                    (0.6299787005F * b));
+    return (NordOklab){
+        .l = (0.2104542553F * l) + (0.7936177850F * m) - (0.0040720468F * s),
+        .a = (1.9779984951F * l) - (2.4285922050F * m) + (0.4505937099F * s),
+        .b = (0.0259040371F * l) + (0.7827717662F * m) - (0.8086757660F * s)
+    };
+}
+
+// Cone responses of an OKLab color, before they are cubed.
+static void oklab_to_lms(float lab_l, float a, float b, float *l, float *m,
+                         float *s) {
+    *l = lab_l + (0.3963377774F * a) + (0.2158037573F * b);
+    *m = lab_l - (0.1055613458F * a) - (0.0638541728F * b);
+    *s = lab_l - (0.0894841775F * a) - (1.2914855480F * b);
+}
+
+// sRGB of the cubed cone responses.
+static uint32_t lms_to_rgb(float l, float m, float s) {
+    float r = (4.0767416621F * l) - (3.3077115913F * m) + (0.2309699292F * s);
+    float g = (-1.2684380046F * l) + (2.6097574011F * m) - (0.3413193965F * s);
+    float b = (-0.0041960863F * l) - (0.7034186147F * m) + (1.7076147010F * s);
+    return (channel_to_byte(linear_to_srgb(r)) << 16U) |
+           (channel_to_byte(linear_to_srgb(g)) << 8U) |
+           channel_to_byte(linear_to_srgb(b));
+}
+
+NORD_API uint32_t nord_oklab_to_rgb(NordOklab lab) {
+    float l = 0.0F;
+    float m = 0.0F;
+    float s = 0.0F;
+    oklab_to_lms(lab.l, lab.a, lab.b, &l, &m, &s);
+    return lms_to_rgb(l * l * l, m * m * m, s * s * s);
+}
+
+NORD_API NordOklch nord_oklab_to_oklch(NordOklab lab) {
+    float h = (float)(atan2(lab.b, lab.a) * DEGREES_PER_RADIAN);
+    if (h < 0.0F) {
+        h += 360.0F;
+    }
+    return (NordOklch){ .l = lab.l, .c = hypotf(lab.a, lab.b), .h = h };
+}
+
+NORD_API NordOklab nord_oklch_to_oklab(NordOklch lch) {
+    double h = lch.h / DEGREES_PER_RADIAN;
+    return (NordOklab){ .l = lch.l,
+                        .a = lch.c * (float)cos(h),
+                        .b = lch.c * (float)sin(h) };
+}
+
+NORD_API void nord_rgb_to_oklab_n(const uint32_t *colors, size_t count,
+                                  NordOklab *out) {
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        out[i] = nord_rgb_to_oklab(colors[i]);
+    }
+}
+
+NORD_API size_t nord_nearest(const NordOklab *palette, size_t count,
+                             NordOklab color) {
+    size_t best         = 0;
+    float best_distance = INFINITY;
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        float dl       = palette[i].l - color.l;
+        float da       = palette[i].a - color.a;
+        float db       = palette[i].b - color.b;
+        float distance = (dl * dl) + (da * da) + (db * db);
+        if (distance < best_distance) {
+            best          = i;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+// Names in NordSpace and NordGradientFormat order, as shown in the dock.
+// Colors transformed per block: the OKLCH change and the cone responses
+// are worked out for the whole block in loops the compiler vectorizes, and
+// only the sRGB encoding is done one color at a time.
+#define TRANSFORM_BLOCK 64
+
+// OKLab shift of white at full warmth, toward amber; cooling shifts it the
+// other way, toward blue.
+#define WARM_A 0.012F
+#define WARM_B 0.045F
+
+NORD_API void nord_transform_n(const NordOklab *colors, size_t count,
+                               const NordTransform *transform,
+                               uint32_t *out) {
+    // The hue turn and the chroma factor together rotate and scale a, b.
+    double turn     = transform->hue / DEGREES_PER_RADIAN;
+    float cos_c     = transform->chroma * (float)cos(turn);
+    float sin_c     = transform->chroma * (float)sin(turn);
+    float warm_a    = transform->temperature * WARM_A;
+    float warm_b    = transform->temperature * WARM_B;
+    float lightness = transform->lightness;
+    float l[TRANSFORM_BLOCK];
+    float m[TRANSFORM_BLOCK];
+    float s[TRANSFORM_BLOCK];
+    for (size_t start = 0; start < count;  // NOLINT(altera-unroll-loops)
+         start += TRANSFORM_BLOCK) {
+        const NordOklab *in = colors + start;
+        size_t n            = count - start < TRANSFORM_BLOCK ? count - start
+                                                              : TRANSFORM_BLOCK;
+        for (size_t i = 0; i < n; i++) {  // NOLINT(altera-unroll-loops)
+            // White moves in proportion to lightness, so black stays black.
+            float lab_l = in[i].l * lightness;
+            float in_a  = in[i].a;
+            float in_b  = in[i].b;
+            float a     = (in_a * cos_c) - (in_b * sin_c) + (warm_a * lab_l);
+            float b     = (in_a * sin_c) + (in_b * cos_c) + (warm_b * lab_l);
+            oklab_to_lms(lab_l, a, b, &l[i], &m[i], &s[i]);
+            l[i] = l[i] * l[i] * l[i];
+            m[i] = m[i] * m[i] * m[i];
+            s[i] = s[i] * s[i] * s[i];
+        }
+        for (size_t i = 0; i < n; i++) {  // NOLINT(altera-unroll-loops)
+            out[start + i] = lms_to_rgb(l[i], m[i], s[i]);
+        }
+    }
+}
+
+static const char *space_names[NORD_SPACE_COUNT] = { "OKLab", "OKLCH" };
+static const char *gradient_names[NORD_GRADIENT_COUNT] = { "CSS", "Stops",
+                                                           "GLSL" };
+
+// OKLCH chroma below which a color is gray and its hue meaningless.
+#define GRAY_CHROMA 0.0005F
+
+NORD_API const char *nord_space_name(NordSpace space) {
+    return space < NORD_SPACE_COUNT ? space_names[space] : "";
+}
+
+NORD_API const char *nord_gradient_format_name(NordGradientFormat kind) {
+    return kind < NORD_GRADIENT_COUNT ? gradient_names[kind] : "";
+}
+
+NORD_API void nord_gradient(uint32_t from, uint32_t to, NordSpace space,
+                            uint32_t *out, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    NordOklab a   = nord_rgb_to_oklab(from);
+    NordOklab b   = nord_rgb_to_oklab(to);
+    NordOklch lch = nord_oklab_to_oklch(a);
+    NordOklch end = nord_oklab_to_oklch(b);
+    if (lch.c < GRAY_CHROMA) {
+        lch.h = end.h;
+    }
+    if (end.c < GRAY_CHROMA) {
+        end.h = lch.h;
+    }
+    float turn = end.h - lch.h;
+    if (turn > 180.0F) {
+        turn -= 360.0F;
+    } else if (turn < -180.0F) {
+        turn += 360.0F;
+    }
+
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        float t = count > 1 ? (float)i / (float)(count - 1) : 0.0F;
+        NordOklab mix;
+        if (space == NORD_SPACE_OKLCH) {
+            mix = nord_oklch_to_oklab(
+                (NordOklch){ .l = lch.l + ((end.l - lch.l) * t),
+                             .c = lch.c + ((end.c - lch.c) * t),
+                             .h = lch.h + (turn * t) });
+        } else {
+            mix = (NordOklab){ .l = a.l + ((b.l - a.l) * t),
+                               .a = a.a + ((b.a - a.a) * t),
+                               .b = a.b + ((b.b - a.b) * t) };
+        }
+        out[i] = nord_oklab_to_rgb(mix);
+    }
+    // The ends are exact rather than round trips through OKLab.
+    out[0] = from;
+    if (count > 1) {
+        out[count - 1] = to;
+    }
+}
+
+// A text written piece by piece and truncated like snprintf().
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;  // Length of the full text.
+} Output;
+
+static void emit(Output *out, const char *text, size_t len) {
+    if (out->len < out->size) {
+        size_t room = out->size - out->len;
+        memcpy(out->buf + out->len, text, len < room ? len : room);
+    }
+    out->len += len;
+}
+
+static void emit_text(Output *out, const char *text) {
+    emit(out, text, strlen(text));
+}
+
+static void emit_color(Output *out, uint32_t color, NordFormat format) {
+    char text[NORD_TEXT_SIZE];
+    emit(out, text, nord_format_color(color, format, text, sizeof(text)));
+}
+
+NORD_API size_t nord_format_gradient(const uint32_t *stops, size_t count,
+                                     NordGradientFormat kind,
+                                     NordFormat format, char *buf,
+                                     size_t buf_size) {
+    Output out = { .buf = buf, .size = buf_size, .len = 0 };
+    char header[NORD_TEXT_SIZE * 2];
+    switch (kind) {
+        case NORD_GRADIENT_CSS:
+            emit_text(&out, "linear-gradient(to right");
+            for (size_t i = 0; i < count; i++) {  // NOLINT
+                emit_text(&out, ", ");
+                emit_color(&out, stops[i], NORD_FORMAT_HTML_HEX);
+            }
+            emit_text(&out, ");");
+            break;
+        case NORD_GRADIENT_STOPS:
+            for (size_t i = 0; i < count; i++) {  // NOLINT
+                if (i > 0) {
+                    emit_text(&out, "\n");
+                }
+                emit_color(&out, stops[i], format);
+            }
+            break;
+        case NORD_GRADIENT_GLSL:
+            (void)snprintf(header, sizeof(header),
+                           "const vec3 gradient[%zu] = vec3[%zu](\n", count,
+                           count);
+            emit_text(&out, header);
+            for (size_t i = 0; i < count; i++) {  // NOLINT
+                emit_text(&out, "    ");
+                emit_color(&out, stops[i], NORD_FORMAT_VEC3);
+                emit_text(&out, i + 1 < count ? ",\n" : "\n");
+            }
+            emit_text(&out, ");");
+            break;
+        default:
+            break;
+    }
+    if (buf_size > 0) {
+        buf[out.len < buf_size ? out.len : buf_size - 1] = '\0';
+    }
+    return out.len;
+}
@@ -0,0 +1,186 @@
+/*
+ * Filename: arctic_nord.h
+ *
+ * Description: libarcticnord, the dock's color engine as a library with no
+ * display dependency: the Nord palette, writing colors in every format the
+ * dock can copy, reading them back, conversion between sRGB, HSL, OKLab and
+ * OKLCH, finding the nearest palette color and interpolating gradients. The
+ * dock links it, and so can asset pipelines and other tools.
+ *
+ * Colors are 0xRRGGBB sRGB values. Functions that are given an unknown
+ * format write an empty string. Nothing here allocates or keeps state, so
+ * every function may be called from any thread.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef ARCTIC_NORD_H
+#define ARCTIC_NORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bumped when a declaration below changes incompatibly; the shared library's
+// soname follows it.
+#define NORD_API_VERSION 1
+
+#if defined(NORD_BUILD_SHARED)
+#define NORD_API __attribute__((visibility("default")))
+#else
+#define NORD_API
+#endif
+
+// The Nord palette: Polar Night, Snow Storm, Frost and Aurora.
+#define NORD0 0x2E3440U
+#define NORD1 0x3B4252U
+#define NORD2 0x434C5EU
+#define NORD3 0x4C566AU
+#define NORD4 0xD8DEE9U
+#define NORD5 0xE5E9F0U
+#define NORD6 0xECEFF4U
+#define NORD7 0x8FBCBBU
+#define NORD8 0x88C0D0U
+#define NORD9 0x81A1C1U
+#define NORD10 0x5E81ACU
+#define NORD11 0xBF616AU
+#define NORD12 0xD08770U
+#define NORD13 0xEBCB8BU
+#define NORD14 0xA3BE8CU
+#define NORD15 0xB48EADU
+#define NORD_PALETTE_LENGTH 16
+
+// Supported text formats in order.
+typedef enum {
+    NORD_FORMAT_HTML_HEX,  // "#RRGGBB"
+    NORD_FORMAT_RAW_HEX,   // "0xaabbcc"
+    NORD_FORMAT_CSS_RGB,   // "rgb(R, G, B);"
+    NORD_FORMAT_CSS_RGBA,  // "rgba(R, G, B, 1);"
+    NORD_FORMAT_HSL,       // "hsl(H, S%, L%);"
+    NORD_FORMAT_FLOAT,     // "0.54f, 0.22f, 0.44f"
+    NORD_FORMAT_VEC3,      // "vec3(0.54f, 0.22f, 0.44f)"
+    NORD_FORMAT_VEC4,      // "vec4(0.54f, 0.22f, 0.44f, 1.00f)"
+    NORD_FORMAT_COUNT
+} NordFormat;
+
+// Room for any color in any format, with its terminating NUL.
+#define NORD_TEXT_SIZE 40
+
+typedef struct {
+    float l;  // Lightness, 0 to 1.
+    float a;  // Green to red.
+    float b;  // Blue to yellow.
+} NordOklab;
+
+typedef struct {
+    float l;  // Lightness, 0 to 1.
+    float c;  // Chroma, 0 up to about 0.37 inside sRGB.
+    float h;  // Hue in degrees, 0 to 360.
+} NordOklch;
+
+// Spaces gradients are interpolated in.
+typedef enum {
+    NORD_SPACE_OKLAB,  // Straight line through OKLab.
+    NORD_SPACE_OKLCH,  // Shorter way around the hue circle.
+    NORD_SPACE_COUNT
+} NordSpace;
+
+// Ways of writing a gradient's stops.
+typedef enum {
+    NORD_GRADIENT_CSS,    // "linear-gradient(to right, #RRGGBB, ...);"
+    NORD_GRADIENT_STOPS,  // One stop per line, in a NordFormat.
+    NORD_GRADIENT_GLSL,   // "const vec3 gradient[N] = vec3[N](...);"
+    NORD_GRADIENT_COUNT
+} NordGradientFormat;
+
+typedef struct {
+    float h;  // Hue in degrees, 0 to 360.
+    float s;  // Saturation, 0 to 1.
+    float l;  // Lightness, 0 to 1.
+} NordHsl;
+
+// A change made to every color of a palette, in OKLCH.
+typedef struct {
+    float hue;          // Degrees added to the hue.
+    float lightness;    // Factor on lightness; 1 keeps it.
+    float chroma;       // Factor on chroma; 0 turns colors gray.
+    float temperature;  // White moved toward blue, -1, or amber, 1.
+} NordTransform;
+
+// The transform that changes nothing.
+#define NORD_TRANSFORM_IDENTITY                                       \
+    ((NordTransform){ .hue = 0.0F, .lightness = 1.0F, .chroma = 1.0F, \
+                      .temperature = 0.0F })
+
+// The palette in order, nord0 first.
+NORD_API extern const uint32_t nord_palette[NORD_PALETTE_LENGTH];
+
+// The format's name as shown in the dock's menu, or "" if it is unknown.
+NORD_API const char *nord_format_name(NordFormat format);
+
+// Write the color in the format, truncated to the buffer like snprintf().
+// Returns the length of the full text.
+NORD_API size_t nord_format_color(uint32_t color, NordFormat format, char *buf,
+                                  size_t buf_size);
+
+// Write count colors in the format, one NUL-terminated text per row, and
+// their lengths if lengths is not nullptr.
+NORD_API void nord_format_colors(const uint32_t *colors, size_t count,
+                                 NordFormat format,
+                                 char (*texts)[NORD_TEXT_SIZE],
+                                 size_t *lengths);
+
+// Read a color written in any of the formats, or as "#RGB". Surrounding
+// blanks, a trailing semicolon and letter case are ignored. Stores the
+// color, and the format if format is not nullptr. Returns 0 on success or
+// -1 if the text is not a color.
+NORD_API int nord_parse_color(const char *text, size_t len, uint32_t *color,
+                              NordFormat *format);
+
+NORD_API NordHsl nord_rgb_to_hsl(uint32_t color);
+NORD_API uint32_t nord_hsl_to_rgb(NordHsl hsl);
+
+NORD_API NordOklab nord_rgb_to_oklab(uint32_t color);
+
+// Colors outside sRGB are clipped per channel.
+NORD_API uint32_t nord_oklab_to_rgb(NordOklab lab);
+
+NORD_API NordOklch nord_oklab_to_oklch(NordOklab lab);
+NORD_API NordOklab nord_oklch_to_oklab(NordOklch lch);
+
+// Convert count colors to OKLab, such as a palette for nord_nearest().
+NORD_API void nord_rgb_to_oklab_n(const uint32_t *colors, size_t count,
+                                  NordOklab *out);
+
+// Index of the palette entry closest to the color in OKLab, the first one
+// on ties, or 0 for an empty palette.
+NORD_API size_t nord_nearest(const NordOklab *palette, size_t count,
+                             NordOklab color);
+
+// The space's or gradient format's name as shown in the dock, or "" if it
+// is unknown.
+NORD_API const char *nord_space_name(NordSpace space);
+NORD_API const char *nord_gradient_format_name(NordGradientFormat kind);
+
+// Write count colors evenly spaced from one color to another, both
+// included, interpolated in the space. In OKLCH a gray end takes the hue of
+// the other end.
+NORD_API void nord_gradient(uint32_t from, uint32_t to, NordSpace space,
+                            uint32_t *out, size_t count);
+
+// Write the stops as a gradient, truncated to the buffer like snprintf().
+// The format is used for NORD_GRADIENT_STOPS only. Returns the length of the
+// full text.
+NORD_API size_t nord_format_gradient(const uint32_t *stops, size_t count,
+                                     NordGradientFormat kind,
+                                     NordFormat format, char *buf,
+                                     size_t buf_size);
+
+// Transform count colors given in OKLab, such as from nord_rgb_to_oklab_n(),
+// and write them as 0xRRGGBB, clipped per channel. The identity transform
+// gives the same colors as nord_oklab_to_rgb().
+NORD_API void nord_transform_n(const NordOklab *colors, size_t count,
+                               const NordTransform *transform, uint32_t *out);
+
+#endif  // ARCTIC_NORD_H
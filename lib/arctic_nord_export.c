@@ -0,0 +1,369 @@
+/*
+ * Filename: arctic_nord_export.c
+ *
+ * Description: Implements the whole-palette exporters of libarcticnord and
+ * the writer they stream into. Every piece of output is either a string
+ * literal or a slice of the caller's tables, so an export costs one copy or
+ * one writev() entry per piece.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "arctic_nord_export.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define TERMINAL_COLORS 16
+
+// Exporter names, in NordExport order, as shown in the menu.
+static const char *export_names[NORD_EXPORT_COUNT] = {
+    "CSS",  "SCSS",      "JSON",  "Xresources", "GLSL",
+    "HLSL", "Alacritty", "kitty", "foot"
+};
+
+// Palette entries behind the terminal colors, as in the Nord ports: the
+// normal colors 0-7, then the bright ones 8-15.
+static const uint8_t terminal_colors[TERMINAL_COLORS] = {
+    1, 11, 14, 13, 9, 15, 8, 5, 3, 11, 14, 13, 9, 15, 7, 6
+};
+#define TERMINAL_BACKGROUND 0
+#define TERMINAL_FOREGROUND 4
+
+// Color names of Alacritty's [colors.normal] and [colors.bright] tables.
+static const char *alacritty_names[TERMINAL_COLORS / 2] = {
+    "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white"
+};
+
+static const char *terminal_numbers[TERMINAL_COLORS] = {
+    "0", "1", "2",  "3",  "4",  "5",  "6",  "7",
+    "8", "9", "10", "11", "12", "13", "14", "15"
+};
+
+NORD_API const char *nord_export_name(NordExport kind) {
+    return kind < NORD_EXPORT_COUNT ? export_names[kind] : "";
+}
+
+static char fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static bool is_separator(char c) {
+    return c == ' ' || c == '-' || c == '_';
+}
+
+// Compare two names the way the lookups do.
+static bool same_name(const char *a, const char *b) {
+    for (;;) {  // NOLINT(altera-unroll-loops)
+        while (is_separator(*a)) {  // NOLINT(altera-unroll-loops)
+            a++;
+        }
+        while (is_separator(*b)) {  // NOLINT(altera-unroll-loops)
+            b++;
+        }
+        if (fold(*a) != fold(*b)) {
+            return false;
+        }
+        if (*a == '\0') {
+            return true;
+        }
+        a++;
+        b++;
+    }
+}
+
+NORD_API int nord_export_lookup(const char *name) {
+    for (int i = 0; i < NORD_EXPORT_COUNT; i++) {  // NOLINT
+        if (same_name(name, export_names[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+NORD_API int nord_format_lookup(const char *name) {
+    for (int i = 0; i < NORD_FORMAT_COUNT; i++) {  // NOLINT
+        if (same_name(name, nord_format_name((NordFormat)i))) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+NORD_API NordFormat nord_export_format(NordExport kind, NordFormat preferred) {
+    switch (kind) {
+        case NORD_EXPORT_CSS:
+        case NORD_EXPORT_SCSS:
+            // The notations CSS understands.
+            if (preferred == NORD_FORMAT_CSS_RGB ||
+                preferred == NORD_FORMAT_CSS_RGBA ||
+                preferred == NORD_FORMAT_HSL) {
+                return preferred;
+            }
+            return NORD_FORMAT_HTML_HEX;
+        case NORD_EXPORT_JSON:
+            return preferred < NORD_FORMAT_COUNT ? preferred
+                                                 : NORD_FORMAT_HTML_HEX;
+        case NORD_EXPORT_GLSL:
+            return NORD_FORMAT_VEC3;
+        case NORD_EXPORT_HLSL:
+            return NORD_FORMAT_FLOAT;
+        default:
+            return NORD_FORMAT_HTML_HEX;
+    }
+}
+
+NORD_API void nord_writer_fd(NordWriter *writer, int fd) {
+    writer->fd    = fd;
+    writer->buf   = nullptr;
+    writer->size  = 0;
+    writer->total = 0;
+    writer->error = 0;
+    writer->count = 0;
+}
+
+NORD_API void nord_writer_buffer(NordWriter *writer, char *buf, size_t size) {
+    nord_writer_fd(writer, -1);
+    writer->buf  = buf;
+    writer->size = size;
+}
+
+// Write the gathered pieces, resuming after short writes.
+static void flush(NordWriter *writer) {
+    struct iovec *iov = writer->iov;
+    size_t count      = writer->count;
+    writer->count     = 0;
+    while (count > 0 && writer->error == 0) {  // NOLINT
+        ssize_t n = writev(writer->fd, iov, (int)count);
+        if (n < 0) {
+            if (errno != EINTR) {
+                writer->error = errno;
+            }
+            continue;
+        }
+        size_t done = (size_t)n;
+        while (count > 0 && done >= iov->iov_len) {  // NOLINT
+            done -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+}
+
+// Queue or copy one piece. Pieces are referenced, not copied, until the
+// writer is flushed, so they must outlive the export.
+static void put(NordWriter *writer, const char *text, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    if (writer->fd < 0) {
+        if (writer->total < writer->size) {
+            size_t room = writer->size - writer->total;
+            memcpy(writer->buf + writer->total, text, len < room ? len : room);
+        }
+    } else {
+        if (writer->count == NORD_WRITER_IOVECS) {
+            flush(writer);
+        }
+        writer->iov[writer->count++] =
+            (struct iovec){ .iov_base = (void *)text, .iov_len = len };
+    }
+    writer->total += len;
+}
+
+static void put_text(NordWriter *writer, const char *text) {
+    put(writer, text, strlen(text));
+}
+
+static const char *label(const NordExportPalette *palette, size_t i) {
+    return palette->labels + (i * palette->label_stride);
+}
+
+static void put_label(NordWriter *writer, const NordExportPalette *palette,
+                      size_t i) {
+    put_text(writer, label(palette, i));
+}
+
+// The color's text without the semicolon the CSS formats end in, which the
+// exporters supply themselves. skip drops leading characters, such as the
+// '#' foot does not take.
+static void put_color(NordWriter *writer, const NordExportPalette *palette,
+                      size_t i, size_t skip) {
+    const char *text = palette->texts + (i * palette->text_stride);
+    size_t len       = strlen(text);
+    if (len > 0 && text[len - 1] == ';') {
+        len--;
+    }
+    if (skip < len) {
+        put(writer, text + skip, len - skip);
+    }
+}
+
+// One "prefix label infix color suffix" line per color.
+static void put_lines(NordWriter *writer, const NordExportPalette *palette,
+                      const char *prefix, const char *infix,
+                      const char *suffix) {
+    for (size_t i = 0; i < palette->count; i++) {  // NOLINT
+        put_text(writer, prefix);
+        put_label(writer, palette, i);
+        put_text(writer, infix);
+        put_color(writer, palette, i, 0);
+        put_text(writer, suffix);
+    }
+}
+
+static void export_json(NordWriter *writer, const NordExportPalette *palette) {
+    put_text(writer, "{\n");
+    for (size_t i = 0; i < palette->count; i++) {  // NOLINT
+        put_text(writer, "  \"");
+        put_label(writer, palette, i);
+        put_text(writer, "\": \"");
+        put_color(writer, palette, i, 0);
+        put_text(writer, i + 1 < palette->count ? "\",\n" : "\"\n");
+    }
+    put_text(writer, "}\n");
+}
+
+static void export_xresources(NordWriter *writer,
+                              const NordExportPalette *palette) {
+    put_lines(writer, palette, "#define ", " ", "\n");
+    if (palette->count < TERMINAL_COLORS) {
+        return;
+    }
+    put_text(writer, "\n*.foreground: ");
+    put_label(writer, palette, TERMINAL_FOREGROUND);
+    put_text(writer, "\n*.background: ");
+    put_label(writer, palette, TERMINAL_BACKGROUND);
+    put_text(writer, "\n*.cursorColor: ");
+    put_label(writer, palette, TERMINAL_FOREGROUND);
+    put_text(writer, "\n");
+    for (size_t i = 0; i < TERMINAL_COLORS; i++) {  // NOLINT
+        put_text(writer, "*.color");
+        put_text(writer, terminal_numbers[i]);
+        put_text(writer, ": ");
+        put_label(writer, palette, terminal_colors[i]);
+        put_text(writer, "\n");
+    }
+}
+
+static void export_alacritty(NordWriter *writer,
+                             const NordExportPalette *palette) {
+    put_text(writer, "[colors.primary]\nbackground = \"");
+    put_color(writer, palette, TERMINAL_BACKGROUND, 0);
+    put_text(writer, "\"\nforeground = \"");
+    put_color(writer, palette, TERMINAL_FOREGROUND, 0);
+    put_text(writer, "\"\n");
+    for (size_t i = 0; i < TERMINAL_COLORS; i++) {  // NOLINT
+        if (i % (TERMINAL_COLORS / 2) == 0) {
+            put_text(writer, i == 0 ? "\n[colors.normal]\n"
+                                    : "\n[colors.bright]\n");
+        }
+        put_text(writer, alacritty_names[i % (TERMINAL_COLORS / 2)]);
+        put_text(writer, " = \"");
+        put_color(writer, palette, terminal_colors[i], 0);
+        put_text(writer, "\"\n");
+    }
+}
+
+static void export_kitty(NordWriter *writer, const NordExportPalette *palette) {
+    put_text(writer, "foreground ");
+    put_color(writer, palette, TERMINAL_FOREGROUND, 0);
+    put_text(writer, "\nbackground ");
+    put_color(writer, palette, TERMINAL_BACKGROUND, 0);
+    put_text(writer, "\ncursor ");
+    put_color(writer, palette, TERMINAL_FOREGROUND, 0);
+    put_text(writer, "\n");
+    for (size_t i = 0; i < TERMINAL_COLORS; i++) {  // NOLINT
+        put_text(writer, "color");
+        put_text(writer, terminal_numbers[i]);
+        put_text(writer, " ");
+        put_color(writer, palette, terminal_colors[i], 0);
+        put_text(writer, "\n");
+    }
+}
+
+// foot takes bare RRGGBB, so the '#' of the HTML HEX texts is skipped.
+static void export_foot(NordWriter *writer, const NordExportPalette *palette) {
+    put_text(writer, "[colors]\nforeground=");
+    put_color(writer, palette, TERMINAL_FOREGROUND, 1);
+    put_text(writer, "\nbackground=");
+    put_color(writer, palette, TERMINAL_BACKGROUND, 1);
+    put_text(writer, "\n");
+    for (size_t i = 0; i < TERMINAL_COLORS; i++) {  // NOLINT
+        put_text(writer, i < TERMINAL_COLORS / 2 ? "regular" : "bright");
+        put_text(writer, terminal_numbers[i % (TERMINAL_COLORS / 2)]);
+        put_text(writer, "=");
+        put_color(writer, palette, terminal_colors[i], 1);
+        put_text(writer, "\n");
+    }
+}
+
+NORD_API int nord_export(NordWriter *writer, NordExport kind,
+                         const NordExportPalette *palette) {
+    bool terminal = kind == NORD_EXPORT_ALACRITTY ||
+                    kind == NORD_EXPORT_KITTY || kind == NORD_EXPORT_FOOT;
+    if (kind >= NORD_EXPORT_COUNT ||
+        (terminal && palette->count < TERMINAL_COLORS)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    switch (kind) {
+        case NORD_EXPORT_CSS:
+            put_text(writer, ":root {\n");
+            put_lines(writer, palette, "  --", ": ", ";\n");
+            put_text(writer, "}\n");
+            break;
+        case NORD_EXPORT_SCSS:
+            // Sass allows the trailing comma after the last pair.
+            put_text(writer, "$palette: (\n");
+            put_lines(writer, palette, "  \"", "\": ", ",\n");
+            put_text(writer, ");\n");
+            break;
+        case NORD_EXPORT_JSON:
+            export_json(writer, palette);
+            break;
+        case NORD_EXPORT_XRESOURCES:
+            export_xresources(writer, palette);
+            break;
+        case NORD_EXPORT_GLSL:
+            put_lines(writer, palette, "const vec3 ", " = ", ";\n");
+            break;
+        case NORD_EXPORT_HLSL:
+            put_lines(writer, palette, "static const float3 ", " = float3(",
+                      ");\n");
+            break;
+        case NORD_EXPORT_ALACRITTY:
+            export_alacritty(writer, palette);
+            break;
+        case NORD_EXPORT_KITTY:
+            export_kitty(writer, palette);
+            break;
+        case NORD_EXPORT_FOOT:
+            export_foot(writer, palette);
+            break;
+        default:
+            break;
+    }
+
+    if (writer->fd >= 0) {
+        flush(writer);
+    }
+    if (writer->error != 0) {
+        errno = writer->error;
+        return -1;
+    }
+    return 0;
+}
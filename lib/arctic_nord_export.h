@@ -0,0 +1,91 @@
+/*
+ * Filename: arctic_nord_export.h
+ *
+ * Description: Whole-palette exporters of libarcticnord: CSS custom
+ * properties, an SCSS map, JSON, Xresources, GLSL and HLSL constants, and
+ * Alacritty, kitty and foot themes. They read labels and already formatted
+ * colors straight from the caller's tables and hand the pieces to a writer,
+ * which copies them into a buffer or gathers them into writev() calls, so no
+ * line is ever assembled in a temporary.
+ *
+ * The terminal themes need at least 16 colors and assign them to terminal
+ * roles the way the Nord terminal ports do: nord0 background, nord4
+ * foreground, nord1 to nord15 for the ANSI colors.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef ARCTIC_NORD_EXPORT_H
+#define ARCTIC_NORD_EXPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "arctic_nord.h"
+
+typedef enum {
+    NORD_EXPORT_CSS,         // :root { --nord0: #2E3440; }
+    NORD_EXPORT_SCSS,        // $palette: ("nord0": #2E3440);
+    NORD_EXPORT_JSON,        // { "nord0": "#2E3440" }
+    NORD_EXPORT_XRESOURCES,  // #define nord0 #2E3440, plus terminal colors
+    NORD_EXPORT_GLSL,        // const vec3 nord0 = vec3(0.18f, ...);
+    NORD_EXPORT_HLSL,        // static const float3 nord0 = float3(...);
+    NORD_EXPORT_ALACRITTY,   // TOML [colors.*] tables
+    NORD_EXPORT_KITTY,       // color0 #3B4252
+    NORD_EXPORT_FOOT,        // [colors] regular0=3B4252
+    NORD_EXPORT_COUNT
+} NordExport;
+
+// The palette to export. Labels and texts are NUL-terminated rows of fixed
+// stride, such as the rows filled by nord_format_colors(). The texts must
+// be in the format nord_export_format() names for the exporter.
+typedef struct {
+    size_t count;
+    const char *labels;
+    size_t label_stride;
+    const char *texts;
+    size_t text_stride;
+} NordExportPalette;
+
+// IOV_MAX on Linux: the most pieces one writev() call takes.
+#define NORD_WRITER_IOVECS 1024
+
+// Destination of an export: a file descriptor or a caller's buffer.
+typedef struct {
+    int fd;        // Output file, or -1 to copy into buf.
+    char *buf;
+    size_t size;
+    size_t total;  // Bytes exported, including any that did not fit buf.
+    int error;     // errno of the first failed write, or 0.
+    size_t count;  // Pieces waiting for writev().
+    struct iovec iov[NORD_WRITER_IOVECS];
+} NordWriter;
+
+// The exporter's name, as shown in the dock's menu, or "" if it is unknown.
+NORD_API const char *nord_export_name(NordExport kind);
+
+// The exporter or format whose name matches, ignoring case, spaces, dashes
+// and underscores, so "html-hex" finds "HTML HEX". Returns -1 if none does.
+NORD_API int nord_export_lookup(const char *name);
+NORD_API int nord_format_lookup(const char *name);
+
+// The format the exporter's texts must be in. Exporters into formats that
+// take any color notation use the preferred one.
+NORD_API NordFormat nord_export_format(NordExport kind, NordFormat preferred);
+
+NORD_API void nord_writer_fd(NordWriter *writer, int fd);
+
+// Nothing beyond size bytes is written, and buf is not NUL-terminated;
+// writer->total tells how much room the whole export needs.
+NORD_API void nord_writer_buffer(NordWriter *writer, char *buf, size_t size);
+
+// Write the palette and flush the writer. Returns 0 on success or -1 with
+// errno set: EINVAL for an unknown exporter or a terminal theme of fewer than
+// 16 colors, or the error of the failed write.
+NORD_API int nord_export(NordWriter *writer, NordExport kind,
+                         const NordExportPalette *palette);
+
+#endif  // ARCTIC_NORD_EXPORT_H
@@ -0,0 +1,153 @@
+/*
+ * Filename: arctic_nord_index.c
+ *
+ * Description: Implements the k-d tree of libarcticnord. Each range is
+ * split at the median of the axis along which its colors spread the most,
+ * found by quickselect, so building takes O(n log n) time on average and no
+ * memory beyond the nodes.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "arctic_nord_index.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static float coordinate(const NordOklab *lab, uint32_t axis) {
+    switch (axis) {
+        case 0:
+            return lab->l;
+        case 1:
+            return lab->a;
+        default:
+            return lab->b;
+    }
+}
+
+static void swap_nodes(NordIndexNode *a, NordIndexNode *b) {
+    NordIndexNode tmp = *a;
+    *a                = *b;
+    *b                = tmp;
+}
+
+// The axis of the largest spread in nodes[lo, hi).
+static uint32_t widest_axis(const NordIndexNode *nodes, size_t lo,
+                            size_t hi) {
+    float min[3] = { INFINITY, INFINITY, INFINITY };
+    float max[3] = { -INFINITY, -INFINITY, -INFINITY };
+    for (size_t i = lo; i < hi; i++) {  // NOLINT(altera-unroll-loops)
+        for (uint32_t axis = 0; axis < 3; axis++) {  // NOLINT
+            float value = coordinate(&nodes[i].lab, axis);
+            min[axis]   = fminf(min[axis], value);
+            max[axis]   = fmaxf(max[axis], value);
+        }
+    }
+    uint32_t widest = 0;
+    for (uint32_t axis = 1; axis < 3; axis++) {  // NOLINT
+        if (max[axis] - min[axis] > max[widest] - min[widest]) {
+            widest = axis;
+        }
+    }
+    return widest;
+}
+
+// Reorder nodes[lo, hi) so that nodes[k] holds the value that sorting on
+// the axis would put there, with no greater value before it and no smaller
+// one after it.
+static void select_nth(NordIndexNode *nodes, size_t lo, size_t hi, size_t k,
+                       uint32_t axis) {
+    while (hi - lo > 1) {  // NOLINT(altera-unroll-loops)
+        swap_nodes(&nodes[lo + ((hi - lo) / 2)], &nodes[hi - 1]);
+        float pivot  = coordinate(&nodes[hi - 1].lab, axis);
+        size_t store = lo;
+        for (size_t i = lo; i + 1 < hi; i++) {  // NOLINT
+            if (coordinate(&nodes[i].lab, axis) < pivot) {
+                swap_nodes(&nodes[i], &nodes[store++]);
+            }
+        }
+        swap_nodes(&nodes[store], &nodes[hi - 1]);
+        if (k == store) {
+            return;
+        }
+        if (k < store) {
+            hi = store;
+        } else {
+            lo = store + 1;
+        }
+    }
+}
+
+static void build(NordIndexNode *nodes, size_t lo, size_t hi) {
+    if (hi - lo < 2) {
+        if (hi > lo) {
+            nodes[lo].axis = 0;
+        }
+        return;
+    }
+    size_t mid    = lo + ((hi - lo) / 2);
+    uint32_t axis = widest_axis(nodes, lo, hi);
+    select_nth(nodes, lo, hi, mid, axis);
+    nodes[mid].axis = axis;
+    build(nodes, lo, mid);
+    build(nodes, mid + 1, hi);
+}
+
+NORD_API void nord_index_build(NordIndex *index, const uint32_t *colors,
+                               size_t count, NordIndexNode *nodes) {
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        nodes[i] = (NordIndexNode){ .lab   = nord_rgb_to_oklab(colors[i]),
+                                    .entry = (uint32_t)i };
+    }
+    build(nodes, 0, count);
+    index->nodes = nodes;
+    index->count = count;
+}
+
+typedef struct {
+    NordOklab color;
+    uint32_t entry;
+    float distance;
+} Search;
+
+static void search(const NordIndexNode *nodes, size_t lo, size_t hi,
+                   Search *best) {
+    while (lo < hi) {  // NOLINT(altera-unroll-loops)
+        size_t mid                = lo + ((hi - lo) / 2);
+        const NordIndexNode *node = &nodes[mid];
+        float dl                  = node->lab.l - best->color.l;
+        float da                  = node->lab.a - best->color.a;
+        float db                  = node->lab.b - best->color.b;
+        float distance            = (dl * dl) + (da * da) + (db * db);
+        if (distance < best->distance ||
+            (distance == best->distance && node->entry < best->entry)) {
+            best->entry    = node->entry;
+            best->distance = distance;
+        }
+
+        // Search the near half first. The far half can only hold a closer
+        // color, or an equally close earlier one, if the splitting plane is
+        // no farther than the best so far.
+        float split = coordinate(&best->color, node->axis) -
+                      coordinate(&node->lab, node->axis);
+        if (split < 0.0F) {
+            search(nodes, lo, mid, best);
+            lo = mid + 1;
+        } else {
+            search(nodes, mid + 1, hi, best);
+            hi = mid;
+        }
+        if (split * split > best->distance) {
+            return;
+        }
+    }
+}
+
+NORD_API size_t nord_index_nearest(const NordIndex *index, NordOklab color) {
+    Search best = { .color = color, .entry = 0, .distance = INFINITY };
+    search(index->nodes, 0, index->count, &best);
+    return best.entry;
+}
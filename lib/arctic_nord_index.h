@@ -0,0 +1,48 @@
+/*
+ * Filename: arctic_nord_index.h
+ *
+ * Description: Nearest-color index of libarcticnord: a k-d tree over colors
+ * in OKLab for tables too large for nord_nearest()'s linear scan, such as
+ * the CSS, X11 and xkcd color names. A query visits about log2(count) nodes
+ * instead of every color.
+ *
+ * The tree is stored implicitly in an array the caller provides, one node
+ * per color: each range of nodes has its splitting node in the middle and
+ * its two halves on either side, so nothing is allocated and a built index
+ * can be shared by any number of threads.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef ARCTIC_NORD_INDEX_H
+#define ARCTIC_NORD_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arctic_nord.h"
+
+typedef struct {
+    NordOklab lab;
+    uint32_t entry;  // Index of the color in the table the tree was built of.
+    uint32_t axis;   // Axis the node splits its range on: 0 L, 1 a, 2 b.
+} NordIndexNode;
+
+typedef struct {
+    NordIndexNode *nodes;
+    size_t count;
+} NordIndex;
+
+// Build an index of count colors into nodes, which must hold count nodes
+// and stay valid as long as the index is used.
+NORD_API void nord_index_build(NordIndex *index, const uint32_t *colors,
+                               size_t count, NordIndexNode *nodes);
+
+// Index in the table of the color closest to the given one in OKLab, the
+// first one on ties, or 0 for an empty index. Finds the same color as
+// nord_nearest() over the whole table.
+NORD_API size_t nord_index_nearest(const NordIndex *index, NordOklab color);
+
+#endif  // ARCTIC_NORD_INDEX_H
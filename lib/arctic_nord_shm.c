@@ -0,0 +1,174 @@
+/*
+ * Filename: arctic_nord_shm.c
+ *
+ * Description: Implements both sides of the published palette segment: the
+ * dock's writer and the lock-free reader used by other programs.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include "arctic_nord_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void nord_shm_default_name(char *name, size_t size) {
+    (void)snprintf(name, size, "/arctic-nord-dock-%u", (unsigned)getuid());
+}
+
+// Only trust segments created by the same user, so another account cannot
+// plant a fake palette under a predictable name.
+static bool owned_by_user(int fd, size_t min_size) {
+    struct stat st;
+    return fstat(fd, &st) == 0 && st.st_uid == getuid() &&
+           (size_t)st.st_size >= min_size;
+}
+
+int nord_shm_create(NordShm *shm, const char *name) {
+    char default_name[NORD_SHM_NAME_SIZE];
+    if (!name) {
+        nord_shm_default_name(default_name, sizeof(default_name));
+        name = default_name;
+    }
+    shm->segment = nullptr;
+    shm->fd = shm_open(name, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (shm->fd < 0) {
+        return -1;
+    }
+    // The lock makes this the only writer; it goes away with the process.
+    bool usable = flock(shm->fd, LOCK_EX | LOCK_NB) == 0;
+    if (usable && !owned_by_user(shm->fd, 0)) {
+        errno  = EACCES;
+        usable = false;
+    }
+    if (!usable || ftruncate(shm->fd, sizeof(NordShmSegment)) != 0) {
+        (void)close(shm->fd);
+        shm->fd = -1;
+        return -1;
+    }
+    void *map = mmap(nullptr, sizeof(NordShmSegment), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, shm->fd, 0);
+    if (map == MAP_FAILED) {
+        (void)close(shm->fd);
+        shm->fd = -1;
+        return -1;
+    }
+
+    // A writer that died mid-update leaves the sequence odd; step past it.
+    NordShmSegment *segment = map;
+    uint32_t sequence =
+        atomic_load_explicit(&segment->sequence, memory_order_relaxed);
+    sequence += sequence & 1U;
+    atomic_store_explicit(&segment->sequence, sequence + 1U,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    segment->magic   = NORD_SHM_MAGIC;
+    segment->version = NORD_SHM_VERSION;
+    segment->pid     = (int32_t)getpid();
+    memset(&segment->palette, 0, sizeof(segment->palette));
+    atomic_store_explicit(&segment->sequence, sequence + 2U,
+                          memory_order_release);
+    shm->segment = segment;
+    return 0;
+}
+
+void nord_shm_publish(NordShm *shm, const NordShmPalette *palette) {
+    NordShmSegment *segment = shm->segment;
+    uint32_t sequence =
+        atomic_load_explicit(&segment->sequence, memory_order_relaxed);
+    atomic_store_explicit(&segment->sequence, sequence + 1U,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&segment->palette, palette, sizeof(*palette));
+    atomic_store_explicit(&segment->sequence, sequence + 2U,
+                          memory_order_release);
+}
+
+void nord_shm_destroy(NordShm *shm, const char *name) {
+    char default_name[NORD_SHM_NAME_SIZE];
+    if (!name) {
+        nord_shm_default_name(default_name, sizeof(default_name));
+        name = default_name;
+    }
+    if (shm->segment) {
+        (void)munmap(shm->segment, sizeof(NordShmSegment));
+        shm->segment = nullptr;
+    }
+    if (shm->fd >= 0) {
+        // Unlink while still holding the lock so a new writer cannot have
+        // taken the name in between.
+        (void)shm_unlink(name);
+        (void)close(shm->fd);
+        shm->fd = -1;
+    }
+}
+
+int nord_shm_open(NordShm *shm, const char *name) {
+    char default_name[NORD_SHM_NAME_SIZE];
+    if (!name) {
+        nord_shm_default_name(default_name, sizeof(default_name));
+        name = default_name;
+    }
+    shm->segment = nullptr;
+    shm->fd      = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (shm->fd < 0) {
+        return -1;
+    }
+    void *map = MAP_FAILED;
+    if (owned_by_user(shm->fd, sizeof(NordShmSegment))) {
+        map = mmap(nullptr, sizeof(NordShmSegment), PROT_READ, MAP_SHARED,
+                   shm->fd, 0);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    (void)close(shm->fd);
+    shm->fd = -1;
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    shm->segment = map;
+    if (shm->segment->magic != NORD_SHM_MAGIC ||
+        shm->segment->version != NORD_SHM_VERSION) {
+        nord_shm_close(shm);
+        errno = EPROTO;
+        return -1;
+    }
+    return 0;
+}
+
+int nord_shm_read(const NordShm *shm, NordShmPalette *palette) {
+    NordShmSegment *segment = shm->segment;
+    for (int attempt = 0;  // NOLINT(altera-unroll-loops)
+         attempt < NORD_SHM_MAX_RETRIES; attempt++) {
+        uint32_t begin =
+            atomic_load_explicit(&segment->sequence, memory_order_acquire);
+        if (begin & 1U) {
+            continue;
+        }
+        memcpy(palette, &segment->palette, sizeof(*palette));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&segment->sequence, memory_order_relaxed) ==
+            begin) {
+            return 0;
+        }
+    }
+    errno = EAGAIN;
+    return -1;
+}
+
+void nord_shm_close(NordShm *shm) {
+    if (shm->segment) {
+        (void)munmap(shm->segment, sizeof(NordShmSegment));
+        shm->segment = nullptr;
+    }
+}
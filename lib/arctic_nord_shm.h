@@ -0,0 +1,91 @@
+/*
+ * Filename: arctic_nord_shm.h
+ *
+ * Description: Layout of the shared-memory segment in which the dock
+ * publishes its palette and current format, and the functions to write and
+ * read it. Status bars, editor plugins and scripts link the reader side to
+ * show the dock's state without talking to the X server.
+ *
+ * The segment is guarded by a seqlock: the writer makes the sequence odd,
+ * updates the payload and makes it even again, and readers copy the payload
+ * and retry if the sequence moved or was odd. Reads never block the writer
+ * and take no system calls.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef ARCTIC_NORD_SHM_H
+#define ARCTIC_NORD_SHM_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define NORD_SHM_MAGIC 0x44524F4EU  // "NORD" in little-endian byte order.
+#define NORD_SHM_VERSION 1U
+#define NORD_SHM_COLORS 16
+#define NORD_SHM_LABEL_SIZE 16
+#define NORD_SHM_TEXT_SIZE 64
+#define NORD_SHM_NAME_SIZE 64
+
+// Reads that find the writer busy this many times in a row give up, which
+// only happens if the writer died halfway through an update.
+#define NORD_SHM_MAX_RETRIES 1024
+
+typedef struct {
+    uint32_t color;                   // 0xRRGGBB.
+    char label[NORD_SHM_LABEL_SIZE];  // Such as "nord8".
+    char text[NORD_SHM_TEXT_SIZE];    // The color in the current format.
+} NordShmEntry;
+
+// Everything a reader gets in one consistent snapshot.
+typedef struct {
+    uint32_t format;                        // Current format, in menu order.
+    char format_name[NORD_SHM_LABEL_SIZE];  // Such as "HTML HEX".
+    uint32_t count;                         // Entries in use.
+    NordShmEntry entries[NORD_SHM_COLORS];
+} NordShmPalette;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t pid;                // The publishing dock. A dock that was
+                                // killed leaves its last palette behind.
+    _Atomic uint32_t sequence;  // Odd while an update is in progress.
+    NordShmPalette palette;
+} NordShmSegment;
+
+// A mapping of the segment, either side.
+typedef struct {
+    NordShmSegment *segment;
+    int fd;
+} NordShm;
+
+// Fill name with the per-user segment name used by the dock.
+void nord_shm_default_name(char *name, size_t size);
+
+// Create the named segment, or nullptr for the default, for writing. Fails
+// if another process is publishing to it. Returns 0 on success or -1 on
+// error.
+int nord_shm_create(NordShm *shm, const char *name);
+
+// Replace the published palette.
+void nord_shm_publish(NordShm *shm, const NordShmPalette *palette);
+
+// Remove the segment created by nord_shm_create() and unmap it.
+void nord_shm_destroy(NordShm *shm, const char *name);
+
+// Map the named segment, or nullptr for the default, read-only. Returns 0 on
+// success or -1 if no dock publishes it.
+int nord_shm_open(NordShm *shm, const char *name);
+
+// Copy a consistent snapshot of the palette. Returns 0 on success or -1 if
+// the segment stayed mid-update for NORD_SHM_MAX_RETRIES attempts.
+int nord_shm_read(const NordShm *shm, NordShmPalette *palette);
+
+// Unmap a segment opened with nord_shm_open().
+void nord_shm_close(NordShm *shm);
+
+#endif  // ARCTIC_NORD_SHM_H
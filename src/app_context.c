@@ -1,8 +1,8 @@
 /*
  * Filename: app_context.c
  *
- * Description: Defines the global AppContext structure which holds the X11
- * display, window, graphics context, and related settings for the dock.
+ * Description: Defines the global AppContext structure which holds the
+ * platform backend and related settings for the dock.
  *
  * Author: Michael Knap
  * Date: 2025-02-13
@@ -1,8 +1,8 @@
 /*
  * Filename: app_context.h
  *
- * Description: Declarations for the AppContext structure, which holds global
- * X11-related resources and window parameters for the dock application.
+ * Description: Declarations for the AppContext structure, which holds the
+ * active platform backend and window parameters for the dock application.
  *
  * Author: Michael Knap
  * Date: 2025-02-13
@@ -12,22 +12,29 @@
 #ifndef APP_CONTEXT_H
 #define APP_CONTEXT_H
 
-#include <X11/Xlib.h>
-#include <X11/Xutil.h>
 #include <stdint.h>
 
+#include "backend.h"
+
 #define CLIPBOARD_BUFFER_SIZE 64
+// Longest text a backend owns, with its NUL, such as a palette export.
+#define CLIPBOARD_TEXT_SIZE 16384
 
 typedef struct {
-    Display *display;
-    Window window;
-    GC gc;
-    XVisualInfo vinfo;
+    const Backend *backend;
+    Monitor monitor;  // The monitor the dock is placed on.
     uint32_t dock_width;
     uint32_t dock_height;
     uint32_t rect_size;
+    uint32_t columns;  // Columns of boxes; the palette runs down each in turn.
+    float scale;  // HiDPI scale factor of the dock's monitor.
 } AppContext;
 
 extern AppContext app;
 
+// Scale a layout constant given in 96 DPI pixels to device pixels.
+static inline uint32_t scaled(uint32_t value) {
+    return (uint32_t)((float)value * app.scale + 0.5F);
+}
+
 #endif  // APP_CONTEXT_H
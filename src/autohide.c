@@ -0,0 +1,202 @@
+/*
+ * Filename: autohide.c
+ *
+ * Description: Implements the auto-hiding dock: the hide delay, the slide
+ * animation and the timerfd that paces both.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "autohide.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "app_context.h"
+#include "backend.h"
+#include "stats.h"
+
+#define NS_PER_MS 1000000ULL
+#define NS_PER_S 1000000000ULL
+#define DEFAULT_REFRESH_MHZ 60000U
+
+typedef enum {
+    AUTOHIDE_IDLE,     // Fully in or fully out; the timer is disarmed.
+    AUTOHIDE_WAITING,  // The pointer left and the hide delay is running.
+    AUTOHIDE_SLIDING   // A slide is running and the timer ticks every frame.
+} AutohidePhase;
+
+static struct {
+    bool enabled;
+    int timer_fd;
+    AutohidePhase phase;
+    int right;          // Screen x of the dock's right edge.
+    int y;
+    uint32_t strip;     // Width left on screen when the dock is hidden.
+    uint32_t shown;     // Width currently on screen.
+    uint32_t from;      // Width at the start of the running slide.
+    uint32_t to;        // Width at the end of the running slide.
+    uint64_t start_ns;  // Start of the running slide.
+    uint64_t slide_ns;  // Duration of the running slide.
+    uint64_t frame_ns;  // Refresh period of the dock's monitor.
+} ah = { .timer_fd = -1 };
+
+void autohide_enable(void) {
+    ah.enabled = true;
+}
+
+// Fire once after first_ns and then every interval_ns. Zero disarms.
+static void arm_timer(uint64_t first_ns, uint64_t interval_ns) {
+    struct itimerspec spec = {
+        .it_interval = { .tv_sec  = (time_t)(interval_ns / NS_PER_S),
+                         .tv_nsec = (long)(interval_ns % NS_PER_S) },
+        .it_value    = { .tv_sec  = (time_t)(first_ns / NS_PER_S),
+                         .tv_nsec = (long)(first_ns % NS_PER_S) },
+    };
+    (void)timerfd_settime(ah.timer_fd, 0, &spec, nullptr);
+}
+
+static void set_idle(void) {
+    if (ah.phase != AUTOHIDE_IDLE) {
+        arm_timer(0, 0);
+        ah.phase = AUTOHIDE_IDLE;
+    }
+}
+
+static void show_width(uint32_t width) {
+    if (width == ah.shown) {
+        return;
+    }
+    ah.shown = width;
+    app.backend->slide(ah.right - (int)width, ah.y, width);
+    app.backend->flush();
+}
+
+// Slide towards the given width. Partial slides, such as reversing halfway,
+// take proportionally less time so the speed stays the same.
+static void start_slide(uint32_t to) {
+    if (ah.shown == to) {
+        set_idle();
+        return;
+    }
+    uint32_t distance = to > ah.shown ? to - ah.shown : ah.shown - to;
+    uint32_t range    = app.dock_width > ah.strip ? app.dock_width - ah.strip
+                                                  : 1;
+    ah.from           = ah.shown;
+    ah.to             = to;
+    ah.start_ns       = stats_now_ns();
+    ah.slide_ns       = AUTOHIDE_SLIDE_MS * NS_PER_MS * distance / range;
+    ah.phase          = AUTOHIDE_SLIDING;
+    arm_timer(ah.frame_ns, ah.frame_ns);
+}
+
+// Position the dock for the current time. Frames are placed by elapsed time,
+// so expirations missed under load shorten the slide rather than slow it.
+static void slide_frame(void) {
+    uint64_t elapsed = stats_now_ns() - ah.start_ns;
+    if (elapsed >= ah.slide_ns) {
+        show_width(ah.to);
+        set_idle();
+        return;
+    }
+
+    // Ease out: start fast and settle into place.
+    double t      = (double)elapsed / (double)ah.slide_ns;
+    double eased  = 1.0 - ((1.0 - t) * (1.0 - t) * (1.0 - t));
+    double offset = ((double)ah.to - (double)ah.from) * eased;
+    show_width((uint32_t)((double)ah.from + offset + 0.5));
+}
+
+bool autohide_place(int x, int y) {
+    if (!ah.enabled) {
+        return false;
+    }
+    if (ah.timer_fd < 0) {
+        ah.timer_fd =
+            timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (ah.timer_fd < 0) {
+            perror("timerfd_create");
+            autohide_stop();
+            return false;
+        }
+    }
+
+    uint32_t refresh_mhz = app.monitor.refresh_mhz ? app.monitor.refresh_mhz
+                                                   : DEFAULT_REFRESH_MHZ;
+    ah.frame_ns          = NS_PER_S * 1000U / refresh_mhz;
+    ah.right             = x + (int)app.dock_width;
+    ah.y                 = y;
+    ah.strip             = scaled(AUTOHIDE_STRIP);
+    if (ah.strip == 0 || ah.strip > app.dock_width) {
+        ah.strip = 1;
+    }
+    ah.shown = app.dock_width;
+    if (!app.backend->slide(x, y, app.dock_width)) {
+        (void)fprintf(stderr, "Auto-hide is not supported by the %s backend.\n",
+                      app.backend->name);
+        autohide_stop();
+        return false;
+    }
+
+    if (!watch_event_timer(ah.timer_fd)) {
+        (void)fprintf(stderr, "Too many timers for auto-hide.\n");
+        autohide_stop();
+        return false;
+    }
+    set_idle();
+    autohide_pointer_out();
+    return true;
+}
+
+void autohide_pointer_in(void) {
+    // Called for every motion event, so the common cases return early.
+    bool shown      = ah.phase == AUTOHIDE_IDLE && ah.shown == app.dock_width;
+    bool sliding_in = ah.phase == AUTOHIDE_SLIDING && ah.to == app.dock_width;
+    if (!ah.enabled || shown || sliding_in) {
+        return;
+    }
+    start_slide(app.dock_width);
+}
+
+void autohide_pointer_out(void) {
+    if (!ah.enabled || ah.phase == AUTOHIDE_WAITING ||
+        (ah.phase == AUTOHIDE_IDLE && ah.shown == ah.strip) ||
+        (ah.phase == AUTOHIDE_SLIDING && ah.to == ah.strip)) {
+        return;
+    }
+    ah.phase = AUTOHIDE_WAITING;
+    arm_timer(AUTOHIDE_DELAY_MS * NS_PER_MS, 0);
+}
+
+bool autohide_active(void) {
+    return ah.enabled;
+}
+
+bool autohide_owns_timer(int fd) {
+    return fd >= 0 && fd == ah.timer_fd;
+}
+
+void autohide_timer(void) {
+    if (ah.phase == AUTOHIDE_WAITING) {
+        start_slide(ah.strip);
+    } else if (ah.phase == AUTOHIDE_SLIDING) {
+        slide_frame();
+    }
+}
+
+void autohide_stop(void) {
+    if (ah.timer_fd >= 0) {
+        unwatch_event_timer(ah.timer_fd);
+        (void)close(ah.timer_fd);
+        ah.timer_fd = -1;
+    }
+    ah.enabled = false;
+    ah.phase   = AUTOHIDE_IDLE;
+}
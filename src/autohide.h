@@ -0,0 +1,49 @@
+/*
+ * Filename: autohide.h
+ *
+ * Description: Declarations for the auto-hiding dock. Once the pointer leaves
+ * the dock it slides out of the monitor until only a thin strip is left, and
+ * it slides back in when the pointer touches that strip. Slides are paced by a
+ * timerfd at the monitor's refresh rate; the timer is disarmed between slides,
+ * so an idle dock never wakes up.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef AUTOHIDE_H
+#define AUTOHIDE_H
+
+#define AUTOHIDE_STRIP 2       // Width left on screen, in 96 DPI pixels.
+#define AUTOHIDE_DELAY_MS 400  // Time from the pointer leaving to the slide.
+#define AUTOHIDE_SLIDE_MS 150  // Duration of a slide across the whole dock.
+
+// Turn auto-hide on. It takes effect when the dock is placed.
+void autohide_enable(void);
+
+// Place the fully shown dock with its top-left corner at x, y, sized as in
+// app, and hide it after the usual delay. Returns false if auto-hide is off,
+// or has been turned off because the backend cannot slide the dock.
+bool autohide_place(int x, int y);
+
+// The pointer is over the dock: slide it in and cancel any pending hide.
+void autohide_pointer_in(void);
+
+// The pointer left the dock: slide it out after a delay.
+void autohide_pointer_out(void);
+
+// Whether auto-hide is on. Its dock keeps the size computed for the monitor,
+// since the width is what slides.
+bool autohide_active(void);
+
+// Whether an EVENT_TIMER came from auto-hide's timer.
+bool autohide_owns_timer(int fd);
+
+// Advance the pending hide or the running slide on EVENT_TIMER.
+void autohide_timer(void);
+
+// Turn auto-hide off and release its timer.
+void autohide_stop(void);
+
+#endif  // AUTOHIDE_H
@@ -0,0 +1,121 @@
+/*
+ * Filename: backend.c
+ *
+ * Description: Backend registry and the blocking event wait shared by every
+ * backend, which also runs idle work while no event is waiting.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "backend.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "idle.h"
+#include "stats.h"
+
+static int timer_fds[] = { -1, -1, -1, -1, -1 };
+static_assert(sizeof(timer_fds) / sizeof(timer_fds[0]) == MAX_EVENT_TIMERS,
+              "one free timer slot per EventTimerUser");
+
+static const Backend *const backends[] = { &xlib_backend, &xcb_backend,
+                                           &null_backend };
+
+const Backend *find_backend(const char *name) {
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]);
+         i++) {  // NOLINT(altera-unroll-loops)
+        if (strcmp(backends[i]->name, name) == 0) {
+            return backends[i];
+        }
+    }
+    return nullptr;
+}
+
+float dpi_scale(double dpi) {
+    double quarters = round(dpi / 96.0 * 4.0);
+    return quarters > 4.0 ? (float)(quarters / 4.0) : 1.0F;
+}
+
+double monitor_dpi(uint32_t pixels, uint32_t millimeters) {
+    if (millimeters == 0) {
+        return 0.0;
+    }
+    return pixels * 25.4 / millimeters;
+}
+
+bool watch_event_timer(int fd) {
+    for (size_t i = 0; i < MAX_EVENT_TIMERS; i++) {  // NOLINT
+        if (timer_fds[i] < 0 || timer_fds[i] == fd) {
+            timer_fds[i] = fd;
+            return true;
+        }
+    }
+    return false;
+}
+
+void unwatch_event_timer(int fd) {
+    for (size_t i = 0; i < MAX_EVENT_TIMERS; i++) {  // NOLINT
+        if (timer_fds[i] == fd) {
+            timer_fds[i] = -1;
+        }
+    }
+}
+
+// Whether the event source or a timer became readable: idle work yields.
+static bool input_pending(void *context) {
+    return poll((struct pollfd *)context, 1 + MAX_EVENT_TIMERS, 0) > 0;
+}
+
+bool wait_event(const Backend *backend, DockEvent *event) {
+    while (!backend->next_event(event)) {  // NOLINT(altera-unroll-loops)
+        int fd = backend->event_fd();
+        if (fd < 0) {
+            return false;
+        }
+        // poll() skips timer entries while they are -1.
+        struct pollfd pfds[1 + MAX_EVENT_TIMERS] = {
+            { .fd = fd, .events = POLLIN, .revents = 0 },
+        };
+        for (size_t i = 0; i < MAX_EVENT_TIMERS; i++) {  // NOLINT
+            pfds[1 + i] = (struct pollfd){ .fd      = timer_fds[i],
+                                           .events  = POLLIN,
+                                           .revents = 0 };
+        }
+        // With idle work queued, look without blocking, and spend a slice
+        // on it if nothing is waiting.
+        int ready = poll(pfds, 1 + MAX_EVENT_TIMERS, idle_pending() ? 0 : -1);
+        if (ready < 0 && errno != EINTR) {
+            return false;
+        }
+        if (ready == 0) {
+            idle_run_slice(input_pending, pfds);
+            continue;
+        }
+        stats.wakeups++;
+
+        // Reading the expiration count re-arms a level-triggered timerfd, so
+        // a caller that ignores EVENT_TIMER does not spin. One timer is
+        // reported per call; the others stay readable for the next.
+        for (size_t i = 0; i < MAX_EVENT_TIMERS; i++) {  // NOLINT
+            uint64_t expirations = 0;
+            if ((pfds[1 + i].revents & POLLIN) &&
+                read(pfds[1 + i].fd, &expirations, sizeof(expirations)) ==
+                    (ssize_t)sizeof(expirations)) {
+                memset(event, 0, sizeof(*event));
+                event->type    = EVENT_TIMER;
+                event->surface = DOCK_SURFACE;
+                event->timer   = pfds[1 + i].fd;
+                return true;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,245 @@
+/*
+ * Filename: backend.h
+ *
+ * Description: Declarations for the platform backend interface. A backend owns
+ * the connection to the display system and provides windows ("surfaces"),
+ * drawing primitives, clipboard ownership and the event source. The dock logic
+ * only talks to the display through this interface.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Handle to a backend window. The dock window is always DOCK_SURFACE.
+typedef uint32_t Surface;
+
+#define DOCK_SURFACE 0U
+
+// Mouse buttons as reported in DockEvent.button.
+#define BUTTON_LEFT 1U
+#define BUTTON_MIDDLE 2U
+#define BUTTON_RIGHT 3U
+
+// Modifier keys of a Hotkey or held during a button event, combined with |.
+#define MOD_SHIFT 1U
+#define MOD_CONTROL 2U
+#define MOD_ALT 4U
+#define MOD_SUPER 8U
+
+typedef enum {
+    EVENT_EXPOSE,           // Surface contents must be redrawn.
+    EVENT_BUTTON_PRESS,     // Mouse button pressed inside a surface.
+    EVENT_BUTTON_RELEASE,   // Mouse button released inside a surface.
+    EVENT_MOTION,           // Pointer moved inside a surface.
+    EVENT_ENTER,            // Pointer entered a surface.
+    EVENT_LEAVE,            // Pointer left a surface.
+    EVENT_SCREEN_CHANGE,    // Monitors were added, removed or reconfigured.
+    EVENT_TIMER,            // A timer passed to watch_event_timer() expired.
+    EVENT_HOTKEY,           // A key combination from grab_hotkeys() was hit.
+    EVENT_RESIZE,           // The window manager resized the dock window.
+    EVENT_CLIPBOARD_OWNER,  // Another client took the watched clipboard.
+    EVENT_CLIPBOARD_TEXT,   // Text asked for with read_clipboard() arrived.
+    EVENT_CLOSE             // The user asked to close the dock.
+} DockEventType;
+
+// A backend-neutral input or window event.
+typedef struct {
+    DockEventType type;
+    Surface surface;
+    uint32_t button;
+    int x;  // Surface-relative pointer position.
+    int y;
+    int root_x;  // Screen-relative pointer position.
+    int root_y;
+    uint32_t hotkey;     // Id of the Hotkey behind EVENT_HOTKEY.
+    uint32_t modifiers;  // MOD_* flags held during a button event.
+    int timer;           // File descriptor of the timer behind EVENT_TIMER.
+    uint32_t width;      // New size of the dock window on EVENT_RESIZE.
+    uint32_t height;
+    // Text behind EVENT_CLIPBOARD_TEXT, or nullptr if there is none. It is
+    // not NUL-terminated and stays valid until the next event is fetched.
+    const char *text;
+    size_t text_length;
+} DockEvent;
+
+// A key combination grabbed for the whole screen.
+typedef struct {
+    uint32_t id;         // Reported in DockEvent.hotkey.
+    uint32_t keysym;     // X keysym; Latin-1 keysyms equal their code points.
+    uint32_t modifiers;  // MOD_* flags.
+} Hotkey;
+
+#define MAX_MONITORS 16
+#define MONITOR_NAME_SIZE 32
+
+// A monitor's area within the screen.
+typedef struct {
+    int x;
+    int y;
+    uint32_t width;
+    uint32_t height;
+    uint32_t refresh_mhz;  // Refresh rate in millihertz, or 0 if unknown.
+    float scale;           // Device pixels per 96 DPI pixel, at least 1.
+    char name[MONITOR_NAME_SIZE];
+} Monitor;
+
+// Represents the dimensions of rendered text.
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+} TextMetrics;
+
+typedef struct Backend {
+    const char *name;
+
+    // Connect to the display system. Returns 0 on success or -1 on error.
+    int (*open)(void);
+    // Release every resource held by the backend.
+    void (*close)(void);
+    // Fill out with up to max monitors, the primary monitor first. Returns
+    // the number of monitors written, which is at least one.
+    size_t (*monitors)(Monitor *out, size_t max);
+
+    // Create and map the dock window. Returns 0 on success or -1 on error.
+    int (*create_window)(int x, int y, uint32_t width, uint32_t height);
+    // Move and resize the dock window. Its contents must be redrawn.
+    void (*move_resize)(int x, int y, uint32_t width, uint32_t height);
+    // Adopt the size reported by EVENT_RESIZE, rebuilding whatever the
+    // backend keeps at the window size, without moving or resizing the
+    // window itself. Its contents must be redrawn.
+    void (*resize)(uint32_t width, uint32_t height);
+    // Move the dock window to x, y and show only the leftmost shown_width
+    // columns of its current contents, which are repainted without being
+    // redrawn. Returns false if the backend cannot.
+    bool (*slide)(int x, int y, uint32_t shown_width);
+    // Create a popup above all other windows. Returns DOCK_SURFACE on error.
+    Surface (*open_popup)(int x, int y, uint32_t width, uint32_t height);
+    void (*close_popup)(Surface surface);
+    void (*move_popup)(Surface surface, int x, int y);
+
+    void (*fill_rect)(Surface surface, int x, int y, uint32_t width,
+                      uint32_t height, uint32_t color);
+    // Copy a block of XRGB pixels, whose rows are stride pixels apart, to a
+    // popup.
+    void (*put_image)(Surface surface, int x, int y, uint32_t width,
+                      uint32_t height, const uint32_t *pixels,
+                      uint32_t stride);
+    // Draw a size x size color box with rounded corners over a translucent
+    // background. Returns false if the backend only draws opaque, square
+    // boxes, in which case the caller fills the box itself.
+    bool (*draw_box)(Surface surface, int x, int y, uint32_t size,
+                     uint32_t radius, uint32_t color);
+    // Show the size x size area at x, y scaled down to shown_size around its
+    // center, or restore it when shown_size equals size, without redrawing
+    // its contents. Returns false if the backend cannot, in which case the
+    // caller redraws the area.
+    bool (*press_box)(Surface surface, int x, int y, uint32_t size,
+                      uint32_t shown_size);
+    // Draw text with its baseline at y.
+    void (*draw_text)(Surface surface, int x, int y, const char *text,
+                      size_t len, uint32_t color);
+    TextMetrics (*text_metrics)(const char *text, size_t len);
+    // Render text at scale times its base size from now on.
+    void (*set_scale)(float scale);
+    void (*flush)(void);
+    // Flush and wait until the server has processed every request. Only
+    // used to time redraws.
+    void (*sync)(void);
+
+    // Take ownership of the clipboard and serve text from it.
+    // Returns true if ownership was acquired.
+    bool (*set_clipboard)(const char *text, size_t len);
+    // Report each time another client takes the clipboard as
+    // EVENT_CLIPBOARD_OWNER, without polling. Returns false if the backend
+    // cannot.
+    bool (*watch_clipboard)(void);
+    // Ask the clipboard's owner for its text as UTF-8. EVENT_CLIPBOARD_TEXT
+    // follows, without text if the owner refused or offered more than max
+    // bytes, of which nothing is transferred. Returns false if no request
+    // was made.
+    bool (*read_clipboard)(size_t max);
+
+    // Grab the given key combinations for the whole screen, whichever window
+    // has the focus, replacing earlier grabs. Returns how many could be
+    // grabbed; combinations another client holds are left out.
+    size_t (*grab_hotkeys)(const Hotkey *hotkeys, size_t count);
+    // Grab the pointer for the whole screen, or release the grab. While it
+    // is held, pointer events arrive on DOCK_SURFACE and carry screen
+    // coordinates in root_x and root_y. Returns false if the backend cannot
+    // grab the pointer or another client holds it.
+    bool (*grab_pointer)(bool grab);
+    // Read width x height screen pixels at x, y as XRGB into rows stride
+    // pixels apart. Pixels off the screen read as black. Returns false if
+    // the backend cannot read the screen.
+    bool (*capture)(int x, int y, uint32_t width, uint32_t height,
+                    uint32_t *pixels, uint32_t stride);
+    // Read the whole dock as drawn, width x height pixels in the backend's
+    // own format, into rows stride pixels apart. Returns false if the
+    // backend cannot, or if the dock is not that size.
+    bool (*read_dock)(uint32_t *pixels, uint32_t width, uint32_t height,
+                      uint32_t stride);
+    // Name how the dock is drawn apart from its layout and colors: the pixel
+    // format, the drawing path and the label font asked for. Frames read
+    // back under another tag must not be put.
+    const char *(*render_tag)(void);
+    // Show pixels from read_dock as the whole dock once flushed, without
+    // drawing anything. Returns false if the backend cannot, or if the dock
+    // is not that size.
+    bool (*put_dock)(const uint32_t *pixels, uint32_t width, uint32_t height,
+                     uint32_t stride);
+
+    // File descriptor that becomes readable when events may be pending, or
+    // -1 if the backend has no external event source.
+    int (*event_fd)(void);
+    // Fetch the next pending event without blocking. Returns false when the
+    // queue is empty. Protocol housekeeping (such as serving clipboard
+    // requests) happens inside this call.
+    bool (*next_event)(DockEvent *event);
+} Backend;
+
+extern const Backend xlib_backend;
+extern const Backend xcb_backend;
+extern const Backend null_backend;
+
+// Look up a backend by name. Returns nullptr if no backend matches.
+const Backend *find_backend(const char *name);
+
+// Scale factor for a given DPI, in quarter steps relative to 96 DPI. Unknown
+// (zero) and low DPIs give 1.
+float dpi_scale(double dpi);
+
+// DPI of a monitor from its width in pixels and in millimeters, or 0 if the
+// physical size is unknown.
+double monitor_dpi(uint32_t pixels, uint32_t millimeters);
+
+// Users of watch_event_timer(), one polled descriptor each.
+typedef enum {
+    TIMER_AUTOHIDE,         // Hide delay and slide animation.
+    TIMER_RESIZE,           // End of a burst of dock resizes.
+    TIMER_WORKERS,          // Eventfd counting finished worker jobs.
+    TIMER_CLIPBOARD_WATCH,  // Held-back clipboard reads.
+    TIMER_SELECTION,        // Stalled selection transfers.
+    MAX_EVENT_TIMERS
+} EventTimerUser;
+
+// Poll a timer file descriptor (such as a timerfd, or an eventfd that
+// counts finished jobs) next to the backend's event source. wait_event()
+// reads the count and reports it as EVENT_TIMER on DOCK_SURFACE, with the
+// descriptor in DockEvent.timer.
+// Returns false if MAX_EVENT_TIMERS timers are polled already.
+bool watch_event_timer(int fd);
+// Stop polling a timer, before it is closed.
+void unwatch_event_timer(int fd);
+
+// Block until the next event arrives. Returns false if the backend has no
+// more events to deliver.
+bool wait_event(const Backend *backend, DockEvent *event);
+
+#endif  // BACKEND_H
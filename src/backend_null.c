@@ -0,0 +1,360 @@
+/*
+ * Filename: backend_null.c
+ *
+ * Description: Null implementation of the platform backend. Surfaces are
+ * in-memory framebuffers drawn by the software rasterizer, events come from an
+ * in-process queue and the clipboard is a plain buffer.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "backend_null.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "app_context.h"
+#include "backend.h"
+#include "raster.h"
+
+#define NULL_MAX_SURFACES 5
+#define NULL_EVENT_QUEUE_SIZE 256
+#define NULL_MAX_HOTKEYS 32
+
+static struct {
+    Raster surfaces[NULL_MAX_SURFACES];
+    DockEvent queue[NULL_EVENT_QUEUE_SIZE];
+    size_t queue_head;
+    size_t queue_len;
+    DockEvent click;
+    uint32_t clicks_left;
+    uint32_t hotkey_ids[NULL_MAX_HOTKEYS];
+    size_t hotkey_count;
+    uint32_t keys_left;
+    uint32_t keys_sent;
+    uint32_t font_scale;
+    char clipboard_text[CLIPBOARD_TEXT_SIZE];
+} nb = {};
+
+bool null_backend_push_event(const DockEvent *event) {
+    if (nb.queue_len == NULL_EVENT_QUEUE_SIZE) {
+        return false;
+    }
+    nb.queue[(nb.queue_head + nb.queue_len) % NULL_EVENT_QUEUE_SIZE] = *event;
+    nb.queue_len++;
+    return true;
+}
+
+void null_backend_queue_clicks(int x, int y, uint32_t count) {
+    nb.click       = (DockEvent){ .type    = EVENT_BUTTON_PRESS,
+                                  .surface = DOCK_SURFACE,
+                                  .button  = BUTTON_LEFT,
+                                  .x       = x,
+                                  .y       = y,
+                                  .root_x  = x,
+                                  .root_y  = y };
+    nb.clicks_left = count;
+}
+
+void null_backend_queue_hotkeys(uint32_t count) {
+    nb.keys_left = count;
+    nb.keys_sent = 0;
+}
+
+const char *null_backend_clipboard(void) {
+    return nb.clipboard_text;
+}
+
+const Raster *null_backend_framebuffer(Surface surface) {
+    if (surface >= NULL_MAX_SURFACES || !nb.surfaces[surface].pixels) {
+        return nullptr;
+    }
+    return &nb.surfaces[surface];
+}
+
+static int null_open(void) {
+    nb.font_scale = 1;
+    return 0;
+}
+
+static void null_close(void) {
+    for (size_t i = 0; i < NULL_MAX_SURFACES;  // NOLINT(altera-unroll-loops)
+         i++) {
+        raster_free(&nb.surfaces[i]);
+    }
+    nb.queue_head  = 0;
+    nb.queue_len   = 0;
+    nb.clicks_left = 0;
+    nb.keys_left   = 0;
+}
+
+static size_t null_monitors(Monitor *out, size_t max) {
+    (void)max;
+    memset(out, 0, sizeof(*out));
+    out->width       = NULL_SCREEN_WIDTH;
+    out->height      = NULL_SCREEN_HEIGHT;
+    out->refresh_mhz = NULL_REFRESH_MHZ;
+    out->scale       = 1.0F;
+    (void)snprintf(out->name, sizeof(out->name), "null");
+    return 1;
+}
+
+static int null_create_window(int x, int y, uint32_t width, uint32_t height) {
+    (void)x;
+    (void)y;
+    if (raster_init(&nb.surfaces[DOCK_SURFACE], width, height) != 0) {
+        return -1;
+    }
+    // Mapping a window produces an initial expose, as it would on a server.
+    DockEvent expose = { .type = EVENT_EXPOSE, .surface = DOCK_SURFACE };
+    null_backend_push_event(&expose);
+    return 0;
+}
+
+static void null_resize(uint32_t width, uint32_t height) {
+    raster_free(&nb.surfaces[DOCK_SURFACE]);
+    (void)raster_init(&nb.surfaces[DOCK_SURFACE], width, height);
+}
+
+static void null_move_resize(int x, int y, uint32_t width, uint32_t height) {
+    (void)x;
+    (void)y;
+    null_resize(width, height);
+}
+
+// Nothing is on screen to slide.
+static bool null_slide(int x, int y, uint32_t shown_width) {
+    (void)x;
+    (void)y;
+    (void)shown_width;
+    return false;
+}
+
+static Surface null_open_popup(int x, int y, uint32_t width,
+                               uint32_t height) {
+    (void)x;
+    (void)y;
+    for (Surface s = 1; s < NULL_MAX_SURFACES;  // NOLINT(altera-unroll-loops)
+         s++) {
+        if (!nb.surfaces[s].pixels &&
+            raster_init(&nb.surfaces[s], width, height) == 0) {
+            return s;
+        }
+    }
+    return DOCK_SURFACE;
+}
+
+static void null_close_popup(Surface surface) {
+    if (surface != DOCK_SURFACE && surface < NULL_MAX_SURFACES) {
+        raster_free(&nb.surfaces[surface]);
+    }
+}
+
+static void null_move_popup(Surface surface, int x, int y) {
+    (void)surface;
+    (void)x;
+    (void)y;
+}
+
+static void null_put_image(Surface surface, int x, int y, uint32_t width,
+                           uint32_t height, const uint32_t *pixels,
+                           uint32_t stride) {
+    if (surface < NULL_MAX_SURFACES && nb.surfaces[surface].pixels) {
+        Raster image = { (uint32_t *)pixels, width, height, stride };
+        raster_scale_nearest(&nb.surfaces[surface], x, y, &image, 1);
+    }
+}
+
+static void null_fill_rect(Surface surface, int x, int y, uint32_t width,
+                           uint32_t height, uint32_t color) {
+    if (surface < NULL_MAX_SURFACES && nb.surfaces[surface].pixels) {
+        raster_fill_rect(&nb.surfaces[surface], x, y, width, height, color);
+    }
+}
+
+// Boxes are always opaque squares here.
+static bool null_draw_box(Surface surface, int x, int y, uint32_t size,
+                          uint32_t radius, uint32_t color) {
+    (void)surface;
+    (void)x;
+    (void)y;
+    (void)size;
+    (void)radius;
+    (void)color;
+    return false;
+}
+
+static bool null_press_box(Surface surface, int x, int y, uint32_t size,
+                           uint32_t shown_size) {
+    (void)surface;
+    (void)x;
+    (void)y;
+    (void)size;
+    (void)shown_size;
+    return false;
+}
+
+static void null_draw_text(Surface surface, int x, int y, const char *text,
+                           size_t len, uint32_t color) {
+    if (surface < NULL_MAX_SURFACES && nb.surfaces[surface].pixels) {
+        raster_draw_text(&nb.surfaces[surface], x, y, text, len, color,
+                         nb.font_scale);
+    }
+}
+
+static TextMetrics null_text_metrics(const char *text, size_t len) {
+    return raster_text_metrics(text, len, nb.font_scale);
+}
+
+// The builtin font only scales by whole pixels.
+static void null_set_scale(float scale) {
+    nb.font_scale = scale < 1.5F ? 1 : (uint32_t)(scale + 0.5F);
+}
+
+static void null_flush(void) {}
+
+static void null_sync(void) {}
+
+static bool null_set_clipboard(const char *text, size_t len) {
+    if (len > CLIPBOARD_TEXT_SIZE - 1) {
+        len = CLIPBOARD_TEXT_SIZE - 1;
+    }
+    memcpy(nb.clipboard_text, text, len);
+    nb.clipboard_text[len] = '\0';
+    return true;
+}
+
+// Every hotkey is available; they are pressed by null_backend_queue_hotkeys().
+static size_t null_grab_hotkeys(const Hotkey *hotkeys, size_t count) {
+    if (count > NULL_MAX_HOTKEYS) {
+        count = NULL_MAX_HOTKEYS;
+    }
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        nb.hotkey_ids[i] = hotkeys[i].id;
+    }
+    nb.hotkey_count = count;
+    return count;
+}
+
+// There is no screen to grab or read.
+static bool null_grab_pointer(bool grab) {
+    (void)grab;
+    return false;
+}
+
+static bool null_capture(int x, int y, uint32_t width, uint32_t height,
+                         uint32_t *pixels, uint32_t stride) {
+    (void)x;
+    (void)y;
+    (void)width;
+    (void)height;
+    (void)pixels;
+    (void)stride;
+    return false;
+}
+
+// There is no other client to copy anything.
+static bool null_watch_clipboard(void) {
+    return false;
+}
+
+static bool null_read_clipboard(size_t max) {
+    (void)max;
+    return false;
+}
+
+// Nothing is worth caching, and benchmarks must not write to the user's
+// render cache.
+static bool null_read_dock(uint32_t *pixels, uint32_t width, uint32_t height,
+                           uint32_t stride) {
+    (void)pixels;
+    (void)width;
+    (void)height;
+    (void)stride;
+    return false;
+}
+
+static const char *null_render_tag(void) {
+    return "xrgb builtin";
+}
+
+static bool null_put_dock(const uint32_t *pixels, uint32_t width,
+                          uint32_t height, uint32_t stride) {
+    (void)pixels;
+    (void)width;
+    (void)height;
+    (void)stride;
+    return false;
+}
+
+static int null_event_fd(void) {
+    return -1;
+}
+
+static bool null_next_event(DockEvent *event) {
+    if (nb.queue_len == 0) {
+        // Scripted input is generated lazily so any count fits the queue.
+        if (nb.clicks_left == 0) {
+            if (nb.keys_left == 0 || nb.hotkey_count == 0) {
+                return false;
+            }
+            *event = (DockEvent){
+                .type   = EVENT_HOTKEY,
+                .hotkey = nb.hotkey_ids[nb.keys_sent % nb.hotkey_count],
+            };
+            nb.keys_sent++;
+            nb.keys_left--;
+            return true;
+        }
+        *event = nb.click;
+        if (nb.click.type == EVENT_BUTTON_PRESS) {
+            nb.click.type = EVENT_BUTTON_RELEASE;
+        } else {
+            nb.click.type = EVENT_BUTTON_PRESS;
+            nb.clicks_left--;
+        }
+        return true;
+    }
+    *event        = nb.queue[nb.queue_head];
+    nb.queue_head = (nb.queue_head + 1) % NULL_EVENT_QUEUE_SIZE;
+    nb.queue_len--;
+    return true;
+}
+
+const Backend null_backend = {
+    .name            = "null",
+    .open            = null_open,
+    .close           = null_close,
+    .monitors        = null_monitors,
+    .create_window   = null_create_window,
+    .move_resize     = null_move_resize,
+    .resize          = null_resize,
+    .slide           = null_slide,
+    .open_popup      = null_open_popup,
+    .close_popup     = null_close_popup,
+    .move_popup      = null_move_popup,
+    .fill_rect       = null_fill_rect,
+    .put_image       = null_put_image,
+    .draw_box        = null_draw_box,
+    .press_box       = null_press_box,
+    .draw_text       = null_draw_text,
+    .text_metrics    = null_text_metrics,
+    .set_scale       = null_set_scale,
+    .flush           = null_flush,
+    .sync            = null_sync,
+    .set_clipboard   = null_set_clipboard,
+    .watch_clipboard = null_watch_clipboard,
+    .read_clipboard  = null_read_clipboard,
+    .grab_hotkeys    = null_grab_hotkeys,
+    .grab_pointer    = null_grab_pointer,
+    .capture         = null_capture,
+    .read_dock       = null_read_dock,
+    .render_tag      = null_render_tag,
+    .put_dock        = null_put_dock,
+    .event_fd        = null_event_fd,
+    .next_event      = null_next_event,
+};
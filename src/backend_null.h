@@ -0,0 +1,45 @@
+/*
+ * Filename: backend_null.h
+ *
+ * Description: Declarations for driving the null backend, which renders into
+ * an in-memory framebuffer and keeps the clipboard inside the process. It lets
+ * the dock logic run under benchmarks and sanitizers without an X server.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef BACKEND_NULL_H
+#define BACKEND_NULL_H
+
+#include <stdint.h>
+
+#include "backend.h"
+#include "raster.h"
+
+// The single monitor reported by the null backend.
+#define NULL_SCREEN_WIDTH 1920
+#define NULL_SCREEN_HEIGHT 1080
+#define NULL_REFRESH_MHZ 60000
+
+// Queue an event for delivery by next_event(). Returns false if the queue is
+// full.
+bool null_backend_push_event(const DockEvent *event);
+
+// Deliver the given number of left clicks (press and release) at the given
+// dock coordinates once the event queue is empty.
+void null_backend_queue_clicks(int x, int y, uint32_t count);
+
+// Press the given number of grabbed hotkeys, cycling through them in the
+// order they were grabbed, once the event queue is empty and any queued
+// clicks have been delivered.
+void null_backend_queue_hotkeys(uint32_t count);
+
+// Current clipboard contents, or an empty string if nothing was copied.
+const char *null_backend_clipboard(void);
+
+// Framebuffer holding the rendered contents of a surface, or nullptr.
+const Raster *null_backend_framebuffer(Surface surface);
+
+#endif  // BACKEND_NULL_H
@@ -0,0 +1,833 @@
+/*
+ * Filename: backend_xcb.c
+ *
+ * Description: XCB implementation of the platform backend. Requests are
+ * issued asynchronously: the atoms it uses and the font metrics are requested
+ * together at startup and their replies are only collected when first needed,
+ * and the click path sends no request that needs a reply.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <xcb/xcb.h>
+#include <xcb/xproto.h>
+
+#include "app_context.h"
+#include "backend.h"
+#include "stats.h"
+#include "x11_atoms.h"
+
+#define MAX_POPUPS 4
+#define XCB_FONT_NAME "fixed"
+#define POLY_TEXT_MAX_CHUNK 254
+#define CHANGE_PROPERTY_HEADER 24        // Bytes of a ChangeProperty request.
+#define CLIPBOARD_MAX_BYTES (1U << 20U)  // As much as the Xlib backend owns.
+
+// The atoms this backend uses; the others stay XCB_ATOM_NONE.
+static const AtomId used_atoms[] = {
+    ATOM_MOTIF_WM_HINTS, ATOM_WM_PROTOCOLS,  ATOM_WM_DELETE_WINDOW,
+    ATOM_NET_WM_NAME,    ATOM_NET_WM_STATE,  ATOM_NET_WM_STATE_ABOVE,
+    ATOM_UTF8_STRING,    ATOM_COMPOUND_TEXT, ATOM_TARGETS,
+    ATOM_CLIPBOARD,
+};
+
+#define USED_ATOM_COUNT (sizeof(used_atoms) / sizeof(used_atoms[0]))
+
+static struct {
+    xcb_connection_t *conn;
+    xcb_screen_t *screen;
+    uint16_t screen_width;  // Root size, followed through ConfigureNotify.
+    uint16_t screen_height;
+    xcb_visualid_t visual;    // 24-bit TrueColor visual of every window.
+    xcb_colormap_t colormap;  // Its colormap if it is not the root's, or 0.
+    xcb_window_t window;
+    uint32_t width;  // Dock window size last asked for.
+    uint32_t height;
+    xcb_gcontext_t gc;
+    xcb_font_t font;
+    xcb_intern_atom_cookie_t atom_cookies[USED_ATOM_COUNT];
+    xcb_atom_t atoms[ATOM_COUNT];
+    bool atoms_ready;
+    xcb_query_font_cookie_t font_cookie;
+    xcb_query_font_reply_t *font_info;
+    bool font_ready;
+    xcb_window_t popups[MAX_POPUPS];
+    size_t max_property;   // Longest property one request can carry.
+    char *clipboard_text;  // Text served while the dock owns the clipboard.
+    size_t clipboard_len;
+} xc = {};
+
+// Collect the replies to the atom requests and the request length query
+// issued by xc_open(). They were sent in a single batch, so this costs at
+// most one round trip in total.
+static void collect_atoms(void) {
+    if (xc.atoms_ready) {
+        return;
+    }
+    for (size_t i = 0; i < USED_ATOM_COUNT; i++) {  // NOLINT
+        xcb_intern_atom_reply_t *reply =
+            xcb_intern_atom_reply(xc.conn, xc.atom_cookies[i], nullptr);
+        xc.atoms[used_atoms[i]] = reply ? reply->atom : XCB_ATOM_NONE;
+        free(reply);
+    }
+    xc.max_property = ((size_t)xcb_get_maximum_request_length(xc.conn) * 4) -
+                      CHANGE_PROPERTY_HEADER;
+    xc.atoms_ready  = true;
+    stats_round_trip();
+}
+
+// Collect the font metrics requested by xc_open().
+static const xcb_query_font_reply_t *font_info(void) {
+    if (!xc.font_ready) {
+        xc.font_info =
+            xcb_query_font_reply(xc.conn, xc.font_cookie, nullptr);
+        xc.font_ready = true;
+        stats_round_trip();
+    }
+    return xc.font_info;
+}
+
+static int xc_open(void) {
+    int screen_num = 0;
+    xc.conn        = xcb_connect(nullptr, &screen_num);
+    if (xcb_connection_has_error(xc.conn)) {
+        (void)fprintf(stderr, "Unable to open display.\n");
+        xcb_disconnect(xc.conn);
+        xc.conn = nullptr;
+        return -1;
+    }
+
+    xcb_screen_iterator_t it =
+        xcb_setup_roots_iterator(xcb_get_setup(xc.conn));
+    for (int i = 0; i < screen_num; i++) {  // NOLINT(altera-unroll-loops)
+        xcb_screen_next(&it);
+    }
+    xc.screen        = it.data;
+    xc.screen_width  = xc.screen->width_in_pixels;
+    xc.screen_height = xc.screen->height_in_pixels;
+
+    // Issue every request whose reply we will need, then collect the replies
+    // later so the server processes them while we set up the window.
+    for (size_t i = 0; i < USED_ATOM_COUNT; i++) {  // NOLINT
+        const char *name   = atom_names[used_atoms[i]];
+        xc.atom_cookies[i] = xcb_intern_atom(xc.conn, 0,
+                                             (uint16_t)strlen(name), name);
+    }
+    xc.font = xcb_generate_id(xc.conn);
+    xcb_open_font(xc.conn, xc.font, strlen(XCB_FONT_NAME), XCB_FONT_NAME);
+    xc.font_cookie = xcb_query_font(xc.conn, xc.font);
+    xcb_prefetch_maximum_request_length(xc.conn);
+    xcb_flush(xc.conn);
+    return 0;
+}
+
+static void xc_close(void) {
+    if (!xc.conn) {
+        return;
+    }
+    collect_atoms();
+    font_info();
+    free(xc.font_info);
+    xc.font_info = nullptr;
+    free(xc.clipboard_text);
+    xc.clipboard_text = nullptr;
+    for (size_t i = 0; i < MAX_POPUPS; i++) {  // NOLINT(altera-unroll-loops)
+        if (xc.popups[i]) {
+            xcb_destroy_window(xc.conn, xc.popups[i]);
+            xc.popups[i] = 0;
+        }
+    }
+    if (xc.gc) {
+        xcb_free_gc(xc.conn, xc.gc);
+        xc.gc = 0;
+    }
+    if (xc.window) {
+        xcb_destroy_window(xc.conn, xc.window);
+        xc.window = 0;
+    }
+    if (xc.colormap) {
+        xcb_free_colormap(xc.conn, xc.colormap);
+        xc.colormap = 0;
+    }
+    xcb_close_font(xc.conn, xc.font);
+    xcb_disconnect(xc.conn);
+    xc.conn = nullptr;
+}
+
+// The core protocol only knows the whole screen, reported as one monitor.
+static size_t xc_monitors(Monitor *out, size_t max) {
+    (void)max;
+    memset(out, 0, sizeof(*out));
+    out->width  = xc.screen_width;
+    out->height = xc.screen_height;
+    out->scale  = dpi_scale(monitor_dpi(xc.screen->width_in_pixels,
+                                        xc.screen->width_in_millimeters));
+    (void)snprintf(out->name, sizeof(out->name), "screen");
+    return 1;
+}
+
+// A 24-bit TrueColor visual, where a pixel value is the color, as the Xlib
+// backend requires; the root visual when it is one. Returns 0 if the screen
+// has none. The setup data is already on the client, so this is free.
+static xcb_visualid_t truecolor_visual(void) {
+    xcb_visualid_t found = 0;
+    xcb_depth_iterator_t depths =
+        xcb_screen_allowed_depths_iterator(xc.screen);
+    for (; depths.rem; xcb_depth_next(&depths)) {  // NOLINT
+        if (depths.data->depth != 24) {
+            continue;
+        }
+        xcb_visualtype_iterator_t visuals =
+            xcb_depth_visuals_iterator(depths.data);
+        for (; visuals.rem; xcb_visualtype_next(&visuals)) {  // NOLINT
+            if (visuals.data->_class != XCB_VISUAL_CLASS_TRUE_COLOR) {
+                continue;
+            }
+            if (visuals.data->visual_id == xc.screen->root_visual) {
+                return visuals.data->visual_id;
+            }
+            found = found ? found : visuals.data->visual_id;
+        }
+    }
+    return found;
+}
+
+// Create a top-level window on the dock's visual. A visual other than the
+// root's needs its own colormap and an explicit border pixel.
+static void create_window(xcb_window_t window, int x, int y, uint32_t width,
+                          uint32_t height, uint16_t border, uint32_t mask,
+                          xcb_create_window_value_list_t *values) {
+    values->background_pixel = 0;  // Black on a TrueColor visual.
+    if (xc.colormap) {
+        mask |= XCB_CW_BORDER_PIXEL | XCB_CW_COLORMAP;
+        values->border_pixel = 0;
+        values->colormap     = xc.colormap;
+    }
+    xcb_create_window_aux(xc.conn, 24, window, xc.screen->root, (int16_t)x,
+                          (int16_t)y, (uint16_t)width, (uint16_t)height,
+                          border, XCB_WINDOW_CLASS_INPUT_OUTPUT, xc.visual,
+                          mask | XCB_CW_BACK_PIXEL, values);
+}
+
+// Ask the window manager to keep the dock window above others.
+static void set_above_state(void) {
+    xcb_client_message_event_t xclient;
+    memset(&xclient, 0, sizeof(xclient));
+    xclient.response_type  = XCB_CLIENT_MESSAGE;
+    xclient.window         = xc.window;
+    xclient.type           = xc.atoms[ATOM_NET_WM_STATE];
+    xclient.format         = 32;
+    xclient.data.data32[0] = 1;
+    xclient.data.data32[1] = xc.atoms[ATOM_NET_WM_STATE_ABOVE];
+    xclient.data.data32[2] = 0;
+    xclient.data.data32[3] = 1;
+    xclient.data.data32[4] = 0;
+
+    xcb_send_event(xc.conn, 0, xc.screen->root,
+                   XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT |
+                       XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY,
+                   (const char *)&xclient);
+}
+
+static int xc_create_window(int x, int y, uint32_t width, uint32_t height) {
+    xc.visual = truecolor_visual();
+    if (!xc.visual) {
+        (void)fprintf(stderr, "Failed to obtain matching visual info.\n");
+        return -1;
+    }
+    if (xc.visual != xc.screen->root_visual) {
+        xc.colormap = xcb_generate_id(xc.conn);
+        xcb_create_colormap(xc.conn, XCB_COLORMAP_ALLOC_NONE, xc.colormap,
+                            xc.screen->root, xc.visual);
+    }
+
+    // The same events as the Xlib backend's dock window: crossings for the
+    // name tip and auto-hide, structure changes for the window manager's
+    // resizes.
+    xcb_create_window_value_list_t values = {
+        .event_mask = XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_BUTTON_PRESS |
+                      XCB_EVENT_MASK_BUTTON_RELEASE |
+                      XCB_EVENT_MASK_POINTER_MOTION |
+                      XCB_EVENT_MASK_ENTER_WINDOW |
+                      XCB_EVENT_MASK_LEAVE_WINDOW |
+                      XCB_EVENT_MASK_PROPERTY_CHANGE |
+                      XCB_EVENT_MASK_STRUCTURE_NOTIFY,
+    };
+    xc.window = xcb_generate_id(xc.conn);
+    xc.width  = width;
+    xc.height = height;
+    create_window(xc.window, x, y, width, height, 0, XCB_CW_EVENT_MASK,
+                  &values);
+
+    // Screen size changes show up as the root window being reconfigured.
+    const uint32_t root_mask[] = { XCB_EVENT_MASK_STRUCTURE_NOTIFY };
+    xcb_change_window_attributes(xc.conn, xc.screen->root, XCB_CW_EVENT_MASK,
+                                 root_mask);
+
+    collect_atoms();
+
+    // Set window properties to remove decorations.
+    const uint32_t hints[] = { 2, 0, 0, 0, 0 };
+    xcb_change_property(xc.conn, XCB_PROP_MODE_REPLACE, xc.window,
+                        xc.atoms[ATOM_MOTIF_WM_HINTS],
+                        xc.atoms[ATOM_MOTIF_WM_HINTS], 32, 5, hints);
+
+    xcb_change_property(xc.conn, XCB_PROP_MODE_REPLACE, xc.window,
+                        xc.atoms[ATOM_WM_PROTOCOLS], XCB_ATOM_ATOM, 32, 1,
+                        &xc.atoms[ATOM_WM_DELETE_WINDOW]);
+
+    // Set the window name.
+    const char *window_name = "Arctic Nord";
+    xcb_change_property(xc.conn, XCB_PROP_MODE_REPLACE, xc.window,
+                        xc.atoms[ATOM_NET_WM_NAME],
+                        xc.atoms[ATOM_UTF8_STRING], 8,
+                        (uint32_t)strlen(window_name), window_name);
+
+    // Set class hints: instance and class, each NUL-terminated.
+    static const char wm_class[] = "arctic_nord\0ArcticNordDock";
+    xcb_change_property(xc.conn, XCB_PROP_MODE_REPLACE, xc.window,
+                        XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 8,
+                        sizeof(wm_class), wm_class);
+
+    xcb_map_window(xc.conn, xc.window);
+
+    xc.gc = xcb_generate_id(xc.conn);
+    xcb_create_gc(xc.conn, xc.gc, xc.window, XCB_GC_FONT, &xc.font);
+
+    // Reposition the window and set it always on top.
+    const uint32_t position[] = { (uint32_t)x, (uint32_t)y };
+    xcb_configure_window(xc.conn, xc.window,
+                         XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y, position);
+    set_above_state();
+
+    xcb_flush(xc.conn);
+    return 0;
+}
+
+static void xc_move_resize(int x, int y, uint32_t width, uint32_t height) {
+    const uint32_t values[] = { (uint32_t)x, (uint32_t)y, width, height };
+    xc.width                = width;
+    xc.height               = height;
+    xcb_configure_window(xc.conn, xc.window,
+                         XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y |
+                             XCB_CONFIG_WINDOW_WIDTH |
+                             XCB_CONFIG_WINDOW_HEIGHT,
+                         values);
+}
+
+// The dock is drawn straight to its window, so nothing is kept at its size.
+static void xc_resize(uint32_t width, uint32_t height) {
+    xc.width  = width;
+    xc.height = height;
+}
+
+// The dock is drawn straight to its window, so there is nothing to repaint
+// a sliding dock from.
+static bool xc_slide(int x, int y, uint32_t shown_width) {
+    (void)x;
+    (void)y;
+    (void)shown_width;
+    return false;
+}
+
+static Surface xc_open_popup(int x, int y, uint32_t width, uint32_t height) {
+    for (size_t i = 0; i < MAX_POPUPS; i++) {  // NOLINT(altera-unroll-loops)
+        if (xc.popups[i]) {
+            continue;
+        }
+
+        xcb_create_window_value_list_t values = {
+            .override_redirect = 1,
+            .event_mask        = XCB_EVENT_MASK_EXPOSURE |
+                                 XCB_EVENT_MASK_BUTTON_PRESS |
+                                 XCB_EVENT_MASK_POINTER_MOTION |
+                                 XCB_EVENT_MASK_LEAVE_WINDOW,
+        };
+        xc.popups[i] = xcb_generate_id(xc.conn);
+        create_window(xc.popups[i], x, y, width, height, 1,
+                      XCB_CW_OVERRIDE_REDIRECT | XCB_CW_EVENT_MASK, &values);
+
+        const uint32_t stack_mode[] = { XCB_STACK_MODE_ABOVE };
+        xcb_configure_window(xc.conn, xc.popups[i],
+                             XCB_CONFIG_WINDOW_STACK_MODE, stack_mode);
+        xcb_map_window(xc.conn, xc.popups[i]);
+        xcb_flush(xc.conn);
+        return (Surface)(i + 1);
+    }
+    return DOCK_SURFACE;
+}
+
+static void xc_close_popup(Surface surface) {
+    if (surface == DOCK_SURFACE || surface > MAX_POPUPS ||
+        !xc.popups[surface - 1]) {
+        return;
+    }
+    xcb_destroy_window(xc.conn, xc.popups[surface - 1]);
+    xc.popups[surface - 1] = 0;
+}
+
+static void xc_move_popup(Surface surface, int x, int y) {
+    if (surface == DOCK_SURFACE || surface > MAX_POPUPS ||
+        !xc.popups[surface - 1]) {
+        return;
+    }
+    const uint32_t values[] = { (uint32_t)x, (uint32_t)y };
+    xcb_configure_window(xc.conn, xc.popups[surface - 1],
+                         XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y, values);
+}
+
+// Only the color picker puts images, and it needs xc_grab_pointer().
+static void xc_put_image(Surface surface, int x, int y, uint32_t width,
+                         uint32_t height, const uint32_t *pixels,
+                         uint32_t stride) {
+    (void)surface;
+    (void)x;
+    (void)y;
+    (void)width;
+    (void)height;
+    (void)pixels;
+    (void)stride;
+}
+
+static xcb_window_t window_of(Surface surface) {
+    if (surface == DOCK_SURFACE) {
+        return xc.window;
+    }
+    return surface <= MAX_POPUPS ? xc.popups[surface - 1] : 0;
+}
+
+static Surface surface_of(xcb_window_t window) {
+    for (size_t i = 0; i < MAX_POPUPS; i++) {  // NOLINT(altera-unroll-loops)
+        if (xc.popups[i] == window) {
+            return (Surface)(i + 1);
+        }
+    }
+    return DOCK_SURFACE;
+}
+
+static void xc_fill_rect(Surface surface, int x, int y, uint32_t width,
+                          uint32_t height, uint32_t color) {
+    xcb_window_t window = window_of(surface);
+    if (!window) {
+        return;
+    }
+    xcb_change_gc(xc.conn, xc.gc, XCB_GC_FOREGROUND, &color);
+    xcb_rectangle_t rect = { (int16_t)x, (int16_t)y, (uint16_t)width,
+                             (uint16_t)height };
+    xcb_poly_fill_rectangle(xc.conn, window, xc.gc, 1, &rect);
+}
+
+// Boxes are always opaque squares here.
+static bool xc_draw_box(Surface surface, int x, int y, uint32_t size,
+                        uint32_t radius, uint32_t color) {
+    (void)surface;
+    (void)x;
+    (void)y;
+    (void)size;
+    (void)radius;
+    (void)color;
+    return false;
+}
+
+static bool xc_press_box(Surface surface, int x, int y, uint32_t size,
+                         uint32_t shown_size) {
+    (void)surface;
+    (void)x;
+    (void)y;
+    (void)size;
+    (void)shown_size;
+    return false;
+}
+
+static void xc_draw_text(Surface surface, int x, int y, const char *text,
+                          size_t len, uint32_t color) {
+    xcb_window_t window = window_of(surface);
+    if (!window || len == 0) {
+        return;
+    }
+    xcb_change_gc(xc.conn, xc.gc, XCB_GC_FOREGROUND, &color);
+
+    // PolyText8 items are a length byte, a delta byte and the characters.
+    // Unlike ImageText8 it leaves the background untouched, like
+    // XDrawString.
+    if (len > POLY_TEXT_MAX_CHUNK) {
+        len = POLY_TEXT_MAX_CHUNK;
+    }
+    uint8_t items[POLY_TEXT_MAX_CHUNK + 2];
+    items[0] = (uint8_t)len;
+    items[1] = 0;
+    memcpy(items + 2, text, len);
+    xcb_poly_text_8(xc.conn, window, xc.gc, (int16_t)x, (int16_t)y,
+                    (uint32_t)len + 2, items);
+}
+
+// Compute text extents from the font metrics, the equivalent of
+// XTextWidth(). Only the first call waits for the server.
+static TextMetrics xc_text_metrics(const char *text, size_t len) {
+    TextMetrics metrics               = { 0, 0 };
+    const xcb_query_font_reply_t *fnt = font_info();
+    if (!text || !fnt) {
+        return metrics;
+    }
+
+    const xcb_charinfo_t *chars = xcb_query_font_char_infos(fnt);
+    int nchars                  = xcb_query_font_char_infos_length(fnt);
+    for (size_t i = 0; i < len; i++) {  // NOLINT(altera-unroll-loops)
+        unsigned int ch = (unsigned char)text[i];
+        if (nchars == 0) {
+            metrics.width += (uint32_t)fnt->max_bounds.character_width;
+        } else if (ch >= fnt->min_char_or_byte2 &&
+                   ch <= fnt->max_char_or_byte2 &&
+                   (int)(ch - fnt->min_char_or_byte2) < nchars) {
+            metrics.width += (uint32_t)chars[ch - fnt->min_char_or_byte2]
+                                 .character_width;
+        }
+    }
+    metrics.height = (uint32_t)(fnt->font_ascent + fnt->font_descent);
+    return metrics;
+}
+
+// Labels use a core font, which cannot be scaled without loading another
+// one; only the layout follows the scale factor.
+static void xc_set_scale(float scale) {
+    (void)scale;
+}
+
+static void xc_flush(void) {
+    xcb_flush(xc.conn);
+}
+
+// GetInputFocus is the cheapest request with a reply.
+static void xc_sync(void) {
+    free(xcb_get_input_focus_reply(xc.conn, xcb_get_input_focus(xc.conn),
+                                   nullptr));
+}
+
+// Ownership is claimed without a GetSelectionOwner round trip; losing the
+// selection later is reported by a SelectionClear event. Without INCR a
+// text goes out in one property, so a longer one is refused, never cut.
+static bool xc_set_clipboard(const char *text, size_t len) {
+    if (len > CLIPBOARD_MAX_BYTES || len > xc.max_property) {
+        (void)fprintf(stderr,
+                      "The xcb backend cannot copy %zu bytes at once.\n",
+                      len);
+        return false;
+    }
+    char *copy = malloc(len ? len : 1);
+    if (!copy) {
+        return false;
+    }
+    memcpy(copy, text, len);
+    free(xc.clipboard_text);
+    xc.clipboard_text = copy;
+    xc.clipboard_len  = len;
+
+    xcb_set_selection_owner(xc.conn, xc.window, xc.atoms[ATOM_CLIPBOARD],
+                            XCB_CURRENT_TIME);
+    xcb_flush(xc.conn);
+    return true;
+}
+
+// Another client owns the clipboard now; stop serving the text.
+static void handle_selection_clear(const xcb_selection_clear_event_t *clear) {
+    if (clear->owner != xc.window ||
+        clear->selection != xc.atoms[ATOM_CLIPBOARD]) {
+        return;
+    }
+    free(xc.clipboard_text);
+    xc.clipboard_text = nullptr;
+    xc.clipboard_len  = 0;
+}
+
+// Handle clipboard selection requests.
+static void handle_selection_request(
+    const xcb_selection_request_event_t *req) {
+    // Obsolete requestors leave the property out and expect the target.
+    xcb_atom_t property =
+        req->property != XCB_ATOM_NONE ? req->property : req->target;
+
+    xcb_selection_notify_event_t notify;
+    memset(&notify, 0, sizeof(notify));
+    notify.response_type = XCB_SELECTION_NOTIFY;
+    notify.requestor     = req->requestor;
+    notify.selection     = req->selection;
+    notify.target        = req->target;
+    notify.property      = property;
+    notify.time          = req->time;
+
+    xcb_atom_t utf8_string   = xc.atoms[ATOM_UTF8_STRING];
+    xcb_atom_t compound_text = xc.atoms[ATOM_COMPOUND_TEXT];
+    xcb_atom_t targets_atom  = xc.atoms[ATOM_TARGETS];
+
+    if (req->target == targets_atom) {
+        xcb_atom_t supported_targets[] = { targets_atom, XCB_ATOM_STRING,
+                                           utf8_string, compound_text };
+        xcb_change_property(
+            xc.conn, XCB_PROP_MODE_REPLACE, req->requestor, property,
+            XCB_ATOM_ATOM, 32,
+            sizeof(supported_targets) / sizeof(supported_targets[0]),
+            supported_targets);
+    } else if (xc.clipboard_text &&
+               (req->target == XCB_ATOM_STRING ||
+                req->target == utf8_string || req->target == compound_text)) {
+        xcb_change_property(xc.conn, XCB_PROP_MODE_REPLACE, req->requestor,
+                            property, req->target, 8,
+                            (uint32_t)xc.clipboard_len, xc.clipboard_text);
+    } else {
+        notify.property = XCB_ATOM_NONE;
+    }
+    xcb_send_event(xc.conn, 1, req->requestor, XCB_EVENT_MASK_NO_EVENT,
+                   (const char *)&notify);
+}
+
+// Global hotkeys are only implemented for the Xlib backend.
+static size_t xc_grab_hotkeys(const Hotkey *hotkeys, size_t count) {
+    (void)hotkeys;
+    (void)count;
+    return 0;
+}
+
+// The color picker is only implemented for the Xlib backend.
+static bool xc_grab_pointer(bool grab) {
+    (void)grab;
+    return false;
+}
+
+static bool xc_capture(int x, int y, uint32_t width, uint32_t height,
+                      uint32_t *pixels, uint32_t stride) {
+    (void)x;
+    (void)y;
+    (void)width;
+    (void)height;
+    (void)pixels;
+    (void)stride;
+    return false;
+}
+
+// Ownership changes would need the XFixes extension through xcb-xfixes,
+// which the xcb backend does not link.
+static bool xc_watch_clipboard(void) {
+    return false;
+}
+
+static bool xc_read_clipboard(size_t max) {
+    (void)max;
+    return false;
+}
+
+// The dock is drawn straight to its window, so there is no copy of it to
+// read back or to fill.
+static bool xc_read_dock(uint32_t *pixels, uint32_t width, uint32_t height,
+                         uint32_t stride) {
+    (void)pixels;
+    (void)width;
+    (void)height;
+    (void)stride;
+    return false;
+}
+
+static const char *xc_render_tag(void) {
+    return "rgb server core";
+}
+
+static bool xc_put_dock(const uint32_t *pixels, uint32_t width,
+                        uint32_t height, uint32_t stride) {
+    (void)pixels;
+    (void)width;
+    (void)height;
+    (void)stride;
+    return false;
+}
+
+static int xc_event_fd(void) {
+    return xcb_get_file_descriptor(xc.conn);
+}
+
+// MOD_* flags held in a modifier state, with Alt and Super on their usual
+// Mod1 and Mod4.
+static uint32_t dock_modifiers(uint16_t state) {
+    uint32_t modifiers = 0;
+    if (state & XCB_MOD_MASK_SHIFT) {
+        modifiers |= MOD_SHIFT;
+    }
+    if (state & XCB_MOD_MASK_CONTROL) {
+        modifiers |= MOD_CONTROL;
+    }
+    if (state & XCB_MOD_MASK_1) {
+        modifiers |= MOD_ALT;
+    }
+    if (state & XCB_MOD_MASK_4) {
+        modifiers |= MOD_SUPER;
+    }
+    return modifiers;
+}
+
+// Translate an XCB event into a DockEvent. Returns false for events that are
+// handled internally or are of no interest to the dock.
+static bool translate_event(const xcb_generic_event_t *xev,
+                            DockEvent *event) {
+    memset(event, 0, sizeof(*event));
+
+    switch (xev->response_type & ~0x80U) {
+        case XCB_EXPOSE: {
+            const xcb_expose_event_t *ev = (const xcb_expose_event_t *)xev;
+            event->type                  = EVENT_EXPOSE;
+            event->surface               = surface_of(ev->window);
+            return ev->count == 0;
+        }
+
+        case XCB_BUTTON_PRESS:
+        case XCB_BUTTON_RELEASE: {
+            // Press and release events share a layout.
+            const xcb_button_press_event_t *ev =
+                (const xcb_button_press_event_t *)xev;
+            event->type = (xev->response_type & ~0x80U) == XCB_BUTTON_PRESS
+                              ? EVENT_BUTTON_PRESS
+                              : EVENT_BUTTON_RELEASE;
+            event->surface   = surface_of(ev->event);
+            event->button    = ev->detail;
+            event->modifiers = dock_modifiers(ev->state);
+            event->x         = ev->event_x;
+            event->y         = ev->event_y;
+            event->root_x    = ev->root_x;
+            event->root_y    = ev->root_y;
+            return true;
+        }
+
+        case XCB_MOTION_NOTIFY: {
+            const xcb_motion_notify_event_t *ev =
+                (const xcb_motion_notify_event_t *)xev;
+            event->type    = EVENT_MOTION;
+            event->surface = surface_of(ev->event);
+            event->x       = ev->event_x;
+            event->y       = ev->event_y;
+            event->root_x  = ev->root_x;
+            event->root_y  = ev->root_y;
+            return true;
+        }
+
+        case XCB_ENTER_NOTIFY: {
+            const xcb_enter_notify_event_t *ev =
+                (const xcb_enter_notify_event_t *)xev;
+            event->type    = EVENT_ENTER;
+            event->surface = surface_of(ev->event);
+            event->x       = ev->event_x;
+            event->y       = ev->event_y;
+            event->root_x  = ev->root_x;
+            event->root_y  = ev->root_y;
+            return true;
+        }
+
+        case XCB_CONFIGURE_NOTIFY: {
+            // Sizes the dock asked for itself are already in place.
+            const xcb_configure_notify_event_t *ev =
+                (const xcb_configure_notify_event_t *)xev;
+            if (ev->window == xc.screen->root) {
+                xc.screen_width  = ev->width;
+                xc.screen_height = ev->height;
+                event->type      = EVENT_SCREEN_CHANGE;
+                return true;
+            }
+            if (ev->window != xc.window ||
+                (ev->width == xc.width && ev->height == xc.height)) {
+                return false;
+            }
+            event->type   = EVENT_RESIZE;
+            event->width  = ev->width;
+            event->height = ev->height;
+            return true;
+        }
+
+        case XCB_LEAVE_NOTIFY: {
+            const xcb_leave_notify_event_t *ev =
+                (const xcb_leave_notify_event_t *)xev;
+            event->type    = EVENT_LEAVE;
+            event->surface = surface_of(ev->event);
+            return true;
+        }
+
+        case XCB_SELECTION_REQUEST:
+            handle_selection_request(
+                (const xcb_selection_request_event_t *)xev);
+            return false;
+
+        case XCB_SELECTION_CLEAR:
+            handle_selection_clear((const xcb_selection_clear_event_t *)xev);
+            return false;
+
+        case XCB_CLIENT_MESSAGE: {
+            const xcb_client_message_event_t *ev =
+                (const xcb_client_message_event_t *)xev;
+            event->type    = EVENT_CLOSE;
+            event->surface = surface_of(ev->window);
+            return ev->data.data32[0] == xc.atoms[ATOM_WM_DELETE_WINDOW];
+        }
+
+        default:
+            return false;
+    }
+}
+
+static bool xc_next_event(DockEvent *event) {
+    xcb_generic_event_t *xev = nullptr;
+    while ((xev = xcb_poll_for_event(xc.conn))) {  // NOLINT
+        bool wanted = translate_event(xev, event);
+        free(xev);
+        if (wanted) {
+            return true;
+        }
+    }
+
+    // A broken connection is reported as a request to close, the way Xlib
+    // terminates the client on an I/O error.
+    if (xcb_connection_has_error(xc.conn)) {
+        memset(event, 0, sizeof(*event));
+        event->type = EVENT_CLOSE;
+        return true;
+    }
+
+    // Send queued requests before the caller blocks on the socket.
+    xcb_flush(xc.conn);
+    return false;
+}
+
+const Backend xcb_backend = {
+    .name            = "xcb",
+    .open            = xc_open,
+    .close           = xc_close,
+    .monitors        = xc_monitors,
+    .create_window   = xc_create_window,
+    .move_resize     = xc_move_resize,
+    .resize          = xc_resize,
+    .slide           = xc_slide,
+    .open_popup      = xc_open_popup,
+    .close_popup     = xc_close_popup,
+    .move_popup      = xc_move_popup,
+    .fill_rect       = xc_fill_rect,
+    .put_image       = xc_put_image,
+    .draw_box        = xc_draw_box,
+    .press_box       = xc_press_box,
+    .draw_text       = xc_draw_text,
+    .text_metrics    = xc_text_metrics,
+    .set_scale       = xc_set_scale,
+    .flush           = xc_flush,
+    .sync            = xc_sync,
+    .set_clipboard   = xc_set_clipboard,
+    .watch_clipboard = xc_watch_clipboard,
+    .read_clipboard  = xc_read_clipboard,
+    .grab_hotkeys    = xc_grab_hotkeys,
+    .grab_pointer    = xc_grab_pointer,
+    .capture         = xc_capture,
+    .read_dock       = xc_read_dock,
+    .render_tag      = xc_render_tag,
+    .put_dock        = xc_put_dock,
+    .event_fd        = xc_event_fd,
+    .next_event      = xc_next_event,
+};
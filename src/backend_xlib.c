@@ -0,0 +1,1676 @@
+/*
+ * Filename: backend_xlib.c
+ *
+ * Description: Xlib implementation of the platform backend. Owns the X11
+ * display connection, the dock and popup windows, the graphics contexts and
+ * the CLIPBOARD selection. The dock is drawn into a backing pixmap, so
+ * exposures are repaired by copying instead of redrawing the boxes, and
+ * monitors are discovered through XRandR. Text is antialiased through Xft,
+ * which rasterizes each glyph once on the client, uploads it to a server-side
+ * glyph set and then draws a whole label with one XRender composite request.
+ * Optionally the dock is rasterized on the client instead and presented with
+ * one shared-memory put per frame. When a compositing manager is running the
+ * dock uses an ARGB visual and draws translucent, rounded boxes with XRender.
+ * Builds without Xft (make LEAN=1) draw labels with the core font, or the
+ * builtin one in software mode.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "backend_xlib.h"
+
+#include <X11/X.h>
+#include <X11/XKBlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#ifdef HAVE_XFT
+#include <X11/Xft/Xft.h>
+#endif
+#include <X11/cursorfont.h>
+#include <X11/keysym.h>
+#include <X11/extensions/Xfixes.h>
+#include <X11/extensions/Xrandr.h>
+#include <X11/extensions/Xrender.h>
+#include <X11/extensions/sync.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_context.h"
+#include "backend.h"
+#include "box_compositor.h"
+#include "raster.h"
+#include "selection_server.h"
+#include "shm_image.h"
+#include "stats.h"
+#include "x11_atoms.h"
+
+#define MAX_POPUPS 4
+#define MAX_HOTKEYS 32
+#define MAX_KEY_GRABS 64
+#define LOCK_VARIANTS 4  // No lock, Caps Lock, Num Lock, both.
+
+// Label font at a scale of 1. The core font stays as a fallback when Xft
+// cannot open it.
+#define LABEL_FONT_FAMILY "monospace"
+#define LABEL_FONT_PIXELS 12.0
+
+typedef struct {
+    unsigned long flags;
+    unsigned long functions;
+    unsigned long decorations;
+    long input_mode;
+    unsigned long status;
+} Hints;
+
+// Global hints for the window manager (_MOTIF_WM_HINTS).
+static const Hints hints = { 2, 0, 0, 0, 0 };
+
+typedef struct {
+    Window window;
+    GC gc;
+#ifdef HAVE_XFT
+    XftDraw *draw;
+#endif
+    uint32_t width;
+    uint32_t height;
+    ShmImage image;  // Pixels for put_image(), made on the first put.
+} Popup;
+
+// One keycode grabbed for a hotkey, under every lock variant.
+typedef struct {
+    KeyCode keycode;
+    unsigned int mask;     // Modifier state, lock modifiers excluded.
+    uint32_t id;           // Hotkey id.
+    unsigned long serial;  // Request number of the first XGrabKey.
+    bool failed;           // Another client holds the combination.
+} KeyGrab;
+
+// Bounding box of the backing pixmap area not yet copied to the window.
+typedef struct {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+} Damage;
+
+static struct {
+    Display *display;
+    Window window;
+    GC gc;
+    XVisualInfo vinfo;
+    Translucency translucency;
+    bool argb;          // The dock uses a 32-bit ARGB visual.
+    Colormap colormap;  // Colormap for the ARGB visual.
+    Picture picture;    // XRender view of the backing pixmap.
+    BoxCompositor boxes;
+    Pixmap backing;
+#ifdef HAVE_XFT
+    XftDraw *draw;  // Xft target for the backing pixmap.
+    XftFont *font;
+    bool font_pending;  // The font is to be opened at font_scale.
+#endif
+    float font_scale;
+    bool software;      // Rasterize the dock on the client.
+    ShmImage image;     // Client-side dock pixels in software mode.
+    GlyphCache glyphs;  // Label glyphs for software mode.
+    bool glyphs_ready;
+    ShmImage capture;  // Screen pixels read for the color picker.
+    Cursor crosshair;  // Pointer shape while the pointer is grabbed.
+    uint32_t width;
+    uint32_t height;
+    uint32_t shown_width;  // Columns on screen while the dock slides.
+    Damage damage;
+    bool first_expose_seen;
+    bool has_randr;
+    int randr_event_base;
+    bool has_sync;
+    XSyncCounter sync_counter;  // Advertised as _NET_WM_SYNC_REQUEST_COUNTER.
+    XSyncValue sync_value;      // Value the window manager asked for.
+    bool sync_requested;        // A sync request awaits its ConfigureNotify.
+    bool sync_configured;       // ... which has arrived; awaits the layout.
+    bool sync_ready;            // Ack once the next frame is presented.
+    Atom atoms[ATOM_COUNT];
+    Popup popups[MAX_POPUPS];
+    Hotkey hotkeys[MAX_HOTKEYS];  // Combinations to keep grabbed.
+    size_t hotkey_count;
+    KeyGrab grabs[MAX_KEY_GRABS];
+    size_t grab_count;
+    unsigned int lock_mask;  // Caps Lock and Num Lock modifiers.
+    SelectionServer selection;  // CLIPBOARD, set up on the first copy.
+    bool watching;              // Told of CLIPBOARD owner changes by XFixes.
+    int xfixes_event_base;
+    Time owner_time;           // When another client took the CLIPBOARD.
+    bool reading;              // A conversion of the CLIPBOARD is on its way.
+    size_t read_max;           // Longest text it may bring.
+    unsigned char *read_text;  // Text of the last conversion, or nullptr.
+} xl = {};
+
+// Intern an atom on first use. Each miss costs one round trip.
+static Atom atom(AtomId id) {
+    if (!xl.atoms[id]) {
+        xl.atoms[id] = XInternAtom(xl.display, atom_names[id], False);
+        stats_round_trip();
+    }
+    return xl.atoms[id];
+}
+
+// Intern several atoms that are not known yet in a single round trip.
+static void intern_atoms(const AtomId *ids, size_t count) {
+    char *names[ATOM_COUNT];
+    AtomId missing[ATOM_COUNT];
+    int n = 0;
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        if (!xl.atoms[ids[i]]) {
+            missing[n] = ids[i];
+            names[n++] = (char *)atom_names[ids[i]];
+        }
+    }
+    if (n == 0) {
+        return;
+    }
+    Atom atoms[ATOM_COUNT];
+    if (XInternAtoms(xl.display, names, n, False, atoms)) {
+        for (int i = 0; i < n; i++) {  // NOLINT(altera-unroll-loops)
+            xl.atoms[missing[i]] = atoms[i];
+        }
+    }
+    stats_round_trip();
+}
+
+static void add_damage(int x, int y, uint32_t width, uint32_t height) {
+    Damage *d = &xl.damage;
+    if (d->x1 <= d->x0 || d->y1 <= d->y0) {
+        d->x0 = x;
+        d->y0 = y;
+        d->x1 = x + (int)width;
+        d->y1 = y + (int)height;
+        return;
+    }
+    if (x < d->x0) {
+        d->x0 = x;
+    }
+    if (y < d->y0) {
+        d->y0 = y;
+    }
+    if (x + (int)width > d->x1) {
+        d->x1 = x + (int)width;
+    }
+    if (y + (int)height > d->y1) {
+        d->y1 = y + (int)height;
+    }
+}
+
+void xlib_backend_use_software(bool enable) {
+    xl.software = enable;
+}
+
+void xlib_backend_set_translucency(Translucency mode) {
+    xl.translucency = mode;
+}
+
+// Pixel value of an opaque color on the dock's visual.
+static unsigned long dock_pixel(uint32_t color) {
+    return xl.argb ? 0xFF000000UL | color : color;
+}
+
+// Copy the damaged part of the backing pixmap or image to the window.
+static void present_damage(void) {
+    Damage *d = &xl.damage;
+    if (xl.software) {
+        d->x0 = d->x0 < 0 ? 0 : d->x0;
+        d->y0 = d->y0 < 0 ? 0 : d->y0;
+        d->x1 = d->x1 > (int)xl.width ? (int)xl.width : d->x1;
+        d->y1 = d->y1 > (int)xl.height ? (int)xl.height : d->y1;
+        if (d->x1 > d->x0 && d->y1 > d->y0) {
+            shm_image_put(&xl.image, xl.window, xl.gc, d->x0, d->y0,
+                          (uint32_t)(d->x1 - d->x0),
+                          (uint32_t)(d->y1 - d->y0));
+        }
+    } else if (xl.backing && d->x1 > d->x0 && d->y1 > d->y0) {
+        XCopyArea(xl.display, xl.backing, xl.window, xl.gc, d->x0, d->y0,
+                  (unsigned int)(d->x1 - d->x0), (unsigned int)(d->y1 - d->y0),
+                  d->x0, d->y0);
+    }
+    memset(d, 0, sizeof(*d));
+}
+
+// (Re)create the backing pixmap, or the client-side image in software mode,
+// at the window size, cleared to black or to the translucent backdrop.
+static void create_backing(uint32_t width, uint32_t height) {
+    xl.width  = width;
+    xl.height = height;
+    memset(&xl.damage, 0, sizeof(xl.damage));
+    if (xl.software) {
+        shm_image_destroy(&xl.image);
+        if (shm_image_create(&xl.image, xl.display, width, height, true) ==
+            0) {
+            return;
+        }
+        (void)fprintf(stderr, "Software rendering is not supported by this "
+                              "visual, using core requests.\n");
+        xl.software = false;
+    }
+
+    if (xl.picture) {
+        XRenderFreePicture(xl.display, xl.picture);
+        xl.picture = 0;
+    }
+    if (xl.backing) {
+        XFreePixmap(xl.display, xl.backing);
+    }
+    int screen = DefaultScreen(xl.display);
+    int depth  = xl.argb ? xl.vinfo.depth : DefaultDepth(xl.display, screen);
+    xl.backing = XCreatePixmap(xl.display, xl.window, width, height,
+                               (unsigned int)depth);
+    XSetForeground(xl.display, xl.gc, xl.argb ? BOX_BACKDROP_PIXEL : 0);
+    XFillRectangle(xl.display, xl.backing, xl.gc, 0, 0, width, height);
+    if (xl.argb) {
+        xl.picture = XRenderCreatePicture(
+            xl.display, xl.backing,
+            XRenderFindVisualFormat(xl.display, xl.vinfo.visual), 0, nullptr);
+    }
+
+#ifdef HAVE_XFT
+    if (xl.draw) {
+        XftDrawChange(xl.draw, xl.backing);
+    } else {
+        xl.draw = XftDrawCreate(
+            xl.display, xl.backing,
+            xl.argb ? xl.vinfo.visual : DefaultVisual(xl.display, screen),
+            xl.argb ? xl.colormap : DefaultColormap(xl.display, screen));
+    }
+#endif
+}
+
+static int xlib_open(void) {
+    xl.display = XOpenDisplay(nullptr);
+    if (!xl.display) {
+        (void)fprintf(stderr, "Unable to open display.\n");
+        return -1;
+    }
+    int error_base = 0;
+    xl.has_randr =
+        XRRQueryExtension(xl.display, &xl.randr_event_base, &error_base);
+    stats_round_trip();
+    int sync_event_base = 0;
+    int sync_major      = 0;
+    int sync_minor      = 0;
+    xl.has_sync =
+        XSyncQueryExtension(xl.display, &sync_event_base, &error_base) &&
+        XSyncInitialize(xl.display, &sync_major, &sync_minor);
+    stats_round_trip();
+    stats_round_trip();
+    return 0;
+}
+
+static void xlib_close(void) {
+    if (xl.selection.display) {
+        unwatch_event_timer(xl.selection.timer_fd);
+        selection_server_free(&xl.selection);
+    }
+    for (size_t i = 0; i < MAX_POPUPS; i++) {  // NOLINT(altera-unroll-loops)
+        if (xl.popups[i].window) {
+#ifdef HAVE_XFT
+            if (xl.popups[i].draw) {
+                XftDrawDestroy(xl.popups[i].draw);
+                xl.popups[i].draw = nullptr;
+            }
+#endif
+            shm_image_destroy(&xl.popups[i].image);
+            XFreeGC(xl.display, xl.popups[i].gc);
+            XDestroyWindow(xl.display, xl.popups[i].window);
+            xl.popups[i].window = 0;
+        }
+    }
+#ifdef HAVE_XFT
+    if (xl.draw) {
+        XftDrawDestroy(xl.draw);
+        xl.draw = nullptr;
+    }
+#endif
+    shm_image_destroy(&xl.image);
+    shm_image_destroy(&xl.capture);
+    if (xl.crosshair) {
+        XFreeCursor(xl.display, xl.crosshair);
+        xl.crosshair = 0;
+    }
+    glyph_cache_free(&xl.glyphs);
+    xl.glyphs_ready = false;
+    box_compositor_free(&xl.boxes);
+    if (xl.picture) {
+        XRenderFreePicture(xl.display, xl.picture);
+        xl.picture = 0;
+    }
+#ifdef HAVE_XFT
+    if (xl.font) {
+        XftFontClose(xl.display, xl.font);
+        xl.font = nullptr;
+    }
+    xl.font_pending = false;
+#endif
+    xl.font_scale = 0.0F;
+    if (xl.backing) {
+        XFreePixmap(xl.display, xl.backing);
+        xl.backing = 0;
+    }
+    if (xl.gc) {
+        XFreeGC(xl.display, xl.gc);
+        xl.gc = nullptr;
+    }
+    if (xl.sync_counter) {
+        XSyncDestroyCounter(xl.display, xl.sync_counter);
+        xl.sync_counter = 0;
+    }
+    if (xl.window) {
+        XDestroyWindow(xl.display, xl.window);
+        xl.window = 0;
+    }
+    if (xl.argb) {
+        XFreeColormap(xl.display, xl.colormap);
+        xl.argb = false;
+    }
+    if (xl.read_text) {
+        XFree(xl.read_text);
+        xl.read_text = nullptr;
+    }
+    xl.watching = false;
+    xl.reading  = false;
+    if (xl.display) {
+        XCloseDisplay(xl.display);
+        xl.display = nullptr;
+    }
+}
+
+// Refresh rate of a mode in millihertz.
+static uint32_t mode_refresh_mhz(const XRRScreenResources *res, RRMode id) {
+    for (int i = 0; i < res->nmode; i++) {  // NOLINT(altera-unroll-loops)
+        const XRRModeInfo *mode = &res->modes[i];
+        if (mode->id != id || !mode->hTotal || !mode->vTotal) {
+            continue;
+        }
+        return (uint32_t)((uint64_t)mode->dotClock * 1000U /
+                          ((uint64_t)mode->hTotal * mode->vTotal));
+    }
+    return 0;
+}
+
+// The Xft.dpi resource, as set by desktop environments for HiDPI screens, or
+// 0 if it is not set. Resources arrive with the connection setup, so this
+// needs no round trip. The line is looked up directly: XGetDefault() would
+// build a resource database, which loads the Xlib locale tables to do so.
+static double xft_dpi(void) {
+    static const char key[] = "Xft.dpi:";
+    const char *line        = XResourceManagerString(xl.display);
+    while (line && *line) {  // NOLINT(altera-unroll-loops)
+        if (strncmp(line, key, sizeof(key) - 1) == 0) {
+            return strtod(line + sizeof(key) - 1, nullptr);
+        }
+        line = strchr(line, '\n');
+        line = line ? line + 1 : nullptr;
+    }
+    return 0.0;
+}
+
+// One monitor per active CRTC, with the CRTC driving the primary output
+// moved to the front. Xft.dpi takes precedence over the physical size of
+// the outputs when it is set.
+static size_t randr_monitors(Monitor *out, size_t max, double dpi) {
+    Window root             = DefaultRootWindow(xl.display);
+    XRRScreenResources *res = XRRGetScreenResourcesCurrent(xl.display, root);
+    stats_round_trip();
+    if (!res) {
+        return 0;
+    }
+    RROutput primary = XRRGetOutputPrimary(xl.display, root);
+    stats_round_trip();
+
+    size_t count = 0;
+    for (int i = 0; i < res->ncrtc && count < max;  // NOLINT
+         i++) {
+        XRRCrtcInfo *crtc = XRRGetCrtcInfo(xl.display, res, res->crtcs[i]);
+        stats_round_trip();
+        if (!crtc) {
+            continue;
+        }
+        if (crtc->mode == None || crtc->noutput == 0) {
+            XRRFreeCrtcInfo(crtc);
+            continue;
+        }
+
+        Monitor *mon = &out[count];
+        memset(mon, 0, sizeof(*mon));
+        mon->x           = crtc->x;
+        mon->y           = crtc->y;
+        mon->width       = crtc->width;
+        mon->height      = crtc->height;
+        mon->refresh_mhz = mode_refresh_mhz(res, crtc->mode);
+
+        XRROutputInfo *output =
+            XRRGetOutputInfo(xl.display, res, crtc->outputs[0]);
+        stats_round_trip();
+        mon->scale = dpi_scale(dpi);
+        if (output) {
+            (void)snprintf(mon->name, sizeof(mon->name), "%s", output->name);
+            if (dpi <= 0.0) {
+                mon->scale = dpi_scale(
+                    monitor_dpi(crtc->width, (uint32_t)output->mm_width));
+            }
+            XRRFreeOutputInfo(output);
+        }
+
+        bool is_primary = false;
+        for (int o = 0; o < crtc->noutput; o++) {  // NOLINT
+            is_primary = is_primary || crtc->outputs[o] == primary;
+        }
+        if (is_primary && count > 0) {
+            Monitor first = out[0];
+            out[0]        = *mon;
+            *mon          = first;
+        }
+        count++;
+        XRRFreeCrtcInfo(crtc);
+    }
+    XRRFreeScreenResources(res);
+    return count;
+}
+
+static size_t xlib_monitors(Monitor *out, size_t max) {
+    double dpi   = xft_dpi();
+    size_t count = xl.has_randr ? randr_monitors(out, max, dpi) : 0;
+    if (count > 0) {
+        return count;
+    }
+
+    // Without RandR (or with every output off) the screen is one monitor.
+    int screen = DefaultScreen(xl.display);
+    memset(out, 0, sizeof(*out));
+    out->width  = (uint32_t)DisplayWidth(xl.display, screen);
+    out->height = (uint32_t)DisplayHeight(xl.display, screen);
+    if (dpi <= 0.0) {
+        dpi = monitor_dpi(out->width,
+                          (uint32_t)DisplayWidthMM(xl.display, screen));
+    }
+    out->scale = dpi_scale(dpi);
+    (void)snprintf(out->name, sizeof(out->name), "screen");
+    return 1;
+}
+
+// Ask the window manager to keep the dock window above others.
+static void set_above_state(Display *display, Window window) {
+    Atom net_wm_state       = atom(ATOM_NET_WM_STATE);
+    Atom net_wm_state_above = atom(ATOM_NET_WM_STATE_ABOVE);
+
+    XClientMessageEvent xclient;
+    memset(&xclient, 0, sizeof(xclient));
+    xclient.type         = ClientMessage;
+    xclient.window       = window;
+    xclient.message_type = net_wm_state;
+    xclient.format       = 32;
+    xclient.data.l[0]    = 1;
+    xclient.data.l[1]    = (long)net_wm_state_above;
+    xclient.data.l[2]    = 0;
+    xclient.data.l[3]    = 1;
+    xclient.data.l[4]    = 0;
+
+    XSendEvent(display, DefaultRootWindow(display), False,
+               SubstructureRedirectMask | SubstructureNotifyMask,
+               (XEvent *)&xclient);
+}
+
+// Whether to use an ARGB visual. Automatic mode asks whether a compositing
+// manager owns the _NET_WM_CM_Sn selection; without one, translucent pixels
+// would show as garbage. The software path has no alpha channel.
+static bool want_translucency(int screen) {
+    if (xl.software || xl.translucency == TRANSLUCENCY_OFF) {
+        return false;
+    }
+    int event_base = 0;
+    int error_base = 0;
+    bool has_render =
+        XRenderQueryExtension(xl.display, &event_base, &error_base);
+    stats_round_trip();
+    if (!has_render || xl.translucency == TRANSLUCENCY_ON) {
+        return has_render;
+    }
+
+    char name[32];
+    (void)snprintf(name, sizeof(name), "_NET_WM_CM_S%d", screen);
+    Atom cm_selection = XInternAtom(xl.display, name, False);
+    Window owner      = XGetSelectionOwner(xl.display, cm_selection);
+    stats_round_trip();
+    stats_round_trip();
+    return owner != None;
+}
+
+static int xlib_create_window(int x, int y, uint32_t width, uint32_t height) {
+    int screen = DefaultScreen(xl.display);
+
+    // Get visual information: a 32-bit ARGB visual for a translucent dock,
+    // otherwise a 24-bit TrueColor visual.
+    xl.argb = want_translucency(screen) &&
+              XMatchVisualInfo(xl.display, screen, 32, TrueColor, &xl.vinfo);
+    if (!xl.argb &&
+        !XMatchVisualInfo(xl.display, screen, 24, TrueColor, &xl.vinfo)) {
+        (void)fprintf(stderr, "Failed to obtain matching visual info.\n");
+        return -1;
+    }
+
+    if (xl.argb) {
+        // A visual other than the parent's needs its own colormap and an
+        // explicit border pixel.
+        xl.colormap = XCreateColormap(xl.display, DefaultRootWindow(xl.display),
+                                      xl.vinfo.visual, AllocNone);
+        XSetWindowAttributes attrs;
+        attrs.colormap         = xl.colormap;
+        attrs.border_pixel     = 0;
+        attrs.background_pixel = 0;
+        attrs.bit_gravity      = NorthWestGravity;
+        xl.window              = XCreateWindow(
+            xl.display, DefaultRootWindow(xl.display), x, y, width, height, 0,
+            xl.vinfo.depth, InputOutput, xl.vinfo.visual,
+            CWColormap | CWBorderPixel | CWBackPixel | CWBitGravity, &attrs);
+    } else {
+        // Create a simple window at the requested position.
+        xl.window = XCreateSimpleWindow(
+            xl.display, DefaultRootWindow(xl.display), x, y, width, height, 0,
+            BlackPixel(xl.display, screen), BlackPixel(xl.display, screen));
+    }
+    if (!xl.window) {
+        (void)fprintf(stderr, "Failed to create window.\n");
+        return -1;
+    }
+
+    // Keep the left columns in place when the window narrows during a slide.
+    if (!xl.argb) {
+        XSetWindowAttributes attrs;
+        attrs.bit_gravity = NorthWestGravity;
+        XChangeWindowAttributes(xl.display, xl.window, CWBitGravity, &attrs);
+    }
+
+    // Set window properties to remove decorations.
+    Atom hints_atom = atom(ATOM_MOTIF_WM_HINTS);
+    XChangeProperty(xl.display, xl.window, hints_atom, hints_atom, 32,
+                    PropModeReplace, (unsigned char *)&hints, 5);
+
+    // With a sync counter the window manager paces interactive resizes to
+    // the dock, waiting for each frame before sending the next size.
+    Atom protocols[2]  = { atom(ATOM_WM_DELETE_WINDOW) };
+    int protocol_count = 1;
+    if (xl.has_sync) {
+        XSyncValue zero;
+        XSyncIntToValue(&zero, 0);
+        xl.sync_counter = XSyncCreateCounter(xl.display, zero);
+        XChangeProperty(xl.display, xl.window,
+                        atom(ATOM_NET_WM_SYNC_REQUEST_COUNTER), XA_CARDINAL,
+                        32, PropModeReplace,
+                        (unsigned char *)&xl.sync_counter, 1);
+        protocols[protocol_count++] = atom(ATOM_NET_WM_SYNC_REQUEST);
+    }
+    XSetWMProtocols(xl.display, xl.window, protocols, protocol_count);
+
+    // Set the window name.
+    const char *window_name = "Arctic Nord";
+    XChangeProperty(xl.display, xl.window, atom(ATOM_NET_WM_NAME),
+                    atom(ATOM_UTF8_STRING), 8, PropModeReplace,
+                    (unsigned char *)window_name, (int)strlen(window_name));
+
+    // Set class hints.
+    XClassHint *class_hint = XAllocClassHint();
+    if (class_hint) {
+        class_hint->res_name  = "arctic_nord";
+        class_hint->res_class = "ArcticNordDock";
+        XSetClassHint(xl.display, xl.window, class_hint);
+        XFree(class_hint);
+    }
+
+    XSelectInput(xl.display, xl.window,
+                 ExposureMask | ButtonPressMask | ButtonReleaseMask |
+                     PointerMotionMask | EnterWindowMask | LeaveWindowMask |
+                     PropertyChangeMask | StructureNotifyMask);
+    if (xl.has_randr) {
+        XRRSelectInput(xl.display, xl.window, RRScreenChangeNotifyMask);
+    }
+
+    XMapWindow(xl.display, xl.window);
+
+    xl.gc = XCreateGC(xl.display, xl.window, 0, nullptr);
+    if (!xl.gc) {
+        (void)fprintf(stderr, "Failed to create graphics context.\n");
+        XDestroyWindow(xl.display, xl.window);
+        xl.window = 0;
+        return -1;
+    }
+    create_backing(width, height);
+    xl.shown_width = width;
+    if (xl.argb) {
+        box_compositor_init(&xl.boxes, xl.display, xl.window);
+    }
+
+    // Reposition the window and set it always on top.
+    XMoveWindow(xl.display, xl.window, x, y);
+    set_above_state(xl.display, xl.window);
+
+    return 0;
+}
+
+static void xlib_resize(uint32_t width, uint32_t height) {
+    if (width != xl.width || height != xl.height) {
+        create_backing(width, height);
+    }
+    xl.shown_width = width;
+    // The dock draws the new layout before its next flush.
+    if (xl.sync_configured) {
+        xl.sync_configured = false;
+        xl.sync_ready      = true;
+    }
+}
+
+static void xlib_move_resize(int x, int y, uint32_t width, uint32_t height) {
+    XMoveResizeWindow(xl.display, xl.window, x, y, width, height);
+    xlib_resize(width, height);
+}
+
+// The backing pixmap stays at full size while the window narrows around its
+// left columns. Columns uncovered by a wider window are copied from it in the
+// same flush rather than waiting for their exposure.
+static bool xlib_slide(int x, int y, uint32_t shown_width) {
+    if (shown_width == 0 || shown_width > xl.width) {
+        return false;
+    }
+    XMoveResizeWindow(xl.display, xl.window, x, y, shown_width, xl.height);
+    if (shown_width > xl.shown_width) {
+        add_damage((int)xl.shown_width, 0, shown_width - xl.shown_width,
+                   xl.height);
+    }
+    xl.shown_width = shown_width;
+    return true;
+}
+
+static Surface xlib_open_popup(int x, int y, uint32_t width,
+                               uint32_t height) {
+    for (size_t i = 0; i < MAX_POPUPS; i++) {  // NOLINT(altera-unroll-loops)
+        Popup *popup = &xl.popups[i];
+        if (popup->window) {
+            continue;
+        }
+
+        int screen = DefaultScreen(xl.display);
+        XSetWindowAttributes attrs;
+        attrs.override_redirect = True;
+        attrs.background_pixel  = BlackPixel(xl.display, screen);
+
+        popup->window = XCreateWindow(
+            xl.display, DefaultRootWindow(xl.display), x, y, width, height, 1,
+            CopyFromParent, InputOutput, CopyFromParent,
+            CWOverrideRedirect | CWBackPixel, &attrs);
+        popup->gc     = XCreateGC(xl.display, popup->window, 0, nullptr);
+        popup->width  = width;
+        popup->height = height;
+#ifdef HAVE_XFT
+        popup->draw = XftDrawCreate(xl.display, popup->window,
+                                    DefaultVisual(xl.display, screen),
+                                    DefaultColormap(xl.display, screen));
+#endif
+
+        XSelectInput(xl.display, popup->window,
+                     ExposureMask | ButtonPressMask | PointerMotionMask |
+                         LeaveWindowMask);
+
+        XMapRaised(xl.display, popup->window);
+        XFlush(xl.display);
+        return (Surface)(i + 1);
+    }
+    return DOCK_SURFACE;
+}
+
+static void xlib_move_popup(Surface surface, int x, int y) {
+    if (surface != DOCK_SURFACE && surface <= MAX_POPUPS &&
+        xl.popups[surface - 1].window) {
+        XMoveWindow(xl.display, xl.popups[surface - 1].window, x, y);
+    }
+}
+
+static void xlib_close_popup(Surface surface) {
+    if (surface == DOCK_SURFACE || surface > MAX_POPUPS) {
+        return;
+    }
+    Popup *popup = &xl.popups[surface - 1];
+    if (!popup->window) {
+        return;
+    }
+#ifdef HAVE_XFT
+    if (popup->draw) {
+        XftDrawDestroy(popup->draw);
+        popup->draw = nullptr;
+    }
+#endif
+    shm_image_destroy(&popup->image);
+    XFreeGC(xl.display, popup->gc);
+    XUnmapWindow(xl.display, popup->window);
+    XDestroyWindow(xl.display, popup->window);
+    popup->window = 0;
+    popup->gc     = nullptr;
+}
+
+// Resolve a surface to its drawable and graphics context. The dock draws
+// into its backing pixmap.
+static bool lookup_surface(Surface surface, Drawable *window, GC *gc) {
+    if (surface == DOCK_SURFACE) {
+        *window = xl.backing;
+        *gc     = xl.gc;
+    } else if (surface <= MAX_POPUPS && xl.popups[surface - 1].window) {
+        *window = xl.popups[surface - 1].window;
+        *gc     = xl.popups[surface - 1].gc;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static Surface surface_of(Window window) {
+    for (size_t i = 0; i < MAX_POPUPS; i++) {  // NOLINT(altera-unroll-loops)
+        if (xl.popups[i].window == window) {
+            return (Surface)(i + 1);
+        }
+    }
+    return DOCK_SURFACE;
+}
+
+// The label font is opened when text is first measured or drawn, so a dock
+// shown from the render cache does not wait for fontconfig.
+static void open_font(void) {
+#ifdef HAVE_XFT
+    if (!xl.font_pending) {
+        return;
+    }
+    xl.font_pending = false;
+    xl.font         = XftFontOpen(
+        xl.display, DefaultScreen(xl.display), XFT_FAMILY, XftTypeString,
+        LABEL_FONT_FAMILY, XFT_PIXEL_SIZE, XftTypeDouble,
+        LABEL_FONT_PIXELS * xl.font_scale, XFT_ANTIALIAS, XftTypeBool, True,
+        nullptr);
+    if (!xl.font) {
+        (void)fprintf(stderr, "Falling back to the core font.\n");
+    }
+#endif
+}
+
+// Fill the glyph cache for software mode from the Xft font, or from the
+// builtin font if Xft is unavailable. FreeType renders each glyph once.
+static void ensure_glyphs(void) {
+    if (xl.glyphs_ready) {
+        return;
+    }
+    xl.glyphs_ready = true;
+    open_font();
+#ifdef HAVE_XFT
+    FT_Face face = xl.font ? XftLockFace(xl.font) : nullptr;
+#else
+    void *face = nullptr;
+#endif
+    if (!face) {
+        uint32_t scale =
+            xl.font_scale < 1.5F ? 1 : (uint32_t)(xl.font_scale + 0.5F);
+        (void)glyph_cache_init_builtin(&xl.glyphs, scale);
+        return;
+    }
+
+#ifdef HAVE_XFT
+
+    for (int ch = GLYPH_CACHE_FIRST; ch <= GLYPH_CACHE_LAST;  // NOLINT
+         ch++) {
+        if (FT_Load_Char(face, (FT_ULong)ch, FT_LOAD_RENDER) != 0) {
+            continue;
+        }
+        FT_GlyphSlot slot = face->glyph;
+        FT_Bitmap *bitmap = &slot->bitmap;
+        if (bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) {
+            // Only antialiased bitmaps are cached; others keep the advance.
+            (void)glyph_cache_set(&xl.glyphs, (unsigned char)ch, nullptr, 0, 0,
+                                  0, 0, 0, (int)(slot->advance.x >> 6));
+            continue;
+        }
+        (void)glyph_cache_set(&xl.glyphs, (unsigned char)ch, bitmap->buffer,
+                              bitmap->width, bitmap->rows, bitmap->pitch,
+                              slot->bitmap_left, slot->bitmap_top,
+                              (int)(slot->advance.x >> 6));
+    }
+    XftUnlockFace(xl.font);
+    xl.glyphs.ascent  = (uint32_t)xl.font->ascent;
+    xl.glyphs.descent = (uint32_t)xl.font->descent;
+#endif
+}
+
+// Wraps the caller's pixels without copying them; Xlib converts the byte
+// order if the server's differs.
+static void xlib_put_image(Surface surface, int x, int y, uint32_t width,
+                           uint32_t height, const uint32_t *pixels,
+                           uint32_t stride) {
+    if (surface == DOCK_SURFACE || surface > MAX_POPUPS ||
+        !xl.popups[surface - 1].window) {
+        return;
+    }
+
+    // Popups keep a shared image of their size, so redrawing one at the
+    // pointer's pace copies the pixels once and sends nothing but the put.
+    Popup *popup = &xl.popups[surface - 1];
+    if (popup->image.image ||
+        shm_image_create(&popup->image, xl.display, popup->width,
+                         popup->height, true) == 0) {
+        Raster *dst = &popup->image.raster;
+        if (x < 0 || y < 0 || (uint64_t)x + width > dst->width ||
+            (uint64_t)y + height > dst->height) {
+            return;
+        }
+        shm_image_wait(&popup->image);
+        for (uint32_t row = 0; row < height; row++) {  // NOLINT
+            memcpy(dst->pixels + ((size_t)(y + (int)row) * dst->stride) + x,
+                   pixels + ((size_t)row * stride),
+                   (size_t)width * sizeof(uint32_t));
+        }
+        shm_image_put(&popup->image, popup->window, popup->gc, x, y, width,
+                      height);
+        return;
+    }
+
+    int screen    = DefaultScreen(xl.display);
+    XImage *image = XCreateImage(
+        xl.display, DefaultVisual(xl.display, screen),
+        (unsigned int)DefaultDepth(xl.display, screen), ZPixmap, 0,
+        (char *)pixels, width, height, 32, (int)(stride * sizeof(uint32_t)));
+    if (!image) {
+        return;
+    }
+    const uint32_t probe = 1;
+    image->byte_order    = *(const uint8_t *)&probe ? LSBFirst : MSBFirst;
+    if (image->bits_per_pixel == 32) {
+        XPutImage(xl.display, popup->window, popup->gc, image, 0, 0, x, y,
+                  width, height);
+    }
+    image->data = nullptr;
+    XDestroyImage(image);
+}
+
+static void xlib_fill_rect(Surface surface, int x, int y, uint32_t width,
+                           uint32_t height, uint32_t color) {
+    if (surface == DOCK_SURFACE && xl.software) {
+        shm_image_wait(&xl.image);
+        raster_fill_rect(&xl.image.raster, x, y, width, height, color);
+        add_damage(x, y, width, height);
+        return;
+    }
+
+    Drawable window = 0;
+    GC gc           = nullptr;
+    if (!lookup_surface(surface, &window, &gc)) {
+        return;
+    }
+    XSetForeground(xl.display, gc,
+                   surface == DOCK_SURFACE ? dock_pixel(color) : color);
+    XFillRectangle(xl.display, window, gc, x, y, width, height);
+    if (surface == DOCK_SURFACE) {
+        add_damage(x, y, width, height);
+    }
+}
+
+static bool xlib_draw_box(Surface surface, int x, int y, uint32_t size,
+                          uint32_t radius, uint32_t color) {
+    if (surface != DOCK_SURFACE || !xl.argb) {
+        return false;
+    }
+    box_compositor_draw(&xl.boxes, xl.picture, x, y, size, radius, color);
+    add_damage(x, y, size, size);
+    return true;
+}
+
+static bool xlib_press_box(Surface surface, int x, int y, uint32_t size,
+                           uint32_t shown_size) {
+    if (surface != DOCK_SURFACE || !xl.argb ||
+        !box_compositor_press(&xl.boxes, xl.picture, x, y, size,
+                              shown_size)) {
+        return false;
+    }
+    add_damage(x, y, size, size);
+    return true;
+}
+
+#ifdef HAVE_XFT
+static XftDraw *xft_draw_of(Surface surface) {
+    if (surface == DOCK_SURFACE) {
+        return xl.draw;
+    }
+    return surface <= MAX_POPUPS ? xl.popups[surface - 1].draw : nullptr;
+}
+#endif
+
+static void xlib_draw_text(Surface surface, int x, int y, const char *text,
+                           size_t len, uint32_t color) {
+    open_font();
+    if (surface == DOCK_SURFACE && xl.software) {
+        ensure_glyphs();
+        shm_image_wait(&xl.image);
+        raster_draw_glyphs(&xl.image.raster, x, y, &xl.glyphs, text, len,
+                           color);
+        return;
+    }
+
+    Drawable window = 0;
+    GC gc           = nullptr;
+    if (!lookup_surface(surface, &window, &gc)) {
+        return;
+    }
+
+    // Dock labels are drawn over a filled rectangle, which already carries
+    // the damage for this area.
+#ifdef HAVE_XFT
+    XftDraw *draw = xft_draw_of(surface);
+    if (xl.font && draw) {
+        // The dock requires a TrueColor visual, where the pixel value is the
+        // RGB color itself.
+        XftColor xft_color;
+        xft_color.pixel       = surface == DOCK_SURFACE ? dock_pixel(color)
+                                                        : color;
+        xft_color.color.red   = (unsigned short)((color >> 16U & 0xFFU) * 257U);
+        xft_color.color.green = (unsigned short)((color >> 8U & 0xFFU) * 257U);
+        xft_color.color.blue  = (unsigned short)((color & 0xFFU) * 257U);
+        xft_color.color.alpha = 0xFFFF;
+        XftDrawString8(draw, &xft_color, xl.font, x, y, (const FcChar8 *)text,
+                       (int)len);
+        return;
+    }
+#endif
+    XSetForeground(xl.display, gc,
+                   surface == DOCK_SURFACE ? dock_pixel(color) : color);
+    XDrawString(xl.display, window, gc, x, y, text, (int)len);
+}
+
+static TextMetrics xlib_text_metrics(const char *text, size_t len) {
+    TextMetrics metrics = { 0, 0 };
+    if (!text) {
+        return metrics;
+    }
+
+    if (xl.software) {
+        ensure_glyphs();
+        return glyph_cache_metrics(&xl.glyphs, text, len);
+    }
+
+#ifdef HAVE_XFT
+    // Xft measures from its client-side glyph cache, without a round trip.
+    open_font();
+    if (xl.font) {
+        XGlyphInfo extents;
+        XftTextExtents8(xl.display, xl.font, (const FcChar8 *)text, (int)len,
+                        &extents);
+        metrics.width  = (uint32_t)extents.xOff;
+        metrics.height = (uint32_t)(xl.font->ascent + xl.font->descent);
+        return metrics;
+    }
+#endif
+
+    XFontStruct *font_info = XQueryFont(xl.display, XGContextFromGC(xl.gc));
+    stats_round_trip();
+    if (!font_info) {
+        return metrics;
+    }
+
+    metrics.width  = XTextWidth(font_info, text, (int)len);
+    metrics.height = font_info->ascent + font_info->descent;
+    XFreeFontInfo(nullptr, font_info, 0);
+    return metrics;
+}
+
+// Reopen the label font at the new scale, once it is next used. Glyphs
+// already cached for the old size are released with it.
+static void xlib_set_scale(float scale) {
+#ifdef HAVE_XFT
+    if ((xl.font || xl.font_pending) && scale == xl.font_scale) {
+        return;
+    }
+    if (xl.font) {
+        XftFontClose(xl.display, xl.font);
+        xl.font = nullptr;
+    }
+    xl.font_pending = true;
+#else
+    if (scale == xl.font_scale) {
+        return;
+    }
+#endif
+    glyph_cache_free(&xl.glyphs);
+    xl.glyphs_ready = false;
+    xl.font_scale   = scale;
+}
+
+// The frame for the size the window manager asked for is on screen; let it
+// send the next one.
+static void ack_sync(void) {
+    if (xl.sync_ready) {
+        XSyncSetCounter(xl.display, xl.sync_counter, xl.sync_value);
+        xl.sync_ready = false;
+    }
+}
+
+static void xlib_flush(void) {
+    present_damage();
+    ack_sync();
+    XFlush(xl.display);
+}
+
+static void xlib_sync(void) {
+    present_damage();
+    ack_sync();
+    XSync(xl.display, False);
+    shm_image_wait(&xl.image);
+}
+
+static bool xlib_set_clipboard(const char *text, size_t len) {
+    if (!xl.selection.display) {
+        const AtomId ids[] = { ATOM_CLIPBOARD, ATOM_TARGETS, ATOM_UTF8_STRING,
+                               ATOM_COMPOUND_TEXT, ATOM_INCR };
+        intern_atoms(ids, sizeof(ids) / sizeof(ids[0]));
+        SelectionAtoms atoms = { .selection     = atom(ATOM_CLIPBOARD),
+                                 .targets       = atom(ATOM_TARGETS),
+                                 .utf8_string   = atom(ATOM_UTF8_STRING),
+                                 .compound_text = atom(ATOM_COMPOUND_TEXT),
+                                 .incr          = atom(ATOM_INCR) };
+        selection_server_init(&xl.selection, xl.display, xl.window, &atoms);
+        // The dock passes the expiry over; the pump after it drops the
+        // stalled transfer.
+        if (xl.selection.timer_fd >= 0 &&
+            !watch_event_timer(xl.selection.timer_fd)) {
+            (void)fprintf(stderr, "Too many timers for the clipboard.\n");
+        }
+    }
+    if (selection_server_own(&xl.selection, text, len) != 0) {
+        return false;
+    }
+    XFlush(xl.display);
+    return true;
+}
+
+// XFixes reports owner changes as they happen, so nothing is polled and
+// nothing is read until the dock asks.
+static bool xlib_watch_clipboard(void) {
+    int error_base  = 0;
+    bool has_xfixes = XFixesQueryExtension(xl.display, &xl.xfixes_event_base,
+                                           &error_base);
+    stats_round_trip();
+    if (!has_xfixes) {
+        return false;
+    }
+    const AtomId ids[] = { ATOM_CLIPBOARD, ATOM_UTF8_STRING, ATOM_INCR };
+    intern_atoms(ids, sizeof(ids) / sizeof(ids[0]));
+    XFixesSelectSelectionInput(xl.display, xl.window, atom(ATOM_CLIPBOARD),
+                               XFixesSetSelectionOwnerNotifyMask);
+    XFlush(xl.display);
+    xl.watching = true;
+    return true;
+}
+
+// Only UTF8_STRING is asked for, into a property of the same name on the
+// dock window.
+static bool xlib_read_clipboard(size_t max) {
+    if (!xl.watching) {
+        return false;
+    }
+    XConvertSelection(xl.display, atom(ATOM_CLIPBOARD), atom(ATOM_UTF8_STRING),
+                      atom(ATOM_UTF8_STRING), xl.window, xl.owner_time);
+    XFlush(xl.display);
+    xl.reading  = true;
+    xl.read_max = max;
+    return true;
+}
+
+// Read the converted text into the event, at most read_max bytes of it, and
+// delete the property so nothing is left on the dock window. An INCR answer
+// is too long to read; deleting it lets the owner send a first chunk, which
+// is never read, so the owner drops the transfer after its own timeout and
+// the next conversion replaces the chunk.
+static void read_converted(Atom property, DockEvent *event) {
+    Atom type           = None;
+    int format          = 0;
+    unsigned long count = 0;
+    unsigned long after = 0;
+    unsigned char *data = nullptr;
+    long length         = (long)((xl.read_max + 3) / 4);
+
+    int status = XGetWindowProperty(xl.display, xl.window, property, 0, length,
+                                    False, AnyPropertyType, &type, &format,
+                                    &count, &after, &data);
+    stats_round_trip();
+    if (status != Success) {
+        return;
+    }
+    XDeleteProperty(xl.display, xl.window, property);
+    if (type == atom(ATOM_UTF8_STRING) && format == 8 && after == 0 &&
+        count <= xl.read_max) {
+        xl.read_text       = data;
+        event->text        = (const char *)data;
+        event->text_length = count;
+    } else if (data) {
+        XFree(data);
+    }
+}
+
+static bool xlib_grab_pointer(bool grab) {
+    if (!grab) {
+        XUngrabPointer(xl.display, CurrentTime);
+        XFlush(xl.display);
+        return true;
+    }
+    if (!xl.crosshair) {
+        xl.crosshair = XCreateFontCursor(xl.display, XC_crosshair);
+    }
+    int status = XGrabPointer(
+        xl.display, xl.window, False,
+        ButtonPressMask | ButtonReleaseMask | PointerMotionMask, GrabModeAsync,
+        GrabModeAsync, None, xl.crosshair, CurrentTime);
+    stats_round_trip();
+    return status == GrabSuccess;
+}
+
+// The capture image is kept between calls, so following the pointer costs
+// one XShmGetImage per position.
+static bool xlib_capture(int x, int y, uint32_t width, uint32_t height,
+                         uint32_t *pixels, uint32_t stride) {
+    if (xl.capture.raster.width != width ||
+        xl.capture.raster.height != height) {
+        shm_image_destroy(&xl.capture);
+        if (shm_image_create(&xl.capture, xl.display, width, height, true) !=
+            0) {
+            return false;
+        }
+    }
+
+    int screen = DefaultScreen(xl.display);
+    shm_image_get(&xl.capture, DefaultRootWindow(xl.display), x, y,
+                  (uint32_t)DisplayWidth(xl.display, screen),
+                  (uint32_t)DisplayHeight(xl.display, screen));
+    const Raster *src = &xl.capture.raster;
+    for (uint32_t row = 0; row < height; row++) {  // NOLINT
+        const uint32_t *in = src->pixels + ((size_t)row * src->stride);
+        uint32_t *out      = pixels + ((size_t)row * stride);
+        for (uint32_t col = 0; col < width; col++) {  // NOLINT
+            out[col] = in[col] & 0xFFFFFFU;
+        }
+    }
+    return true;
+}
+
+static int catch_grab_error(Display *display, XErrorEvent *error) {
+    (void)display;
+    for (size_t i = 0; i < xl.grab_count; i++) {  // NOLINT
+        KeyGrab *grab = &xl.grabs[i];
+        if (error->serial >= grab->serial &&
+            error->serial < grab->serial + LOCK_VARIANTS) {
+            grab->failed = true;
+        }
+    }
+    return 0;
+}
+
+// X modifier mask of MOD_* flags. XKB says which modifier carries Alt and
+// Super on this keyboard; the usual Mod1 and Mod4 are the fallback.
+static unsigned int x_modifiers(uint32_t modifiers) {
+    unsigned int mask = 0;
+    if (modifiers & MOD_SHIFT) {
+        mask |= ShiftMask;
+    }
+    if (modifiers & MOD_CONTROL) {
+        mask |= ControlMask;
+    }
+    if (modifiers & MOD_ALT) {
+        unsigned int alt = XkbKeysymToModifiers(xl.display, XK_Alt_L);
+        mask |= alt ? alt : Mod1Mask;
+    }
+    if (modifiers & MOD_SUPER) {
+        unsigned int super = XkbKeysymToModifiers(xl.display, XK_Super_L);
+        mask |= super ? super : Mod4Mask;
+    }
+    return mask;
+}
+
+// MOD_* flags held in an X modifier state.
+static uint32_t dock_modifiers(unsigned int state) {
+    uint32_t modifiers = 0;
+    for (uint32_t mod = MOD_SHIFT; mod <= MOD_SUPER;  // NOLINT
+         mod <<= 1U) {
+        if (state & x_modifiers(mod)) {
+            modifiers |= mod;
+        }
+    }
+    return modifiers;
+}
+
+// The lock modifiers a grab is repeated under, so the hotkey works with
+// Caps Lock and Num Lock in any state.
+static void lock_variants(unsigned int locks[LOCK_VARIANTS]) {
+    const unsigned int num_lock = xl.lock_mask & ~(unsigned int)LockMask;
+    locks[0]                    = 0;
+    locks[1]                    = LockMask;
+    locks[2]                    = num_lock;
+    locks[3]                    = LockMask | num_lock;
+}
+
+static void grab_keycode(const Hotkey *hotkey, KeyCode keycode,
+                         unsigned int mask) {
+    if (xl.grab_count == MAX_KEY_GRABS) {
+        return;
+    }
+    unsigned int locks[LOCK_VARIANTS];
+    lock_variants(locks);
+    KeyGrab *grab = &xl.grabs[xl.grab_count++];
+    grab->keycode = keycode;
+    grab->mask    = mask;
+    grab->id      = hotkey->id;
+    grab->serial  = NextRequest(xl.display);
+    grab->failed  = false;
+    for (size_t i = 0; i < LOCK_VARIANTS; i++) {  // NOLINT
+        XGrabKey(xl.display, keycode, mask | locks[i],
+                 DefaultRootWindow(xl.display), False, GrabModeAsync,
+                 GrabModeAsync);
+    }
+}
+
+// (Re)grab every hotkey on each keycode whose base symbol is its keysym, as
+// resolved through XKB, then wait once for any errors.
+static size_t grab_keys(void) {
+    XUngrabKey(xl.display, AnyKey, AnyModifier, DefaultRootWindow(xl.display));
+    xl.grab_count = 0;
+    xl.lock_mask  = LockMask | XkbKeysymToModifiers(xl.display, XK_Num_Lock);
+
+    int min_keycode = 0;
+    int max_keycode = 0;
+    XDisplayKeycodes(xl.display, &min_keycode, &max_keycode);
+    XErrorHandler previous = XSetErrorHandler(catch_grab_error);
+    for (size_t i = 0; i < xl.hotkey_count; i++) {  // NOLINT
+        const Hotkey *hotkey = &xl.hotkeys[i];
+        unsigned int mask    = x_modifiers(hotkey->modifiers);
+        size_t first         = xl.grab_count;
+        for (int code = min_keycode; code <= max_keycode;  // NOLINT
+             code++) {
+            if (XkbKeycodeToKeysym(xl.display, (KeyCode)code, 0, 0) ==
+                hotkey->keysym) {
+                grab_keycode(hotkey, (KeyCode)code, mask);
+            }
+        }
+        KeyCode fallback = XKeysymToKeycode(xl.display, hotkey->keysym);
+        if (xl.grab_count == first && fallback) {
+            grab_keycode(hotkey, fallback, mask);
+        }
+    }
+    XSync(xl.display, False);
+    stats_round_trip();
+    XSetErrorHandler(previous);
+
+    // Drop failed grabs and count the hotkeys left with at least one. A
+    // keycode is dropped when any lock variant fails: keeping the others
+    // would make the hotkey depend on the lock state and take the
+    // combination from its holder whenever Caps Lock or Num Lock is on.
+    unsigned int locks[LOCK_VARIANTS];
+    lock_variants(locks);
+    size_t kept    = 0;
+    size_t grabbed = 0;
+    for (size_t i = 0; i < xl.grab_count; i++) {  // NOLINT
+        if (xl.grabs[i].failed) {
+            // Release whichever lock variants did succeed.
+            for (size_t j = 0; j < LOCK_VARIANTS; j++) {  // NOLINT
+                XUngrabKey(xl.display, xl.grabs[i].keycode,
+                           xl.grabs[i].mask | locks[j],
+                           DefaultRootWindow(xl.display));
+            }
+            continue;
+        }
+        bool counted = false;
+        for (size_t j = 0; j < kept; j++) {  // NOLINT
+            counted = counted || xl.grabs[j].id == xl.grabs[i].id;
+        }
+        grabbed += counted ? 0 : 1;
+        xl.grabs[kept++] = xl.grabs[i];
+    }
+    xl.grab_count = kept;
+    return grabbed;
+}
+
+static size_t xlib_grab_hotkeys(const Hotkey *hotkeys, size_t count) {
+    xl.hotkey_count = count < MAX_HOTKEYS ? count : MAX_HOTKEYS;
+    memcpy(xl.hotkeys, hotkeys, xl.hotkey_count * sizeof(Hotkey));
+    return grab_keys();
+}
+
+static bool match_hotkey(const XKeyEvent *key, DockEvent *event) {
+    unsigned int state = key->state & ~xl.lock_mask &
+                         (ShiftMask | ControlMask | Mod1Mask | Mod2Mask |
+                          Mod3Mask | Mod4Mask | Mod5Mask);
+    for (size_t i = 0; i < xl.grab_count; i++) {  // NOLINT
+        if (xl.grabs[i].keycode == key->keycode &&
+            xl.grabs[i].mask == state) {
+            event->type   = EVENT_HOTKEY;
+            event->hotkey = xl.grabs[i].id;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int xlib_event_fd(void) {
+    return ConnectionNumber(xl.display);
+}
+
+// Translate an X event into a DockEvent. Returns false for events that are
+// handled internally or are of no interest to the dock.
+static bool translate_event(XEvent *xev, DockEvent *event) {
+    memset(event, 0, sizeof(*event));
+    if (xl.read_text) {
+        XFree(xl.read_text);
+        xl.read_text = nullptr;
+    }
+    event->surface = surface_of(xev->xany.window);
+
+    if (shm_image_handle_event(&xl.image, xev)) {
+        return false;
+    }
+    for (size_t i = 0; i < MAX_POPUPS; i++) {  // NOLINT(altera-unroll-loops)
+        if (shm_image_handle_event(&xl.popups[i].image, xev)) {
+            return false;
+        }
+    }
+    if (xl.selection.display &&
+        selection_server_handle_event(&xl.selection, xev)) {
+        return false;
+    }
+    if (xl.watching &&
+        xev->type == xl.xfixes_event_base + XFixesSelectionNotify) {
+        // The dock's own copies need no reading.
+        const XFixesSelectionNotifyEvent *notify =
+            (const XFixesSelectionNotifyEvent *)xev;
+        if (notify->owner == None || notify->owner == xl.window) {
+            return false;
+        }
+        xl.owner_time = notify->selection_timestamp;
+        event->type   = EVENT_CLIPBOARD_OWNER;
+        return true;
+    }
+    if (xl.has_randr &&
+        xev->type == xl.randr_event_base + RRScreenChangeNotify) {
+        XRRUpdateConfiguration(xev);
+        event->type = EVENT_SCREEN_CHANGE;
+        return true;
+    }
+
+    switch (xev->type) {
+        case Expose:
+            // After the first frame, dock exposures are repaired from the
+            // backing pixmap without involving the dock logic.
+            if (event->surface == DOCK_SURFACE && xl.first_expose_seen) {
+                add_damage(xev->xexpose.x, xev->xexpose.y,
+                           (uint32_t)xev->xexpose.width,
+                           (uint32_t)xev->xexpose.height);
+                return false;
+            }
+            event->type = EVENT_EXPOSE;
+            if (xev->xexpose.count != 0) {
+                return false;
+            }
+            if (event->surface == DOCK_SURFACE) {
+                xl.first_expose_seen = true;
+            }
+            return true;
+
+        case ButtonPress:
+        case ButtonRelease:
+            event->type   = xev->type == ButtonPress ? EVENT_BUTTON_PRESS
+                                                     : EVENT_BUTTON_RELEASE;
+            event->button    = xev->xbutton.button;
+            event->modifiers = dock_modifiers(xev->xbutton.state);
+            event->x         = xev->xbutton.x;
+            event->y         = xev->xbutton.y;
+            event->root_x    = xev->xbutton.x_root;
+            event->root_y    = xev->xbutton.y_root;
+            return true;
+
+        case MotionNotify:
+            event->type   = EVENT_MOTION;
+            event->x      = xev->xmotion.x;
+            event->y      = xev->xmotion.y;
+            event->root_x = xev->xmotion.x_root;
+            event->root_y = xev->xmotion.y_root;
+            return true;
+
+        case EnterNotify:
+            event->type   = EVENT_ENTER;
+            event->x      = xev->xcrossing.x;
+            event->y      = xev->xcrossing.y;
+            event->root_x = xev->xcrossing.x_root;
+            event->root_y = xev->xcrossing.y_root;
+            return true;
+
+        case LeaveNotify:
+            event->type = EVENT_LEAVE;
+            return true;
+
+        case KeyPress:
+            return match_hotkey(&xev->xkey, event);
+
+        case SelectionNotify:
+            if (!xl.reading || xev->xselection.requestor != xl.window) {
+                return false;
+            }
+            xl.reading  = false;
+            event->type = EVENT_CLIPBOARD_TEXT;
+            if (xev->xselection.property != None) {
+                read_converted(xev->xselection.property, event);
+            }
+            return true;
+
+        case MappingNotify:
+            // Keycodes may have moved; grab the hotkeys again.
+            XRefreshKeyboardMapping(&xev->xmapping);
+            if (xev->xmapping.request != MappingPointer && xl.hotkey_count) {
+                (void)grab_keys();
+            }
+            return false;
+
+        case ConfigureNotify: {
+            // Sizes the dock asked for itself, including every step of a
+            // slide, are already in place. Others come from the window
+            // manager; until the dock adopts one, exposures of the new area
+            // are repaired from the old backing pixmap.
+            if (xev->xconfigure.window != xl.window) {
+                return false;
+            }
+            bool same = (uint32_t)xev->xconfigure.width == xl.shown_width &&
+                        (uint32_t)xev->xconfigure.height == xl.height;
+            // The counter is set once the frame laid out for the new size
+            // is presented. A size the dock keeps, or one it ignores while
+            // slid away, gets no new layout; the next frame answers it.
+            if (xl.sync_requested) {
+                xl.sync_requested  = false;
+                xl.sync_configured = !same && xl.shown_width == xl.width;
+                xl.sync_ready      = !xl.sync_configured;
+            }
+            if (same) {
+                return false;
+            }
+            event->type   = EVENT_RESIZE;
+            event->width  = (uint32_t)xev->xconfigure.width;
+            event->height = (uint32_t)xev->xconfigure.height;
+            return true;
+        }
+
+        case ClientMessage:
+            if (xl.sync_counter && (Atom)xev->xclient.data.l[0] ==
+                                       xl.atoms[ATOM_NET_WM_SYNC_REQUEST]) {
+                XSyncIntsToValue(&xl.sync_value,
+                                 (unsigned int)xev->xclient.data.l[2],
+                                 (int)xev->xclient.data.l[3]);
+                xl.sync_requested  = true;
+                xl.sync_configured = false;
+                xl.sync_ready      = false;
+                return false;
+            }
+            event->type = EVENT_CLOSE;
+            return (Atom)xev->xclient.data.l[0] ==
+                   xl.atoms[ATOM_WM_DELETE_WINDOW];
+
+        default:
+            return false;
+    }
+}
+
+static bool xlib_next_event(DockEvent *event) {
+    while (XPending(xl.display) > 0) {  // NOLINT(altera-unroll-loops)
+        XEvent xev;
+        XNextEvent(xl.display, &xev);
+        if (translate_event(&xev, event)) {
+            return true;
+        }
+    }
+    if (xl.selection.display) {
+        selection_server_pump(&xl.selection);
+    }
+    if (xl.damage.x1 > xl.damage.x0 || xl.sync_ready) {
+        xlib_flush();
+    }
+    return false;
+}
+
+// The dock as the backing pixmap or the software image holds it: pixel
+// values of the dock's visual, with alpha when it is translucent.
+// Copy width x height pixels between framebuffers of the same size, a row at
+// a time since the strides may differ.
+static void copy_pixels(uint32_t *dst, uint32_t dst_stride,
+                        const uint32_t *src, uint32_t src_stride,
+                        uint32_t width, uint32_t height) {
+    for (uint32_t row = 0; row < height; row++) {  // NOLINT
+        memcpy(dst + ((size_t)row * dst_stride),
+               src + ((size_t)row * src_stride),
+               (size_t)width * sizeof(uint32_t));
+    }
+}
+
+static bool xlib_read_dock(uint32_t *pixels, uint32_t width, uint32_t height,
+                           uint32_t stride) {
+    if (width != xl.width || height != xl.height) {
+        return false;
+    }
+    if (xl.software) {
+        shm_image_wait(&xl.image);
+        copy_pixels(pixels, stride, xl.image.raster.pixels,
+                    xl.image.raster.stride, width, height);
+        return true;
+    }
+    if (!xl.backing) {
+        return false;
+    }
+    XImage *image = XGetImage(xl.display, xl.backing, 0, 0, width, height,
+                              AllPlanes, ZPixmap);
+    stats_round_trip();
+    if (!image) {
+        return false;
+    }
+    bool ok = image->bits_per_pixel == 32;
+    for (uint32_t row = 0; ok && row < height; row++) {  // NOLINT
+        memcpy(pixels + ((size_t)row * stride),
+               image->data + ((size_t)row * (size_t)image->bytes_per_line),
+               (size_t)width * sizeof(uint32_t));
+    }
+    XDestroyImage(image);
+    return ok;
+}
+
+// The font Xft resolves the family to is not looked up, since that is the
+// fontconfig work a cached frame avoids; the boxes redrawn by the render
+// cache's check cover a change of the resolved font.
+static const char *xlib_render_tag(void) {
+    static char tag[64];
+#ifdef HAVE_XFT
+    const char *font = "xft " LABEL_FONT_FAMILY;
+#else
+    const char *font = xl.software ? "builtin" : "core";
+#endif
+    (void)snprintf(tag, sizeof(tag), "%s %s %s %.1f", xl.argb ? "argb" : "rgb",
+                   xl.software ? "software" : "server", font,
+                   LABEL_FONT_PIXELS);
+    return tag;
+}
+
+static bool xlib_put_dock(const uint32_t *pixels, uint32_t width,
+                          uint32_t height, uint32_t stride) {
+    if (width != xl.width || height != xl.height) {
+        return false;
+    }
+    if (xl.software) {
+        shm_image_wait(&xl.image);
+        copy_pixels(xl.image.raster.pixels, xl.image.raster.stride, pixels,
+                    stride, width, height);
+        add_damage(0, 0, width, height);
+        return true;
+    }
+    if (!xl.backing) {
+        return false;
+    }
+    int screen     = DefaultScreen(xl.display);
+    Visual *visual = DefaultVisual(xl.display, screen);
+    int depth      = DefaultDepth(xl.display, screen);
+    if (xl.argb) {
+        visual = xl.vinfo.visual;
+        depth  = xl.vinfo.depth;
+    }
+    XImage *image = XCreateImage(xl.display, visual, (unsigned int)depth,
+                                 ZPixmap, 0, (char *)pixels, width, height, 32,
+                                 (int)(stride * sizeof(uint32_t)));
+    if (!image) {
+        return false;
+    }
+    bool ok = image->bits_per_pixel == 32;
+    if (ok) {
+        XPutImage(xl.display, xl.backing, xl.gc, image, 0, 0, 0, 0, width,
+                  height);
+        add_damage(0, 0, width, height);
+    }
+    image->data = nullptr;
+    XDestroyImage(image);
+    return ok;
+}
+
+const Backend xlib_backend = {
+    .name            = "xlib",
+    .open            = xlib_open,
+    .close           = xlib_close,
+    .monitors        = xlib_monitors,
+    .create_window   = xlib_create_window,
+    .move_resize     = xlib_move_resize,
+    .resize          = xlib_resize,
+    .slide           = xlib_slide,
+    .open_popup      = xlib_open_popup,
+    .close_popup     = xlib_close_popup,
+    .move_popup      = xlib_move_popup,
+    .fill_rect       = xlib_fill_rect,
+    .put_image       = xlib_put_image,
+    .draw_box        = xlib_draw_box,
+    .press_box       = xlib_press_box,
+    .draw_text       = xlib_draw_text,
+    .text_metrics    = xlib_text_metrics,
+    .set_scale       = xlib_set_scale,
+    .flush           = xlib_flush,
+    .sync            = xlib_sync,
+    .set_clipboard   = xlib_set_clipboard,
+    .watch_clipboard = xlib_watch_clipboard,
+    .read_clipboard  = xlib_read_clipboard,
+    .grab_hotkeys    = xlib_grab_hotkeys,
+    .grab_pointer    = xlib_grab_pointer,
+    .capture         = xlib_capture,
+    .read_dock       = xlib_read_dock,
+    .render_tag      = xlib_render_tag,
+    .put_dock        = xlib_put_dock,
+    .event_fd        = xlib_event_fd,
+    .next_event      = xlib_next_event,
+};
@@ -0,0 +1,33 @@
+/*
+ * Filename: backend_xlib.h
+ *
+ * Description: Declarations for options specific to the Xlib backend.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef BACKEND_XLIB_H
+#define BACKEND_XLIB_H
+
+#include "backend.h"
+
+typedef enum {
+    TRANSLUCENCY_AUTO,  // Translucent when a compositing manager is running.
+    TRANSLUCENCY_ON,
+    TRANSLUCENCY_OFF
+} Translucency;
+
+// Choose between a translucent dock with rounded boxes on a 32-bit ARGB
+// visual and the opaque 24-bit dock. Takes effect when the dock window is
+// created.
+void xlib_backend_set_translucency(Translucency mode);
+
+// Rasterize the dock on the client and present the damaged area with one
+// MIT-SHM put (or XPutImage when shared memory is unavailable) instead of
+// sending core drawing requests. Takes effect when the dock window is
+// created.
+void xlib_backend_use_software(bool enable);
+
+#endif  // BACKEND_XLIB_H
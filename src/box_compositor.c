@@ -0,0 +1,191 @@
+/*
+ * Filename: box_compositor.c
+ *
+ * Description: Implements XRender drawing of translucent, rounded color boxes
+ * and the transform-based pressed effect for the Xlib backend.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "box_compositor.h"
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/Xrender.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Subsamples per pixel along each axis when building the corner coverage.
+#define MASK_SUBSAMPLES 4
+
+void box_compositor_init(BoxCompositor *comp, Display *display,
+                         Drawable drawable) {
+    memset(comp, 0, sizeof(*comp));
+    comp->display  = display;
+    comp->drawable = drawable;
+}
+
+static void free_mask(BoxCompositor *comp) {
+    if (comp->mask) {
+        XRenderFreePicture(comp->display, comp->mask);
+        XFreePixmap(comp->display, comp->mask_pixmap);
+        comp->mask        = 0;
+        comp->mask_pixmap = 0;
+    }
+}
+
+static void free_tile(BoxCompositor *comp) {
+    if (comp->tile) {
+        XRenderFreePicture(comp->display, comp->tile);
+        XFreePixmap(comp->display, comp->tile_pixmap);
+        comp->tile        = 0;
+        comp->tile_pixmap = 0;
+        comp->tile_saved  = false;
+    }
+}
+
+void box_compositor_free(BoxCompositor *comp) {
+    if (comp->display) {
+        free_mask(comp);
+        free_tile(comp);
+    }
+    memset(comp, 0, sizeof(*comp));
+}
+
+// Antialiased coverage of a rounded square at one pixel.
+static uint8_t corner_coverage(uint32_t size, uint32_t radius, uint32_t px,
+                               uint32_t py) {
+    double r     = radius;
+    double far   = (double)size - r;
+    uint32_t hit = 0;
+    for (int sy = 0; sy < MASK_SUBSAMPLES; sy++) {    // NOLINT
+        for (int sx = 0; sx < MASK_SUBSAMPLES; sx++) {  // NOLINT
+            double fx = px + ((sx + 0.5) / MASK_SUBSAMPLES);
+            double fy = py + ((sy + 0.5) / MASK_SUBSAMPLES);
+            double dx = fx < r ? r - fx : (fx > far ? fx - far : 0.0);
+            double dy = fy < r ? r - fy : (fy > far ? fy - far : 0.0);
+            hit += (dx * dx) + (dy * dy) <= r * r;
+        }
+    }
+    return (uint8_t)(hit * 255U / (MASK_SUBSAMPLES * MASK_SUBSAMPLES));
+}
+
+// Build the A8 rounded-square mask on the client and upload it once per size.
+static bool ensure_mask(BoxCompositor *comp, uint32_t size, uint32_t radius) {
+    if (comp->mask && comp->mask_size == size &&
+        comp->mask_radius == radius) {
+        return true;
+    }
+    free_mask(comp);
+
+    // Rows of an 8-bit ZPixmap image are padded to 4 bytes.
+    uint32_t stride = (size + 3U) & ~3U;
+    char *data      = calloc((size_t)stride * size, 1);
+    if (!data) {
+        return false;
+    }
+    for (uint32_t py = 0; py < size; py++) {    // NOLINT(altera-unroll-loops)
+        for (uint32_t px = 0; px < size; px++) {  // NOLINT(altera-unroll-loops)
+            data[((size_t)py * stride) + px] =
+                (char)corner_coverage(size, radius, px, py);
+        }
+    }
+
+    comp->mask_pixmap =
+        XCreatePixmap(comp->display, comp->drawable, size, size, 8);
+    XImage *image = XCreateImage(comp->display, nullptr, 8, ZPixmap, 0, data,
+                                 size, size, 32, (int)stride);
+    if (!image) {
+        free(data);
+        XFreePixmap(comp->display, comp->mask_pixmap);
+        comp->mask_pixmap = 0;
+        return false;
+    }
+    GC gc = XCreateGC(comp->display, comp->mask_pixmap, 0, nullptr);
+    XPutImage(comp->display, comp->mask_pixmap, gc, image, 0, 0, 0, 0, size,
+              size);
+    XFreeGC(comp->display, gc);
+    XDestroyImage(image);
+
+    comp->mask = XRenderCreatePicture(
+        comp->display, comp->mask_pixmap,
+        XRenderFindStandardFormat(comp->display, PictStandardA8), 0, nullptr);
+    comp->mask_size   = size;
+    comp->mask_radius = radius;
+    return true;
+}
+
+void box_compositor_draw(BoxCompositor *comp, Picture dst, int x, int y,
+                         uint32_t size, uint32_t radius, uint32_t color) {
+    XRenderColor backdrop = { 0, 0, 0, BOX_BACKDROP_ALPHA };
+    XRenderFillRectangle(comp->display, PictOpSrc, dst, &backdrop, x, y, size,
+                         size);
+    if (!ensure_mask(comp, size, radius)) {
+        return;
+    }
+
+    XRenderColor fill = { (unsigned short)(((color >> 16U) & 0xFFU) * 257U),
+                          (unsigned short)(((color >> 8U) & 0xFFU) * 257U),
+                          (unsigned short)((color & 0xFFU) * 257U), 0xFFFF };
+    Picture source    = XRenderCreateSolidFill(comp->display, &fill);
+    XRenderComposite(comp->display, PictOpOver, source, comp->mask, dst, 0, 0,
+                     0, 0, x, y, size, size);
+    XRenderFreePicture(comp->display, source);
+}
+
+static void set_scale(BoxCompositor *comp, double scale, double offset) {
+    XTransform transform = { {
+        { XDoubleToFixed(scale), 0, XDoubleToFixed(-offset * scale) },
+        { 0, XDoubleToFixed(scale), XDoubleToFixed(-offset * scale) },
+        { 0, 0, XDoubleToFixed(1.0) },
+    } };
+    XRenderSetPictureTransform(comp->display, comp->tile, &transform);
+}
+
+bool box_compositor_press(BoxCompositor *comp, Picture dst, int x, int y,
+                          uint32_t size, uint32_t shown_size) {
+    if (shown_size == size) {
+        if (!comp->tile_saved) {
+            return false;
+        }
+        set_scale(comp, 1.0, 0.0);
+        XRenderComposite(comp->display, PictOpSrc, comp->tile, None, dst, 0, 0,
+                         0, 0, x, y, size, size);
+        comp->tile_saved = false;
+        return true;
+    }
+
+    if (comp->tile && comp->tile_size != size) {
+        free_tile(comp);
+    }
+    if (!comp->tile) {
+        comp->tile_pixmap =
+            XCreatePixmap(comp->display, comp->drawable, size, size, 32);
+        comp->tile = XRenderCreatePicture(
+            comp->display, comp->tile_pixmap,
+            XRenderFindStandardFormat(comp->display, PictStandardARGB32), 0,
+            nullptr);
+        XRenderSetPictureFilter(comp->display, comp->tile, FilterBilinear,
+                                nullptr, 0);
+        comp->tile_size = size;
+    }
+
+    // Keep the unpressed box, then draw it back scaled around its center.
+    // The transform maps destination pixels to source pixels, hence the
+    // inverse scale.
+    set_scale(comp, 1.0, 0.0);
+    XRenderComposite(comp->display, PictOpSrc, dst, None, comp->tile, x, y, 0,
+                     0, 0, 0, size, size);
+    XRenderColor backdrop = { 0, 0, 0, BOX_BACKDROP_ALPHA };
+    XRenderFillRectangle(comp->display, PictOpSrc, dst, &backdrop, x, y, size,
+                         size);
+    set_scale(comp, (double)size / shown_size, (size - shown_size) / 2.0);
+    XRenderComposite(comp->display, PictOpOver, comp->tile, None, dst, 0, 0, 0,
+                     0, x, y, size, size);
+    comp->tile_saved = true;
+    return true;
+}
@@ -0,0 +1,51 @@
+/*
+ * Filename: box_compositor.h
+ *
+ * Description: Declarations for drawing color boxes with XRender on a 32-bit
+ * ARGB dock: rounded boxes over a translucent backdrop, and a pressed effect
+ * made by compositing the box through a scaling Picture transform. All of the
+ * work happens on the server.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef BOX_COMPOSITOR_H
+#define BOX_COMPOSITOR_H
+
+#include <X11/Xlib.h>
+#include <X11/extensions/Xrender.h>
+#include <stdint.h>
+
+// Premultiplied backdrop behind the boxes: black at 75% opacity.
+#define BOX_BACKDROP_PIXEL 0xC0000000UL
+#define BOX_BACKDROP_ALPHA 0xC000
+
+typedef struct {
+    Display *display;
+    Drawable drawable;  // Any drawable on the dock's screen.
+    Pixmap mask_pixmap;
+    Picture mask;  // Rounded-rectangle coverage for one box.
+    uint32_t mask_size;
+    uint32_t mask_radius;
+    Pixmap tile_pixmap;
+    Picture tile;  // Copy of the pressed box as it looked unpressed.
+    uint32_t tile_size;
+    bool tile_saved;
+} BoxCompositor;
+
+void box_compositor_init(BoxCompositor *comp, Display *display,
+                         Drawable drawable);
+void box_compositor_free(BoxCompositor *comp);
+
+// Clear the box area to the backdrop and draw a rounded box over it.
+void box_compositor_draw(BoxCompositor *comp, Picture dst, int x, int y,
+                         uint32_t size, uint32_t radius, uint32_t color);
+
+// Show the box at x, y scaled to shown_size, or restore it when shown_size
+// equals size. Returns false if there is nothing to restore.
+bool box_compositor_press(BoxCompositor *comp, Picture dst, int x, int y,
+                          uint32_t size, uint32_t shown_size);
+
+#endif  // BOX_COMPOSITOR_H
@@ -0,0 +1,315 @@
+/*
+ * Filename: builtin_font.h
+ *
+ * Description: A 7x13 monochrome bitmap font covering printable ASCII, used
+ * by backends that rasterize text on the client side and have no server font
+ * to fall back on. Glyphs were rendered once from DejaVu Sans Mono at 11 px.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef BUILTIN_FONT_H
+#define BUILTIN_FONT_H
+
+#include <stdint.h>
+
+#define BUILTIN_FONT_FIRST 0x20
+#define BUILTIN_FONT_LAST 0x7E
+#define BUILTIN_FONT_WIDTH 7
+#define BUILTIN_FONT_HEIGHT 13
+#define BUILTIN_FONT_ASCENT 10
+
+// One byte per row, most significant bit is the leftmost pixel.
+static const uint8_t
+    builtin_font[BUILTIN_FONT_LAST - BUILTIN_FONT_FIRST + 1]
+                [BUILTIN_FONT_HEIGHT] = {
+    // ' '
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00 },
+    // '!'
+    { 0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x00,
+      0x00, 0x00 },
+    // '"'
+    { 0x00, 0x00, 0x28, 0x28, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00 },
+    // '#'
+    { 0x00, 0x00, 0x14, 0x24, 0x7E, 0x28, 0x28, 0xFC, 0x48, 0x50, 0x00,
+      0x00, 0x00 },
+    // '$'
+    { 0x00, 0x00, 0x10, 0x3C, 0x50, 0x50, 0x38, 0x14, 0x14, 0x78, 0x10,
+      0x10, 0x00 },
+    // '%'
+    { 0x00, 0x00, 0xE0, 0xA0, 0xE4, 0x18, 0x20, 0xDC, 0x14, 0x1C, 0x00,
+      0x00, 0x00 },
+    // '&'
+    { 0x00, 0x00, 0x38, 0x20, 0x20, 0x30, 0x5A, 0x4A, 0x44, 0x3E, 0x00,
+      0x00, 0x00 },
+    // '\''
+    { 0x00, 0x00, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00 },
+    // '('
+    { 0x00, 0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x10,
+      0x00, 0x00 },
+    // ')'
+    { 0x00, 0x20, 0x20, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x20, 0x20,
+      0x00, 0x00 },
+    // '*'
+    { 0x00, 0x00, 0x10, 0x54, 0x38, 0x38, 0x54, 0x10, 0x00, 0x00, 0x00,
+      0x00, 0x00 },
+    // '+'
+    { 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x7C, 0x10, 0x10, 0x00, 0x00,
+      0x00, 0x00 },
+    // ','
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x20,
+      0x00, 0x00 },
+    // '-'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00 },
+    // '.'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00,
+      0x00, 0x00 },
+    // '/'
+    { 0x00, 0x00, 0x04, 0x08, 0x08, 0x10, 0x10, 0x10, 0x20, 0x20, 0x40,
+      0x00, 0x00 },
+    // '0'
+    { 0x00, 0x00, 0x3C, 0x66, 0x42, 0x4A, 0x42, 0x42, 0x66, 0x3C, 0x00,
+      0x00, 0x00 },
+    // '1'
+    { 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00,
+      0x00, 0x00 },
+    // '2'
+    { 0x00, 0x00, 0x3C, 0x42, 0x02, 0x06, 0x0C, 0x18, 0x20, 0x7E, 0x00,
+      0x00, 0x00 },
+    // '3'
+    { 0x00, 0x00, 0x3C, 0x42, 0x02, 0x3C, 0x06, 0x02, 0x42, 0x3C, 0x00,
+      0x00, 0x00 },
+    // '4'
+    { 0x00, 0x00, 0x0C, 0x0C, 0x14, 0x24, 0x64, 0x7E, 0x04, 0x04, 0x00,
+      0x00, 0x00 },
+    // '5'
+    { 0x00, 0x00, 0x7C, 0x40, 0x40, 0x7C, 0x06, 0x02, 0x02, 0x7C, 0x00,
+      0x00, 0x00 },
+    // '6'
+    { 0x00, 0x00, 0x1E, 0x20, 0x40, 0x5C, 0x62, 0x42, 0x42, 0x3C, 0x00,
+      0x00, 0x00 },
+    // '7'
+    { 0x00, 0x00, 0x7E, 0x04, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x00,
+      0x00, 0x00 },
+    // '8'
+    { 0x00, 0x00, 0x3C, 0x42, 0x42, 0x3C, 0x42, 0x42, 0x42, 0x3C, 0x00,
+      0x00, 0x00 },
+    // '9'
+    { 0x00, 0x00, 0x3C, 0x42, 0x42, 0x42, 0x3E, 0x02, 0x04, 0x78, 0x00,
+      0x00, 0x00 },
+    // ':'
+    { 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00,
+      0x00, 0x00 },
+    // ';'
+    { 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10, 0x10, 0x20,
+      0x00, 0x00 },
+    // '<'
+    { 0x00, 0x00, 0x00, 0x00, 0x02, 0x1C, 0x60, 0x38, 0x06, 0x00, 0x00,
+      0x00, 0x00 },
+    // '='
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, 0x00, 0xFC, 0x00, 0x00, 0x00,
+      0x00, 0x00 },
+    // '>'
+    { 0x00, 0x00, 0x00, 0x00, 0x40, 0x38, 0x06, 0x1C, 0x60, 0x00, 0x00,
+      0x00, 0x00 },
+    // '?'
+    { 0x00, 0x00, 0x38, 0x04, 0x0C, 0x18, 0x10, 0x10, 0x00, 0x10, 0x00,
+      0x00, 0x00 },
+    // '@'
+    { 0x00, 0x00, 0x1C, 0x26, 0x42, 0x4E, 0x52, 0x52, 0x4E, 0x60, 0x20,
+      0x1C, 0x00 },
+    // 'A'
+    { 0x00, 0x00, 0x18, 0x18, 0x18, 0x24, 0x24, 0x3C, 0x42, 0x42, 0x00,
+      0x00, 0x00 },
+    // 'B'
+    { 0x00, 0x00, 0x7C, 0x42, 0x42, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x00,
+      0x00, 0x00 },
+    // 'C'
+    { 0x00, 0x00, 0x1C, 0x22, 0x40, 0x40, 0x40, 0x40, 0x22, 0x1C, 0x00,
+      0x00, 0x00 },
+    // 'D'
+    { 0x00, 0x00, 0x78, 0x44, 0x42, 0x42, 0x42, 0x42, 0x44, 0x78, 0x00,
+      0x00, 0x00 },
+    // 'E'
+    { 0x00, 0x00, 0x7E, 0x40, 0x40, 0x7E, 0x40, 0x40, 0x40, 0x7E, 0x00,
+      0x00, 0x00 },
+    // 'F'
+    { 0x00, 0x00, 0x7E, 0x40, 0x40, 0x7E, 0x40, 0x40, 0x40, 0x40, 0x00,
+      0x00, 0x00 },
+    // 'G'
+    { 0x00, 0x00, 0x1C, 0x22, 0x40, 0x40, 0x46, 0x42, 0x22, 0x1C, 0x00,
+      0x00, 0x00 },
+    // 'H'
+    { 0x00, 0x00, 0x42, 0x42, 0x42, 0x7E, 0x42, 0x42, 0x42, 0x42, 0x00,
+      0x00, 0x00 },
+    // 'I'
+    { 0x00, 0x00, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00,
+      0x00, 0x00 },
+    // 'J'
+    { 0x00, 0x00, 0x1C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x44, 0x38, 0x00,
+      0x00, 0x00 },
+    // 'K'
+    { 0x00, 0x00, 0x44, 0x48, 0x50, 0x60, 0x50, 0x48, 0x44, 0x42, 0x00,
+      0x00, 0x00 },
+    // 'L'
+    { 0x00, 0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7E, 0x00,
+      0x00, 0x00 },
+    // 'M'
+    { 0x00, 0x00, 0x42, 0x66, 0x66, 0x5A, 0x5A, 0x42, 0x42, 0x42, 0x00,
+      0x00, 0x00 },
+    // 'N'
+    { 0x00, 0x00, 0x42, 0x62, 0x52, 0x52, 0x4A, 0x4A, 0x46, 0x42, 0x00,
+      0x00, 0x00 },
+    // 'O'
+    { 0x00, 0x00, 0x3C, 0x66, 0x42, 0x42, 0x42, 0x42, 0x66, 0x3C, 0x00,
+      0x00, 0x00 },
+    // 'P'
+    { 0x00, 0x00, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x40, 0x40, 0x40, 0x00,
+      0x00, 0x00 },
+    // 'Q'
+    { 0x00, 0x00, 0x3C, 0x66, 0x42, 0x42, 0x42, 0x42, 0x66, 0x3C, 0x06,
+      0x00, 0x00 },
+    // 'R'
+    { 0x00, 0x00, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x44, 0x42, 0x40, 0x00,
+      0x00, 0x00 },
+    // 'S'
+    { 0x00, 0x00, 0x3C, 0x42, 0x40, 0x78, 0x06, 0x02, 0x42, 0x3C, 0x00,
+      0x00, 0x00 },
+    // 'T'
+    { 0x00, 0x00, 0xFE, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00,
+      0x00, 0x00 },
+    // 'U'
+    { 0x00, 0x00, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x3C, 0x00,
+      0x00, 0x00 },
+    // 'V'
+    { 0x00, 0x00, 0x42, 0x42, 0x24, 0x24, 0x24, 0x18, 0x18, 0x18, 0x00,
+      0x00, 0x00 },
+    // 'W'
+    { 0x00, 0x00, 0x82, 0x92, 0x92, 0xAA, 0x6C, 0x6C, 0x44, 0x44, 0x00,
+      0x00, 0x00 },
+    // 'X'
+    { 0x00, 0x00, 0x42, 0x24, 0x24, 0x18, 0x18, 0x24, 0x24, 0x42, 0x00,
+      0x00, 0x00 },
+    // 'Y'
+    { 0x00, 0x00, 0xC6, 0x44, 0x28, 0x38, 0x10, 0x10, 0x10, 0x10, 0x00,
+      0x00, 0x00 },
+    // 'Z'
+    { 0x00, 0x00, 0x7E, 0x04, 0x04, 0x08, 0x10, 0x30, 0x20, 0x7E, 0x00,
+      0x00, 0x00 },
+    // '['
+    { 0x00, 0x30, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30,
+      0x00, 0x00 },
+    // '\\'
+    { 0x00, 0x00, 0x40, 0x20, 0x20, 0x10, 0x10, 0x10, 0x08, 0x08, 0x04,
+      0x00, 0x00 },
+    // ']'
+    { 0x00, 0x30, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x30,
+      0x00, 0x00 },
+    // '^'
+    { 0x00, 0x00, 0x30, 0x48, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00 },
+    // '_'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0xFE },
+    // '`'
+    { 0x00, 0x10, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00 },
+    // 'a'
+    { 0x00, 0x00, 0x00, 0x00, 0x78, 0x04, 0x3C, 0x44, 0x44, 0x3C, 0x00,
+      0x00, 0x00 },
+    // 'b'
+    { 0x00, 0x40, 0x40, 0x40, 0x78, 0x44, 0x44, 0x44, 0x44, 0x78, 0x00,
+      0x00, 0x00 },
+    // 'c'
+    { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x60, 0x40, 0x40, 0x60, 0x3C, 0x00,
+      0x00, 0x00 },
+    // 'd'
+    { 0x00, 0x04, 0x04, 0x04, 0x3C, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x00,
+      0x00, 0x00 },
+    // 'e'
+    { 0x00, 0x00, 0x00, 0x00, 0x38, 0x44, 0x7C, 0x40, 0x40, 0x3C, 0x00,
+      0x00, 0x00 },
+    // 'f'
+    { 0x00, 0x0C, 0x10, 0x10, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00,
+      0x00, 0x00 },
+    // 'g'
+    { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x04,
+      0x38, 0x00 },
+    // 'h'
+    { 0x00, 0x40, 0x40, 0x40, 0x58, 0x64, 0x44, 0x44, 0x44, 0x44, 0x00,
+      0x00, 0x00 },
+    // 'i'
+    { 0x00, 0x10, 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00,
+      0x00, 0x00 },
+    // 'j'
+    { 0x00, 0x10, 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+      0x60, 0x00 },
+    // 'k'
+    { 0x00, 0x40, 0x40, 0x40, 0x48, 0x50, 0x60, 0x50, 0x48, 0x44, 0x00,
+      0x00, 0x00 },
+    // 'l'
+    { 0x00, 0xE0, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x18, 0x00,
+      0x00, 0x00 },
+    // 'm'
+    { 0x00, 0x00, 0x00, 0x00, 0x7C, 0x54, 0x54, 0x54, 0x54, 0x54, 0x00,
+      0x00, 0x00 },
+    // 'n'
+    { 0x00, 0x00, 0x00, 0x00, 0x58, 0x64, 0x44, 0x44, 0x44, 0x44, 0x00,
+      0x00, 0x00 },
+    // 'o'
+    { 0x00, 0x00, 0x00, 0x00, 0x38, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00,
+      0x00, 0x00 },
+    // 'p'
+    { 0x00, 0x00, 0x00, 0x00, 0x78, 0x44, 0x44, 0x44, 0x44, 0x78, 0x40,
+      0x40, 0x00 },
+    // 'q'
+    { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x04,
+      0x04, 0x00 },
+    // 'r'
+    { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x24, 0x20, 0x20, 0x20, 0x20, 0x00,
+      0x00, 0x00 },
+    // 's'
+    { 0x00, 0x00, 0x00, 0x00, 0x3C, 0x40, 0x70, 0x0C, 0x04, 0x78, 0x00,
+      0x00, 0x00 },
+    // 't'
+    { 0x00, 0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x20, 0x20, 0x38, 0x00,
+      0x00, 0x00 },
+    // 'u'
+    { 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x00,
+      0x00, 0x00 },
+    // 'v'
+    { 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x28, 0x28, 0x28, 0x10, 0x00,
+      0x00, 0x00 },
+    // 'w'
+    { 0x00, 0x00, 0x00, 0x00, 0x82, 0x82, 0x54, 0x54, 0x28, 0x28, 0x00,
+      0x00, 0x00 },
+    // 'x'
+    { 0x00, 0x00, 0x00, 0x00, 0x6C, 0x28, 0x10, 0x10, 0x28, 0x6C, 0x00,
+      0x00, 0x00 },
+    // 'y'
+    { 0x00, 0x00, 0x00, 0x00, 0x44, 0x48, 0x28, 0x28, 0x30, 0x10, 0x20,
+      0x60, 0x00 },
+    // 'z'
+    { 0x00, 0x00, 0x00, 0x00, 0x7C, 0x08, 0x18, 0x30, 0x20, 0x7C, 0x00,
+      0x00, 0x00 },
+    // '{'
+    { 0x00, 0x1C, 0x10, 0x10, 0x10, 0x60, 0x10, 0x10, 0x10, 0x10, 0x1C,
+      0x00, 0x00 },
+    // '|'
+    { 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+      0x10, 0x00 },
+    // '}'
+    { 0x00, 0x70, 0x10, 0x10, 0x10, 0x0C, 0x10, 0x10, 0x10, 0x10, 0x70,
+      0x00, 0x00 },
+    // '~'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x0E, 0x00, 0x00, 0x00,
+      0x00, 0x00 },
+};
+
+#endif  // BUILTIN_FONT_H
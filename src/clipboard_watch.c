@@ -0,0 +1,151 @@
+/*
+ * Filename: clipboard_watch.c
+ *
+ * Description: Implements the clipboard watcher: the pacing of reads after
+ * owner changes, with the timerfd that releases a held-back read, and the
+ * matching of the text read against the palette.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "clipboard_watch.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "app_context.h"
+#include "color_box.h"
+#include "stats.h"
+
+#define NS_PER_MS 1000000ULL
+#define NS_PER_S 1000000000ULL
+
+static struct {
+    bool enabled;
+    int timer_fd;
+    bool reading;      // A read is waiting for its text.
+    bool pending;      // The owner changed since the last read was made.
+    uint64_t read_ns;  // When the last read was made, or 0.
+} cw = { .timer_fd = -1 };
+
+void clipboard_watch_enable(void) {
+    cw.enabled = true;
+}
+
+// Fire once after delay_ns. Zero disarms.
+static void arm_timer(uint64_t delay_ns) {
+    struct itimerspec spec = {
+        .it_value = { .tv_sec  = (time_t)(delay_ns / NS_PER_S),
+                      .tv_nsec = (long)(delay_ns % NS_PER_S) },
+    };
+    (void)timerfd_settime(cw.timer_fd, 0, &spec, nullptr);
+}
+
+// Read the clipboard if it changed and the last read is answered and far
+// enough behind; otherwise wait for whichever comes first of the answer,
+// the end of the interval or the timeout.
+static void advance(void) {
+    uint64_t now_ns     = stats_now_ns();
+    uint64_t since_ns   = now_ns - cw.read_ns;
+    uint64_t timeout_ns = CLIPBOARD_WATCH_TIMEOUT_MS * NS_PER_MS;
+    uint64_t spacing_ns = CLIPBOARD_WATCH_INTERVAL_MS * NS_PER_MS;
+    if (cw.reading && since_ns >= timeout_ns) {
+        cw.reading = false;
+    }
+    if (cw.reading) {
+        arm_timer(timeout_ns - since_ns);
+        return;
+    }
+    if (!cw.pending) {
+        arm_timer(0);
+        return;
+    }
+    if (cw.read_ns && since_ns < spacing_ns) {
+        arm_timer(spacing_ns - since_ns);
+        return;
+    }
+    cw.pending = false;
+    cw.read_ns = now_ns;
+    cw.reading = app.backend->read_clipboard(CLIPBOARD_WATCH_MAX_BYTES);
+    if (cw.reading) {
+        stats.clip_reads++;
+    }
+    arm_timer(cw.reading ? timeout_ns : 0);
+}
+
+// Mark the box nearest to the color in the text, or no box if the text is
+// not a color.
+static void match_text(const char *text, size_t len) {
+    uint32_t color = 0;
+    if (text && nord_parse_color(text, len, &color, nullptr) == 0) {
+        highlight_box(nearest_box(color));
+    } else {
+        highlight_box(nullptr);
+    }
+    app.backend->flush();
+}
+
+void clipboard_watch_install(void) {
+    if (!cw.enabled) {
+        return;
+    }
+    cw.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (cw.timer_fd < 0) {
+        perror("timerfd_create");
+        clipboard_watch_stop();
+        return;
+    }
+    if (!watch_event_timer(cw.timer_fd)) {
+        (void)fprintf(stderr, "Too many timers for the clipboard watcher.\n");
+        clipboard_watch_stop();
+        return;
+    }
+    if (!app.backend->watch_clipboard()) {
+        (void)fprintf(stderr,
+                      "Clipboard watching is not supported by the %s "
+                      "backend.\n",
+                      app.backend->name);
+        clipboard_watch_stop();
+    }
+}
+
+void clipboard_watch_handle(const DockEvent *event) {
+    if (!cw.enabled) {
+        return;
+    }
+    uint64_t start_ns = stats_now_ns();
+    if (event->type == EVENT_CLIPBOARD_OWNER) {
+        stats.clip_changes++;
+        cw.pending = true;
+    } else if (event->type == EVENT_CLIPBOARD_TEXT && cw.reading) {
+        cw.reading = false;
+        stats.clip_bytes += event->text_length;
+        match_text(event->text, event->text_length);
+    }
+    advance();
+    stats_clip(start_ns);
+}
+
+bool clipboard_watch_owns_timer(int fd) {
+    return fd >= 0 && fd == cw.timer_fd;
+}
+
+void clipboard_watch_timer(void) {
+    advance();
+}
+
+void clipboard_watch_stop(void) {
+    if (cw.timer_fd >= 0) {
+        unwatch_event_timer(cw.timer_fd);
+        (void)close(cw.timer_fd);
+        cw.timer_fd = -1;
+    }
+    cw.enabled = false;
+}
@@ -0,0 +1,51 @@
+/*
+ * Filename: clipboard_watch.h
+ *
+ * Description: Declarations for the clipboard watcher. When another client
+ * copies a color, in any format the dock copies, the nearest box is marked.
+ * The backend reports owner changes as they happen, so nothing is polled;
+ * the text is read only after a change, only as UTF-8 and only up to a few
+ * dozen bytes, and reads are spaced out so a client that copies in a loop
+ * costs the dock one small read per interval.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef CLIPBOARD_WATCH_H
+#define CLIPBOARD_WATCH_H
+
+#include "backend.h"
+
+// Longest clipboard text read, in bytes. Every color format fits with room
+// for surrounding blanks; anything longer is not a color and is not read.
+#define CLIPBOARD_WATCH_MAX_BYTES 64U
+
+// Least time between two reads. Changes in between are folded into one read
+// when the interval is over.
+#define CLIPBOARD_WATCH_INTERVAL_MS 100U
+
+// Time after which an owner that has not answered a read is given up on.
+#define CLIPBOARD_WATCH_TIMEOUT_MS 1000U
+
+// Turn the watcher on. It starts when clipboard_watch_install() is called.
+void clipboard_watch_enable(void);
+
+// Ask the backend for owner changes, once the dock window exists.
+void clipboard_watch_install(void);
+
+// Handle EVENT_CLIPBOARD_OWNER and EVENT_CLIPBOARD_TEXT.
+void clipboard_watch_handle(const DockEvent *event);
+
+// Whether an EVENT_TIMER came from the watcher's timer.
+bool clipboard_watch_owns_timer(int fd);
+
+// Make the read that was held back, or give up on an unanswered one, on
+// EVENT_TIMER.
+void clipboard_watch_timer(void);
+
+// Turn the watcher off and release its timer.
+void clipboard_watch_stop(void);
+
+#endif  // CLIPBOARD_WATCH_H
@@ -11,18 +11,56 @@
 
 #include "color_box.h"
 
-#include <X11/Xlib.h>
+#include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "app_context.h"
 #include "context_menu.h"
 #include "dock.h"
+#include "palette_tables.h"
+#include "workers.h"
+
+static_assert(PALETTE_TABLE_LENGTH == PALETTE_LENGTH,
+              "src/nord.palette must list PALETTE_LENGTH colors");
+static_assert(PALETTE_TEXT_SIZE <= CLIPBOARD_BUFFER_SIZE,
+              "palette strings must fit the clipboard buffer");
+static_assert(PALETTE_LENGTH * (NORD_TEXT_SIZE + SELECTION_SEPARATOR_SIZE) <=
+                  CLIPBOARD_TEXT_SIZE,
+              "a selection of every box must fit the clipboard buffer");
 
 static ColorBox color_boxes[PALETTE_LENGTH] = {};
 
 static ColorBox *last_clicked_box = nullptr;
 
+// The colors shown in OKLab, for nearest_box().
+static NordOklab palette_oklab[PALETTE_LENGTH];
+
+// Whether the boxes show the palette transformed by the sliders, which a
+// new layout keeps.
+static bool transformed;
+
+// Texts of boxes whose color was transformed, formatted when first copied
+// and dropped whenever the color changes.
+static struct {
+    char text[NORD_TEXT_SIZE];
+    size_t length;
+    NordFormat format;
+    bool ready;
+} box_texts[PALETTE_LENGTH];
+
+static struct {
+    ColorBox *boxes[PALETTE_LENGTH];  // In the order they were selected.
+    size_t count;
+    char separator[SELECTION_SEPARATOR_SIZE];
+    size_t separator_length;
+} selection = { .separator = "\n", .separator_length = 1 };
+
+// The box nearest to another client's copy, or nullptr.
+static ColorBox *highlight = nullptr;
+
 void set_last_clicked_box(ColorBox *box) {
     last_clicked_box = box;
 }
@@ -35,13 +73,239 @@ ColorBox *get_last_clicked_box(void) {
     return last_clicked_box;
 }
 
+void copy_color(uint32_t color) {
+    char buffer[CLIPBOARD_BUFFER_SIZE];
+    nord_format_color(color, current_format, buffer, sizeof(buffer));
+    set_clipboard(buffer);
+}
+
+// The text of a box in the current format: the generated string while the
+// box shows its palette color, or its own, formatted once.
+static const char *text_of(const ColorBox *box, size_t *length) {
+    size_t index = box_index(box);
+    if (box->color == palette_colors[index]) {
+        *length = palette_text_lengths[current_format][index];
+        return palette_texts[current_format][index];
+    }
+    if (!box_texts[index].ready || box_texts[index].format != current_format) {
+        box_texts[index].length =
+            nord_format_color(box->color, current_format, box_texts[index].text,
+                              sizeof(box_texts[index].text));
+        box_texts[index].format = current_format;
+        box_texts[index].ready  = true;
+    }
+    *length = box_texts[index].length;
+    return box_texts[index].text;
+}
+
+const char *box_text(const ColorBox *box) {
+    size_t length = 0;
+    return text_of(box, &length);
+}
+
+ColorBox *palette_box(size_t index) {
+    return index < PALETTE_LENGTH ? &color_boxes[index] : nullptr;
+}
+
+size_t box_index(const ColorBox *box) {
+    return (size_t)(box - color_boxes);
+}
+
 void copy_color_from_box(const ColorBox *box) {
+    if (box) {
+        size_t length    = 0;
+        const char *text = text_of(box, &length);
+        app.backend->set_clipboard(text, length);
+    }
+}
+
+// Export the given colors under the palette's labels. Colors that are not
+// the built-in palette are formatted into texts first.
+static int export_palette_in(NordWriter *writer, NordExport kind,
+                             NordFormat preferred, const uint32_t *colors,
+                             char (*texts)[NORD_TEXT_SIZE]) {
+    NordFormat format         = nord_export_format(kind, preferred);
+    NordExportPalette palette = { .count        = PALETTE_LENGTH,
+                                  .labels       = palette_labels[0],
+                                  .label_stride = PALETTE_LABEL_SIZE,
+                                  .texts        = palette_texts[format][0],
+                                  .text_stride  = PALETTE_TEXT_SIZE };
+    if (memcmp(colors, palette_colors, sizeof(palette_colors)) != 0) {
+        nord_format_colors(colors, PALETTE_LENGTH, format, texts, nullptr);
+        palette.texts       = texts[0];
+        palette.text_stride = NORD_TEXT_SIZE;
+    }
+    return nord_export(writer, kind, &palette);
+}
+
+static void shown_colors(uint32_t *colors) {
+    for (size_t i = 0; i < PALETTE_LENGTH; i++) {  // NOLINT
+        colors[i] = color_boxes[i].color;
+    }
+}
+
+int export_palette(NordWriter *writer, NordExport kind) {
+    static char texts[PALETTE_LENGTH][NORD_TEXT_SIZE];
+    uint32_t colors[PALETTE_LENGTH];
+    shown_colors(colors);
+    return export_palette_in(writer, kind, current_format, colors, texts);
+}
+
+// A whole-palette export, written on a worker and copied once it is done.
+// The main thread leaves it alone while it runs, and the colors are taken
+// when it starts, so the sliders can go on changing the boxes.
+static struct {
+    char buffer[CLIPBOARD_TEXT_SIZE];
+    uint32_t colors[PALETTE_LENGTH];
+    char texts[PALETTE_LENGTH][NORD_TEXT_SIZE];
+    NordWriter writer;
+    NordExport kind;
+    NordFormat format;
+    int status;
+    bool running;
+} export_job;
+
+static void export_run(void *data) {
+    (void)data;
+    nord_writer_buffer(&export_job.writer, export_job.buffer,
+                       sizeof(export_job.buffer));
+    export_job.status =
+        export_palette_in(&export_job.writer, export_job.kind,
+                          export_job.format, export_job.colors,
+                          export_job.texts);
+}
+
+static bool export_copy(void) {
+    export_job.running = false;
+    if (export_job.status != 0 ||
+        export_job.writer.total >= sizeof(export_job.buffer)) {
+        return false;
+    }
+    return app.backend->set_clipboard(export_job.buffer,
+                                      export_job.writer.total);
+}
+
+static void export_done(void *data) {
+    (void)data;
+    (void)export_copy();
+    app.backend->flush();
+}
+
+bool copy_palette_export(NordExport kind) {
+    if (export_job.running) {
+        return false;
+    }
+    export_job.kind    = kind;
+    export_job.format  = current_format;
+    export_job.running = true;
+    shown_colors(export_job.colors);
+    if (workers_submit(export_run, export_done, nullptr)) {
+        return true;
+    }
+    export_run(nullptr);
+    return export_copy();
+}
+
+void selection_toggle(ColorBox *box) {
     if (!box) {
         return;
     }
-    char buffer[CLIPBOARD_BUFFER_SIZE];
-    format_color(box->color, current_format, buffer, sizeof(buffer));
-    set_clipboard(buffer);
+    if (!box->selected) {
+        selection.boxes[selection.count++] = box;
+        box->selected                      = (uint32_t)selection.count;
+        draw_colorbox(box);
+        return;
+    }
+    // Close the gap and renumber the boxes selected after this one.
+    size_t from   = box->selected - 1;
+    box->selected = 0;
+    draw_colorbox(box);
+    selection.count--;
+    for (size_t i = from; i < selection.count;  // NOLINT(altera-unroll-loops)
+         i++) {
+        selection.boxes[i]           = selection.boxes[i + 1];
+        selection.boxes[i]->selected = (uint32_t)(i + 1);
+        draw_colorbox(selection.boxes[i]);
+    }
+}
+
+void selection_clear(void) {
+    for (size_t i = 0; i < selection.count;  // NOLINT(altera-unroll-loops)
+         i++) {
+        selection.boxes[i]->selected = 0;
+        draw_colorbox(selection.boxes[i]);
+    }
+    selection.count = 0;
+}
+
+size_t selection_count(void) {
+    return selection.count;
+}
+
+void highlight_box(const ColorBox *box) {
+    ColorBox *next = box ? &color_boxes[box_index(box)] : nullptr;
+    if (next == highlight) {
+        return;
+    }
+    if (highlight) {
+        highlight->highlighted = false;
+        draw_colorbox(highlight);
+    }
+    highlight = next;
+    if (next) {
+        next->highlighted = true;
+        draw_colorbox(next);
+    }
+}
+
+const ColorBox *highlighted_box(void) {
+    return highlight;
+}
+
+bool set_selection_separator(const char *text) {
+    size_t len = 0;
+    for (; *text; text++) {  // NOLINT(altera-unroll-loops)
+        if (len + 1 >= sizeof(selection.separator)) {
+            return false;
+        }
+        char ch = *text;
+        if (ch == '\\' && text[1]) {
+            text++;
+            ch = *text == 'n' ? '\n' : *text == 't' ? '\t' : *text;
+        }
+        selection.separator[len++] = ch;
+    }
+    selection.separator[len]   = '\0';
+    selection.separator_length = len;
+    return true;
+}
+
+// The combined text is built from the boxes' strings into one
+// buffer that lives as long as the dock, so a copy allocates nothing.
+bool copy_selection(void) {
+    static char buffer[CLIPBOARD_TEXT_SIZE];
+    if (selection.count == 0) {
+        return false;
+    }
+    size_t len = 0;
+    for (size_t i = 0; i < selection.count;  // NOLINT(altera-unroll-loops)
+         i++) {
+        if (i > 0) {
+            memcpy(buffer + len, selection.separator,
+                   selection.separator_length);
+            len += selection.separator_length;
+        }
+        size_t text_len  = 0;
+        const char *text = text_of(selection.boxes[i], &text_len);
+        memcpy(buffer + len, text, text_len);
+        len += text_len;
+    }
+    return app.backend->set_clipboard(buffer, len);
+}
+
+// Size of a pressed box, which is drawn shrunk.
+static uint32_t pressed_size(void) {
+    return app.rect_size - scaled(5);
 }
 
 void draw_colorbox(const ColorBox *box) {
@@ -52,42 +316,83 @@ void draw_colorbox(const ColorBox *box) {
     uint32_t adjusted_rect_size = app.rect_size;
     uint32_t adjusted_x         = box->x;
     uint32_t adjusted_y         = box->y;
+    uint32_t radius             = scaled(BOX_RADIUS);
 
-    // If the box is clicked, reduce its size to show a "pressed" effect.
-    if (box->is_clicked) {
-        adjusted_rect_size -= 5;
-        adjusted_x += 2;
-        adjusted_y += 2;
-    }
-
-    XClearArea(app.display, app.window, box->x, box->y, app.rect_size,
-               app.rect_size, False);
-
-    XSetForeground(app.display, app.gc, box->color);
+    // Composited boxes are drawn at full size and shrunk afterwards;
+    // otherwise the pressed effect is drawn directly.
+    const Backend *backend = app.backend;
+    bool composited = backend->draw_box(DOCK_SURFACE, (int)box->x, (int)box->y,
+                                        app.rect_size, radius, box->color);
+    if (!composited) {
+        if (box->is_clicked) {
+            adjusted_rect_size = pressed_size();
+            adjusted_x += scaled(2);
+            adjusted_y += scaled(2);
+        }
+        radius = 0;
 
-    XFillRectangle(app.display, app.window, app.gc, adjusted_x, adjusted_y,
-                   adjusted_rect_size, adjusted_rect_size);
+        backend->fill_rect(DOCK_SURFACE, (int)box->x, (int)box->y,
+                           app.rect_size, app.rect_size, BACKGROUND);
+        backend->fill_rect(DOCK_SURFACE, (int)adjusted_x, (int)adjusted_y,
+                           adjusted_rect_size, adjusted_rect_size, box->color);
+    }
 
     TextMetrics label_metrics  = get_text_metrics(box->label);
     uint32_t label_width       = label_metrics.width;
-    uint32_t label_rect_width  = label_width + PADDING;
-    uint32_t label_rect_height = label_metrics.height + PADDING;
-    uint32_t label_rect_x      = adjusted_x;
-    uint32_t label_rect_y = adjusted_y + adjusted_rect_size - label_rect_height;
+    uint32_t padding           = scaled(PADDING);
+    uint32_t label_rect_width  = label_width + padding;
+    uint32_t label_rect_height = label_metrics.height + padding;
+    uint32_t label_rect_x      = adjusted_x + radius;
+    uint32_t label_rect_y =
+        adjusted_y + adjusted_rect_size - radius - label_rect_height;
     if (label_rect_y < adjusted_y) {
         label_rect_y      = adjusted_y;
         label_rect_height = adjusted_rect_size;
     }
-    XSetForeground(app.display, app.gc, BACKGROUND);
-    XFillRectangle(app.display, app.window, app.gc, label_rect_x, label_rect_y,
-                   label_rect_width, label_rect_height);
+    backend->fill_rect(DOCK_SURFACE, (int)label_rect_x, (int)label_rect_y,
+                       label_rect_width, label_rect_height, BACKGROUND);
 
-    XSetForeground(app.display, app.gc, nord6);
-    uint32_t text_x = label_rect_x + 2;
+    uint32_t text_x = label_rect_x + scaled(2);
     uint32_t text_y =
         label_rect_y + ((label_rect_height + label_metrics.height) / 2);
-    XDrawString(app.display, app.window, app.gc, text_x, text_y, box->label,
-                (int)strlen(box->label));
+    backend->draw_text(DOCK_SURFACE, (int)text_x, (int)text_y, box->label,
+                       box->label_length, NORD6);
+
+    // Selected boxes show their position in the selection in the opposite
+    // corner, in inverted colors.
+    if (box->selected) {
+        char mark[4];
+        size_t mark_length  = (size_t)snprintf(mark, sizeof(mark), "%u",
+                                               (unsigned int)box->selected);
+        TextMetrics metrics = backend->text_metrics(mark, mark_length);
+        uint32_t mark_w     = metrics.width + padding;
+        uint32_t mark_h     = metrics.height + padding;
+        uint32_t mark_x     = adjusted_x + adjusted_rect_size - radius - mark_w;
+        uint32_t mark_y     = adjusted_y + radius;
+        backend->fill_rect(DOCK_SURFACE, (int)mark_x, (int)mark_y, mark_w,
+                           mark_h, NORD6);
+        backend->draw_text(DOCK_SURFACE, (int)(mark_x + scaled(2)),
+                           (int)(mark_y + ((mark_h + metrics.height) / 2)),
+                           mark, mark_length, BACKGROUND);
+    }
+
+    // The box nearest to another client's copy shows a dot in the corner
+    // left free by the label and the selection mark.
+    if (box->highlighted) {
+        uint32_t dot    = scaled(HIGHLIGHT_DOT);
+        uint32_t border = scaled(1);
+        int dot_x       = (int)(adjusted_x + radius + scaled(2));
+        int dot_y       = (int)(adjusted_y + radius + scaled(2));
+        backend->fill_rect(DOCK_SURFACE, dot_x, dot_y, dot + (2 * border),
+                           dot + (2 * border), BACKGROUND);
+        backend->fill_rect(DOCK_SURFACE, dot_x + (int)border,
+                           dot_y + (int)border, dot, dot, NORD6);
+    }
+
+    if (composited && box->is_clicked) {
+        backend->press_box(DOCK_SURFACE, (int)box->x, (int)box->y,
+                           app.rect_size, pressed_size());
+    }
 }
 
 void draw_all_boxes(void) {
@@ -98,20 +403,11 @@ void draw_all_boxes(void) {
 }
 
 TextMetrics get_text_metrics(const char *text) {
-    TextMetrics metrics = { 0, 0 };
     if (!text) {
+        TextMetrics metrics = { 0, 0 };
         return metrics;
     }
-
-    XFontStruct *font_info = XQueryFont(app.display, XGContextFromGC(app.gc));
-    if (!font_info) {
-        return metrics;
-    }
-
-    metrics.width  = XTextWidth(font_info, text, (int)strlen(text));
-    metrics.height = font_info->ascent + font_info->descent;
-    XFreeFontInfo(nullptr, font_info, 0);
-    return metrics;
+    return app.backend->text_metrics(text, strlen(text));
 }
 
 bool is_point_inside_box(uint32_t x, uint32_t y, const ColorBox *box) {
@@ -133,31 +429,84 @@ ColorBox *find_box(uint32_t x, uint32_t y) {
     return nullptr;
 }
 
-void colorbox_on_release(ColorBox *box) {
-    if (!box) {
+const ColorBox *nearest_box(uint32_t color) {
+    return &color_boxes[nord_nearest(palette_oklab, PALETTE_LENGTH,
+                                     nord_rgb_to_oklab(color))];
+}
+
+// Switch the pressed effect, letting the backend transform the box that is
+// already on screen when it can.
+static void set_pressed(ColorBox *box, bool pressed) {
+    if (!box || box->is_clicked == pressed) {
         return;
     }
-    box->is_clicked = false;
+    box->is_clicked = pressed;
+    if (!app.backend->press_box(DOCK_SURFACE, (int)box->x, (int)box->y,
+                                app.rect_size,
+                                pressed ? pressed_size() : app.rect_size)) {
+        draw_colorbox(box);
+    }
+}
+
+void colorbox_on_click(ColorBox *box) {
+    set_pressed(box, true);
+}
+
+void colorbox_on_release(ColorBox *box) {
+    set_pressed(box, false);
 }
 
 void initialize_color_boxes(void) {
-    const uint32_t colors[PALETTE_LENGTH] = { nord0,  nord1,  nord2,  nord3,
-                                              nord4,  nord5,  nord6,  nord7,
-                                              nord8,  nord9,  nord10, nord11,
-                                              nord12, nord13, nord14, nord15 };
-    const char *labels[PALETTE_LENGTH]    = {
-        "nord0",  "nord1",  "nord2",  "nord3", "nord4",  "nord5",
-        "nord6",  "nord7",  "nord8",  "nord9", "nord10", "nord11",
-        "nord12", "nord13", "nord14", "nord15"
-    };
-
-    const uint32_t box_y_start = PADDING;
+    const uint32_t padding = scaled(PADDING);
+    const uint32_t columns = app.columns ? app.columns : 1;
+    const uint32_t rows    = (PALETTE_LENGTH + columns - 1) / columns;
+    const uint32_t step    = app.rect_size + padding;
     for (uint8_t i = 0; i < PALETTE_LENGTH;  // NOLINT(altera-unroll-loops)
          i++) {
-        color_boxes[i].x          = PADDING;
-        color_boxes[i].y          = box_y_start + i * (app.rect_size + PADDING);
-        color_boxes[i].color      = colors[i];
-        color_boxes[i].label      = labels[i];
-        color_boxes[i].is_clicked = false;
+        color_boxes[i].x            = padding + ((i / rows) * step);
+        color_boxes[i].y            = padding + ((i % rows) * step);
+        color_boxes[i].color        = transformed ? color_boxes[i].color
+                                                  : palette_colors[i];
+        color_boxes[i].label        = palette_labels[i];
+        color_boxes[i].label_length = palette_label_lengths[i];
+        color_boxes[i].is_clicked   = false;
+    }
+    if (!transformed) {
+        nord_rgb_to_oklab_n(palette_colors, PALETTE_LENGTH, palette_oklab);
+    }
+}
+
+static bool is_identity(const NordTransform *transform) {
+    return transform->hue == 0.0F && transform->lightness == 1.0F &&
+           transform->chroma == 1.0F && transform->temperature == 0.0F;
+}
+
+size_t transform_palette(const NordTransform *transform) {
+    static NordOklab base[PALETTE_LENGTH];
+    static bool base_ready;
+    if (!base_ready) {
+        nord_rgb_to_oklab_n(palette_colors, PALETTE_LENGTH, base);
+        base_ready = true;
+    }
+    uint32_t colors[PALETTE_LENGTH];
+    if (is_identity(transform)) {
+        memcpy(colors, palette_colors, sizeof(colors));
+    } else {
+        nord_transform_n(base, PALETTE_LENGTH, transform, colors);
+    }
+    transformed = !is_identity(transform);
+
+    size_t changed = 0;
+    for (size_t i = 0; i < PALETTE_LENGTH; i++) {  // NOLINT
+        if (color_boxes[i].color != colors[i]) {
+            color_boxes[i].color = colors[i];
+            box_texts[i].ready   = false;
+            draw_colorbox(&color_boxes[i]);
+            changed++;
+        }
+    }
+    if (changed) {
+        nord_rgb_to_oklab_n(colors, PALETTE_LENGTH, palette_oklab);
     }
+    return changed;
 }
@@ -13,27 +13,24 @@
 #ifndef COLOR_BOX_H
 #define COLOR_BOX_H
 
+#include <stddef.h>
 #include <stdint.h>
 
-// Color definitions from the Arctic Nord palette.
-#define nord0 0x2E3440
-#define nord1 0x3B4252
-#define nord2 0x434C5E
-#define nord3 0x4C566A
-#define nord4 0xD8DEE9
-#define nord5 0xE5E9F0
-#define nord6 0xECEFF4
-#define nord7 0x8FBCBB
-#define nord8 0x88C0D0
-#define nord9 0x81A1C1
-#define nord10 0x5E81AC
-#define nord11 0xBF616A
-#define nord12 0xD08770
-#define nord13 0xEBCB8B
-#define nord14 0xA3BE8C
-#define nord15 0xB48EAD
-
-#define PALETTE_LENGTH 16
+#include "arctic_nord.h"
+#include "arctic_nord_export.h"
+#include "backend.h"
+
+#define PALETTE_LENGTH NORD_PALETTE_LENGTH
+
+// Corner radius of composited boxes, in 96 DPI pixels.
+#define BOX_RADIUS 6
+
+// Side of the dot on the box nearest to another client's copy, in 96 DPI
+// pixels.
+#define HIGHLIGHT_DOT 6
+
+// Longest separator between the colors of a selection copy, with its NUL.
+#define SELECTION_SEPARATOR_SIZE 16
 
 // Represents a single color box.
 typedef struct ColorBox {
@@ -41,25 +38,28 @@ typedef struct ColorBox {
     uint32_t y;
     uint32_t color;
     const char *label;
+    size_t label_length;
     bool is_clicked;
+    uint32_t selected;  // Position in the selection, from 1, or 0.
+    bool highlighted;   // Nearest to the color another client copied.
 } ColorBox;
 
-// Represents the dimensions of rendered text.
-typedef struct {
-    uint32_t width;
-    uint32_t height;
-} TextMetrics;
-
 void initialize_color_boxes(void);
 
 void draw_all_boxes(void);
 void draw_colorbox(const ColorBox *box);
 
 ColorBox *find_box(uint32_t x, uint32_t y);
+// The box for the given palette entry, nord0 first, or nullptr.
+ColorBox *palette_box(size_t index);
+// The palette entry of a box.
+size_t box_index(const ColorBox *box);
+// The box whose color looks closest to the given one, measured in OKLab.
+const ColorBox *nearest_box(uint32_t color);
 bool is_point_inside_box(uint32_t x, uint32_t y, const ColorBox *box);
 TextMetrics get_text_metrics(const char *text);
 
-// Mouse interaction event handlers.
+// Mouse interaction event handlers. They show or remove the pressed effect.
 void colorbox_on_click(ColorBox *box);
 void colorbox_on_release(ColorBox *box);
 
@@ -68,6 +68,49 @@ void set_last_clicked_box(ColorBox *box);
 ColorBox *get_last_clicked_box(void);
 void clear_last_clicked_box(void);
 
+// The box's color in the current format. The strings of the built-in
+// palette are generated at build time, so copying a box does no formatting;
+// a box whose color was transformed formats its string once, when it is
+// first asked for.
+const char *box_text(const ColorBox *box);
+
+// Show the palette changed by the transform, or the palette itself for the
+// identity transform. Only the boxes whose color changes are redrawn, and
+// their strings are formatted again when next copied. Returns the number
+// of boxes redrawn.
+size_t transform_palette(const NordTransform *transform);
+
+void copy_color(uint32_t color);
 void copy_color_from_box(const ColorBox *box);
 
+// The selection: boxes Ctrl+clicked one after another, which are copied
+// together in the order they were added. Toggling a box adds it, or takes it
+// out if it is selected, and redraws the boxes whose position changed.
+void selection_toggle(ColorBox *box);
+void selection_clear(void);
+size_t selection_count(void);
+
+// Mark the box nearest to the color another client copied, or clear the
+// mark with nullptr. Only the boxes whose mark changes are redrawn.
+void highlight_box(const ColorBox *box);
+const ColorBox *highlighted_box(void);
+
+// Set the text put between the colors of a selection copy. The escapes \n,
+// \t and \\ are decoded. Returns false if the text is too long.
+bool set_selection_separator(const char *text);
+
+// Copy the selected colors in the current format, joined by the separator,
+// taking clipboard ownership once. Returns false if nothing is selected or
+// the copy was refused.
+bool copy_selection(void);
+
+// Export the colors shown, in the current format where the exporter takes
+// any notation. Returns 0 on success or -1 with errno set, as nord_export().
+int export_palette(NordWriter *writer, NordExport kind);
+// Copy a whole-palette export. It is written on a worker and copied once
+// it is done, or written at once if no worker can take it. Returns false if
+// an export is already running, or if an export written at once did not fit
+// the clipboard or was refused.
+bool copy_palette_export(NordExport kind);
+
 #endif  // COLOR_BOX_H
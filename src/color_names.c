@@ -0,0 +1,209 @@
+/*
+ * Filename: color_names.c
+ *
+ * Description: Implements color naming over the generated name tables and
+ * the name tip popup shown while the pointer is over a box. The indexes and
+ * the names of the boxes are built by idle tasks after the first frame; a
+ * lookup that comes first builds what it needs itself.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "color_names.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "app_context.h"
+#include "arctic_nord_index.h"
+#include "context_menu.h"
+#include "idle.h"
+#include "name_tables.h"
+
+static NordIndexNode name_nodes[NAME_COLOR_COUNT];
+static NordIndex name_indexes[NAME_TABLE_COUNT];
+static bool indexed[NAME_TABLE_COUNT];
+
+// Names of the boxes in the chosen table, in palette order, and the colors
+// they were looked up for.
+static struct {
+    ColorName name;
+    uint32_t color;
+    bool ready;
+} box_names[PALETTE_LENGTH];
+
+static struct {
+    size_t table;  // Table the dock names colors from.
+    bool disabled;
+} names;
+
+static struct {
+    Surface surface;  // DOCK_SURFACE while no tip is shown.
+    const ColorBox *box;
+    ColorName name;
+    uint32_t width;
+    uint32_t height;
+} tip;
+
+bool color_names_select(const char *title) {
+    if (strcmp(title, "off") == 0) {
+        names.disabled = true;
+        return true;
+    }
+    for (size_t i = 0; i < NAME_TABLE_COUNT; i++) {  // NOLINT
+        if (strcmp(title, name_table_titles[i]) == 0) {
+            names.table    = i;
+            names.disabled = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool color_names_enabled(void) {
+    return !names.disabled;
+}
+
+static void build_index(size_t table) {
+    if (!indexed[table]) {
+        uint32_t start = name_table_starts[table];
+        nord_index_build(&name_indexes[table], &name_colors[start],
+                         name_table_starts[table + 1] - start,
+                         &name_nodes[start]);
+        indexed[table] = true;
+    }
+}
+
+// Idle task: one table per step, the chosen one first.
+static bool index_step(void *data) {
+    (void)data;
+    build_index(names.table);
+    for (size_t i = 0; i < NAME_TABLE_COUNT; i++) {  // NOLINT
+        if (!indexed[i]) {
+            build_index(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Idle task: the name of one box.
+static bool box_name_step(void *data) {
+    (void)box_name(palette_box((size_t)(uintptr_t)data));
+    return true;
+}
+
+void color_names_init(void) {
+    (void)idle_queue(index_step, nullptr, IDLE_NO_BOX);
+    if (names.disabled) {
+        return;
+    }
+    for (size_t i = 0; i < PALETTE_LENGTH; i++) {  // NOLINT
+        (void)idle_queue(box_name_step, (void *)(uintptr_t)i, (int)i);
+    }
+}
+
+size_t color_names_tables(void) {
+    return NAME_TABLE_COUNT;
+}
+
+const char *color_names_title(size_t table) {
+    return table < NAME_TABLE_COUNT ? name_table_titles[table] : "";
+}
+
+ColorName color_name_in(size_t table, uint32_t color) {
+    if (table >= NAME_TABLE_COUNT) {
+        return (ColorName){ .name = "", .color = color };
+    }
+    build_index(table);
+    if (name_indexes[table].count == 0) {
+        return (ColorName){ .name = "", .color = color };
+    }
+    size_t entry = name_table_starts[table] +
+                   nord_index_nearest(&name_indexes[table],
+                                      nord_rgb_to_oklab(color));
+    return (ColorName){ .name  = name_labels[entry],
+                        .color = name_colors[entry] };
+}
+
+ColorName color_name(uint32_t color) {
+    return color_name_in(names.table, color);
+}
+
+ColorName box_name(const ColorBox *box) {
+    size_t index = box_index(box);
+    if (!box_names[index].ready || box_names[index].color != box->color) {
+        box_names[index].name  = color_name(box->color);
+        box_names[index].color = box->color;
+        box_names[index].ready = true;
+    }
+    return box_names[index].name;
+}
+
+// A swatch of the named color, then its name.
+static void draw_tip(void) {
+    const Backend *backend = app.backend;
+    uint32_t pad           = scaled(NAME_TIP_PADDING);
+    uint32_t swatch        = tip.height - (2 * pad);
+    size_t len             = strlen(tip.name.name);
+
+    backend->fill_rect(tip.surface, 0, 0, tip.width, tip.height, BLACK);
+    backend->fill_rect(tip.surface, (int)pad, (int)pad, swatch, swatch,
+                       tip.name.color);
+    backend->draw_text(tip.surface, (int)((2 * pad) + swatch),
+                       (int)(tip.height - pad), tip.name.name, len, WHITE);
+    backend->flush();
+}
+
+void name_tip_hide(void) {
+    if (tip.surface != DOCK_SURFACE) {
+        app.backend->close_popup(tip.surface);
+        app.backend->flush();
+    }
+    tip.surface = DOCK_SURFACE;
+    tip.box     = nullptr;
+}
+
+void name_tip_show(const ColorBox *box, int dock_x, int dock_y) {
+    if (!box || names.disabled) {
+        name_tip_hide();
+        return;
+    }
+    if (box == tip.box) {
+        return;
+    }
+    name_tip_hide();
+
+    const Backend *backend = app.backend;
+    tip.name               = box_name(box);
+    size_t len             = strlen(tip.name.name);
+    TextMetrics metrics    = backend->text_metrics(tip.name.name, len);
+    uint32_t pad           = scaled(NAME_TIP_PADDING);
+    uint32_t swatch        = metrics.height;
+    tip.height             = swatch + (2 * pad);
+    tip.width              = (3 * pad) + swatch + metrics.width;
+
+    // Left of the dock, centered on the box.
+    int x = dock_x - (int)scaled(NAME_TIP_OFFSET) - (int)tip.width;
+    int y = dock_y + (int)box->y +
+            (((int)app.rect_size - (int)tip.height) / 2);
+
+    tip.surface = backend->open_popup(x, y, tip.width, tip.height);
+    if (tip.surface != DOCK_SURFACE) {
+        tip.box = box;
+        draw_tip();
+    }
+}
+
+bool name_tip_handle_event(const DockEvent *event) {
+    if (tip.surface == DOCK_SURFACE || event->surface != tip.surface) {
+        return false;
+    }
+    if (event->type == EVENT_EXPOSE) {
+        draw_tip();
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+/*
+ * Filename: color_names.h
+ *
+ * Description: Declarations for naming colors after the nearest entry of a
+ * color name table (CSS, X11 and, when built with them, the xkcd names), and
+ * for the name tip that shows the name of the box under the pointer. Each
+ * table is indexed by a k-d tree in OKLab, built once while the dock is idle,
+ * so a lookup takes well under a microsecond.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef COLOR_NAMES_H
+#define COLOR_NAMES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "backend.h"
+#include "color_box.h"
+
+// Name tip layout, in 96 DPI pixels.
+#define NAME_TIP_PADDING 4
+#define NAME_TIP_OFFSET 6  // Gap between the tip and the dock.
+
+typedef struct {
+    const char *name;
+    uint32_t color;  // The named color, 0xRRGGBB.
+} ColorName;
+
+// Choose the table the dock names colors from by its title, such as "x11",
+// or "off" to name nothing. Returns false if no table has the title.
+bool color_names_select(const char *title);
+
+// Whether the dock names colors; on unless turned off.
+bool color_names_enabled(void);
+
+// Queue idle tasks that build the index of every table and name every box.
+// Called once at startup; lookups made before the tasks have run build what
+// they need.
+void color_names_init(void);
+
+// Number of tables built in, and the title of each.
+size_t color_names_tables(void);
+const char *color_names_title(size_t table);
+
+// The nearest named color in the given table, or in the chosen one.
+ColorName color_name_in(size_t table, uint32_t color);
+ColorName color_name(uint32_t color);
+
+// The name of a box's color in the chosen table, looked up once for each
+// color the box shows.
+ColorName box_name(const ColorBox *box);
+
+// Show the name of the box next to it, replacing any tip shown, or hide
+// the tip when box is nullptr. dock_x and dock_y are the screen position of
+// the dock's top-left corner.
+void name_tip_show(const ColorBox *box, int dock_x, int dock_y);
+void name_tip_hide(void);
+
+// Consume the event if it belongs to the tip's popup.
+bool name_tip_handle_event(const DockEvent *event);
+
+#endif  // COLOR_NAMES_H
@@ -2,7 +2,7 @@
  * Filename: context_menu.h
  *
  * Description: Declarations for the context menu functionality, including
- * constants, color formatting, and menu layout definitions.
+ * constants and menu layout definitions.
  *
  * Author: Michael Knap
  * Date: 2025-02-13
@@ -16,34 +16,29 @@
 #include <stdint.h>
 
 #include "color_box.h"
+#include "arctic_nord.h"
+#include "arctic_nord_export.h"
 
-// Menu layout constants
+// Menu layout constants, in 96 DPI pixels
 #define MENU_ITEM_HEIGHT 20
 #define MENU_ITEM_PADDING 5
 #define MENU_WIDTH 80
 
+// The formats, then the whole-palette exporters.
+#define MENU_ITEM_COUNT (NORD_FORMAT_COUNT + NORD_EXPORT_COUNT)
+
 // Context menu colors
 #define LIGHT_GREY 0xCCCCCC
 #define DARK_GREY 0x555555
+#define BLACK 0x000000
+#define WHITE 0xFFFFFF
 
-// Supported output formats in order.
-typedef enum {
-    FORMAT_HTML_HEX,  // "#RRGGBB"
-    FORMAT_RAW_HEX,   // "0xaabbcc"
-    FORMAT_CSS_RGB,   // "rgb(R, G, B)"
-    FORMAT_CSS_RGBA,  // "rgba(R, G, B, 1)"
-    FORMAT_HSL,       // "hsl(H, S%, L%)"
-    FORMAT_FLOAT,     // "0.54f, 0.22f, 0.44f"
-    FORMAT_VEC3,      // "vec3(0.54f, 0.22f, 0.44f)"
-    FORMAT_VEC4,      // "vec4(0.54f, 0.22f, 0.44f, 1.00f)"
-    FORMAT_COUNT
-} ColorFormat;
-
-extern ColorFormat current_format;
-
-void format_color(uint32_t color, ColorFormat format, char *buf,
-                  size_t buf_size);
+// Format used for copying, chosen from the menu.
+extern NordFormat current_format;
 
+// Show the menu and wait for a choice. Returns the chosen item: a NordFormat
+// below NORD_FORMAT_COUNT, otherwise NORD_FORMAT_COUNT plus a NordExport.
+// Returns -1 if the menu was dismissed.
 int context_menu_show(int x, int y);
 
 #endif  // CONTEXT_MENU_H
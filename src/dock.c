@@ -9,191 +9,477 @@
  * License: MIT
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "dock.h"
 
-#include <X11/X.h>
-#include <X11/Xatom.h>
-#include <X11/Xlib.h>
-#include <X11/Xutil.h>
-#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "app_context.h"
+#include "autohide.h"
+#include "backend.h"
+#include "clipboard_watch.h"
 #include "color_box.h"
+#include "color_names.h"
 #include "context_menu.h"
+#include "eyedropper.h"
+#include "gradient_builder.h"
+#include "hotkeys.h"
+#include "idle.h"
+#include "mem_report.h"
+#include "palette_shm.h"
+#include "palette_sliders.h"
+#include "render_cache.h"
+#include "stats.h"
+#include "workers.h"
+
+float scale_override = 0.0F;
+
+static uint32_t benchmark_redraws = 0;
+static uint32_t benchmark_busy_s  = 0;
+
+// Box size the monitor gives a single column, which labels are sized for.
+static uint32_t natural_rect_size = 1;
+
+// Resizes are applied once the window manager has been quiet for
+// RESIZE_SETTLE_MS, so a drag rebuilds the dock once rather than per step.
+static struct {
+    int timer_fd;
+    uint32_t width;
+    uint32_t height;
+} resize = { .timer_fd = -1 };
+
+// Box the left button went down on; releasing it over another box builds a
+// gradient between the two.
+static ColorBox *drag_from = nullptr;
+
+// Set by the first expose, which shows the first frame and starts the work
+// that follows it; later exposes only redraw.
+static bool first_frame_shown = false;
+
+void dock_benchmark_redraws(uint32_t count) {
+    benchmark_redraws = count;
+}
+
+// Redraw the whole dock repeatedly, waiting for the server each time so the
+// timings include its work, then exit.
+static void run_redraw_benchmark(void) {
+    for (uint32_t i = 0; i < benchmark_redraws;  // NOLINT(altera-unroll-loops)
+         i++) {
+        uint64_t start_ns = stats_now_ns();
+        draw_all_boxes();
+        app.backend->sync();
+        stats_redraw(start_ns);
+    }
+    cleanup_dock();
+    exit(EXIT_SUCCESS);  // NOLINT(concurrency-mt-unsafe)
+}
+
+void dock_benchmark_busy(uint32_t seconds) {
+    benchmark_busy_s = seconds;
+}
+
+// Spin on a worker until the given time, standing in for a heavy job such
+// as quantizing an image.
+static void busy_job(void *data) {
+    uint64_t end_ns = *(const uint64_t *)data;
+    while (stats_now_ns() < end_ns) {  // NOLINT(altera-unroll-loops)
+    }
+}
 
-// Global hints for the window manager (_MOTIF_WM_HINTS).
-const Hints hints = { 2, 0, 0, 0, 0 };
+static void busy_job_done(void *data) {
+    (void)data;
+    cleanup_dock();
+    exit(EXIT_SUCCESS);  // NOLINT(concurrency-mt-unsafe)
+}
 
-// Increase the clipboard buffer size to accommodate longer strings.
-static char clipboard_text[CLIPBOARD_BUFFER_SIZE] = {};
+// Own the clipboard so there is something to paste, then keep a worker busy
+// while the main loop goes on serving it.
+static void run_busy_benchmark(void) {
+    static uint64_t end_ns;
+    end_ns = stats_now_ns() + ((uint64_t)benchmark_busy_s * 1000000000U);
+    copy_color_from_box(palette_box(0));
+    app.backend->flush();
+    if (!workers_submit(busy_job, busy_job_done, &end_ns)) {
+        (void)fprintf(stderr, "Cannot start a worker.\n");
+        busy_job_done(nullptr);
+    }
+    benchmark_busy_s = 0;
+}
 
-static Atom wm_delete;
+// Size the boxes and the dock from the height and scale of its monitor.
+static void compute_layout(const Monitor *monitor) {
+    app.scale = scale_override > 0.0F ? scale_override : monitor->scale;
+    if (app.scale < 1.0F) {
+        app.scale = 1.0F;
+    }
+    app.backend->set_scale(app.scale);
+
+    uint32_t padding = scaled(PADDING);
+    app.rect_size =
+        (uint32_t)((monitor->height - (DOCK_HEIGHT_MARGIN * monitor->height)) /
+                   PALETTE_LENGTH);
+    app.rect_size     = app.rect_size ? app.rect_size : 1;
+    natural_rect_size = app.rect_size;
+    app.columns       = 1;
+    app.dock_width    = 2 * padding + app.rect_size;
+    app.dock_height   = PALETTE_LENGTH * (app.rect_size + padding) + padding;
+}
 
-int initialize_dock(Display *display, uint32_t dock_width,
-                    uint32_t dock_height) {
-    app.display     = display;
-    app.dock_width  = dock_width;
-    app.dock_height = dock_height;
+// Fit the boxes to a window size chosen by the user: of every column count,
+// keep the one giving the largest boxes, and the fewest columns on ties.
+// Labels follow the box size in quarter steps, so the font is only reopened
+// when the boxes change noticeably.
+static void fit_layout(uint32_t width, uint32_t height) {
+    uint32_t padding = scaled(PADDING);
+    uint32_t best    = 0;
+    app.columns      = 1;
+    for (uint32_t columns = 1;  // NOLINT(altera-unroll-loops)
+         columns <= PALETTE_LENGTH; columns++) {
+        uint32_t rows = (PALETTE_LENGTH + columns - 1) / columns;
+        if (width <= padding * (columns + 1) ||
+            height <= padding * (rows + 1)) {
+            continue;
+        }
+        uint32_t across = (width - (padding * (columns + 1))) / columns;
+        uint32_t down   = (height - (padding * (rows + 1))) / rows;
+        uint32_t size   = across < down ? across : down;
+        if (size > best) {
+            best        = size;
+            app.columns = columns;
+        }
+    }
+    app.rect_size   = best ? best : 1;
+    app.dock_width  = width;
+    app.dock_height = height;
+
+    float ratio = (float)app.rect_size / (float)natural_rect_size;
+    float steps = (float)(uint32_t)((ratio * 4.0F) + 0.5F) / 4.0F;
+    if (steps < MIN_LABEL_SCALE) {
+        steps = MIN_LABEL_SCALE;
+    } else if (steps > MAX_LABEL_SCALE) {
+        steps = MAX_LABEL_SCALE;
+    }
+    app.backend->set_scale(app.scale * steps);
+}
 
-    int screen = DefaultScreen(app.display);
+// Right edge of the monitor, centered vertically.
+static int dock_x(void) {
+    return app.monitor.x + (int)(app.monitor.width - app.dock_width);
+}
 
-    // Get visual information (we request a 24-bit TrueColor visual)
-    if (!XMatchVisualInfo(app.display, screen, 24, TrueColor, &app.vinfo)) {
-        (void)fprintf(stderr, "Failed to obtain matching visual info.\n");
-        return -1;
+static int dock_y(void) {
+    return app.monitor.y + ((int)app.monitor.height - (int)app.dock_height) / 2;
+}
+
+bool select_monitor(const char *spec) {
+    Monitor monitors[MAX_MONITORS];
+    size_t count = app.backend->monitors(monitors, MAX_MONITORS);
+
+    size_t chosen = 0;
+    if (spec) {
+        char *end           = nullptr;
+        unsigned long index = strtoul(spec, &end, 10);
+        if (end != spec && *end == '\0') {
+            chosen = index;
+        } else {
+            for (chosen = 0; chosen < count;  // NOLINT(altera-unroll-loops)
+                 chosen++) {
+                if (strcmp(monitors[chosen].name, spec) == 0) {
+                    break;
+                }
+            }
+        }
+    }
+    if (chosen >= count) {
+        return false;
     }
+    app.monitor = monitors[chosen];
+    return true;
+}
 
-    // Create a simple window at the right side of the screen.
-    app.window = XCreateSimpleWindow(
-        app.display, DefaultRootWindow(app.display),
-        DisplayWidth(app.display, screen) - app.dock_width,
-        (int)((DisplayHeight(app.display, screen) - app.dock_height) / 2),
-        app.dock_width, app.dock_height, 0, BlackPixel(app.display, screen),
-        BlackPixel(app.display, screen));
-    if (!app.window) {
-        (void)fprintf(stderr, "Failed to create window.\n");
+int initialize_dock(void) {
+    compute_layout(&app.monitor);
+    if (app.backend->create_window(dock_x(), dock_y(), app.dock_width,
+                                   app.dock_height) != 0) {
         return -1;
     }
+    (void)autohide_place(dock_x(), dock_y());
+    return 0;
+}
+
+static void arm_resize_timer(uint64_t ms) {
+    struct itimerspec spec = {
+        .it_value = { .tv_sec  = (time_t)(ms / 1000U),
+                      .tv_nsec = (long)((ms % 1000U) * 1000000U) },
+    };
+    (void)timerfd_settime(resize.timer_fd, 0, &spec, nullptr);
+}
 
-    // Set window properties to remove decorations.
-    Atom hints_atom = XInternAtom(app.display, "_MOTIF_WM_HINTS", False);
-    XChangeProperty(app.display, app.window, hints_atom, hints_atom, 32,
-                    PropModeReplace, (unsigned char *)&hints, 5);
-
-    wm_delete = XInternAtom(app.display, "WM_DELETE_WINDOW", False);
-    XSetWMProtocols(app.display, app.window, &wm_delete, 1);
-
-    // Set the window name.
-    const char *window_name = "Arctic Nord";
-    XChangeProperty(app.display, app.window,
-                    XInternAtom(app.display, "_NET_WM_NAME", False),
-                    XInternAtom(app.display, "UTF8_STRING", False), 8,
-                    PropModeReplace, (unsigned char *)window_name,
-                    (int)strlen(window_name));
-
-    // Set class hints.
-    XClassHint *class_hint = XAllocClassHint();
-    if (class_hint) {
-        class_hint->res_name  = "arctic_nord";
-        class_hint->res_class = "ArcticNordDock";
-        XSetClassHint(app.display, app.window, class_hint);
-        XFree(class_hint);
+// Lay the boxes out for the settled window size and redraw them. This is
+// the only place a user resize rebuilds the backend's backing store and the
+// label font.
+static void apply_resize(void) {
+    if (resize.width == app.dock_width && resize.height == app.dock_height) {
+        return;
     }
+    name_tip_hide();
+    fit_layout(resize.width, resize.height);
+    app.backend->resize(app.dock_width, app.dock_height);
+    clear_last_clicked_box();
+    initialize_color_boxes();
+    draw_all_boxes();
+    app.backend->flush();
+}
 
-    XSelectInput(app.display, app.window,
-                 ExposureMask | ButtonPressMask | ButtonReleaseMask |
-                     PointerMotionMask | PropertyChangeMask);
+// Note the latest size of a resize burst and restart the quiet period. Until
+// it ends, the window shows the previous frame.
+static void queue_resize(uint32_t width, uint32_t height) {
+    resize.width  = width;
+    resize.height = height;
+    if (resize.timer_fd < 0) {
+        resize.timer_fd =
+            timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (resize.timer_fd >= 0 && !watch_event_timer(resize.timer_fd)) {
+            (void)close(resize.timer_fd);
+            resize.timer_fd = -1;
+        }
+    }
+    if (resize.timer_fd < 0) {
+        apply_resize();
+        return;
+    }
+    arm_resize_timer(RESIZE_SETTLE_MS);
+}
 
-    XMapWindow(app.display, app.window);
+// Follow the dock's monitor after a screen change. The window is moved and
+// resized in place and the boxes are redrawn; nothing else is rebuilt.
+static void relayout_dock(void) {
+    Monitor previous = app.monitor;
+    if (!select_monitor(previous.name)) {
+        select_monitor(nullptr);
+    }
+    if (memcmp(&previous, &app.monitor, sizeof(previous)) == 0) {
+        return;
+    }
 
-    app.gc = XCreateGC(app.display, app.window, 0, nullptr);
-    if (!app.gc) {
-        (void)fprintf(stderr, "Failed to create graphics context.\n");
-        XDestroyWindow(app.display, app.window);
-        return -1;
+    compute_layout(&app.monitor);
+    if (resize.timer_fd >= 0) {
+        arm_resize_timer(0);
     }
+    name_tip_hide();
+    app.backend->move_resize(dock_x(), dock_y(), app.dock_width,
+                             app.dock_height);
+    clear_last_clicked_box();
+    initialize_color_boxes();
+    draw_all_boxes();
+    app.backend->flush();
+    (void)autohide_place(dock_x(), dock_y());
+}
 
-    // Reposition the window and set it always on top.
-    XMoveWindow(
-        app.display, app.window,
-        DisplayWidth(app.display, screen) - app.dock_width,
-        (int)(DisplayHeight(app.display, screen) - app.dock_height) / 2);
-    set_above_state(app.display, app.window);
+bool handle_background_event(const DockEvent *event) {
+    switch (event->type) {
+        case EVENT_TIMER:
+            if (autohide_owns_timer(event->timer)) {
+                autohide_timer();
+            } else if (event->timer == resize.timer_fd) {
+                apply_resize();
+            } else if (workers_own_fd(event->timer)) {
+                workers_collect();
+            } else if (clipboard_watch_owns_timer(event->timer)) {
+                clipboard_watch_timer();
+            }
+            return true;
 
-    return 0;
+        case EVENT_RESIZE:
+            if (!autohide_active()) {
+                queue_resize(event->width, event->height);
+            }
+            return true;
+
+        case EVENT_CLIPBOARD_OWNER:
+        case EVENT_CLIPBOARD_TEXT:
+            clipboard_watch_handle(event);
+            return true;
+
+        default:
+            return false;
+    }
 }
 
-void handle_event(XEvent *event) {
+void handle_event(const DockEvent *event) {
     ColorBox *box = nullptr;
+    if (handle_background_event(event) || name_tip_handle_event(event) ||
+        event->surface != DOCK_SURFACE) {
+        return;
+    }
     switch (event->type) {
-        case Expose:
-            if (event->xexpose.count == 0) {
+        case EVENT_EXPOSE:
+            if (first_frame_shown) {
+                draw_all_boxes();
+                app.backend->flush();
+                break;
+            }
+            first_frame_shown = true;
+            if (!render_cache_show()) {
                 draw_all_boxes();
             }
+            app.backend->flush();
+            stats_first_frame();
+            mem_phase(MEM_PHASE_STEADY);
+            idle_start();
+            render_cache_check();
+            if (benchmark_redraws) {
+                run_redraw_benchmark();
+            }
+            if (benchmark_busy_s) {
+                run_busy_benchmark();
+            }
             break;
 
-        case ButtonPress:
-            if (event->xbutton.button == Button1) {
+        case EVENT_BUTTON_PRESS:
+            if (event->button == BUTTON_LEFT) {
                 // Left-click: copy the color using the global current_format.
-                box = find_box(event->xbutton.x, event->xbutton.y);
+                // Ctrl+click adds the box to the selection, or takes it out,
+                // and copies the whole selection instead.
+                uint64_t start_ns = stats_now_ns();
+                box               = find_box(event->x, event->y);
                 if (box) {
-                    copy_color_from_box(box);
-                    box->is_clicked = true;
-                    draw_colorbox(box);
+                    if (event->modifiers & MOD_CONTROL) {
+                        selection_toggle(box);
+                        (void)copy_selection();
+                    } else {
+                        selection_clear();
+                        copy_color_from_box(box);
+                        drag_from = box;
+                    }
+                    colorbox_on_click(box);
                     set_last_clicked_box(box);
+                    app.backend->flush();
+                    stats_click(start_ns);
                 }
-            } else if (event->xbutton.button == Button3) {
+            } else if (event->button == BUTTON_RIGHT &&
+                       (event->modifiers & MOD_SHIFT)) {
+                // Shift+right-click: slide the hue, lightness, chroma and
+                // warmth of the whole palette.
+                name_tip_hide();
+                (void)palette_sliders_run(event->root_x, event->root_y);
+                autohide_pointer_out();
+            } else if (event->button == BUTTON_RIGHT) {
                 // Right-click: show the context menu to change the global
-                // format.
-                box = find_box(event->xbutton.x, event->xbutton.y);
+                // format or copy the whole palette.
+                box = find_box(event->x, event->y);
                 if (box) {
-                    Window child = 0;
-                    int root_x   = 0;
-                    int root_y   = 0;
-                    XTranslateCoordinates(app.display, app.window,
-                                          DefaultRootWindow(app.display),
-                                          event->xbutton.x, event->xbutton.y,
-                                          &root_x, &root_y, &child);
-                    int chosen_format = context_menu_show(root_x, root_y);
-                    if (chosen_format >= 0) {
-                        current_format = (ColorFormat)chosen_format;
-                        // Copy the color in the newly selected format
-                        copy_color_from_box(box);
+                    name_tip_hide();
+                    int chosen = context_menu_show(event->root_x,
+                                                   event->root_y);
+                    if (chosen >= NORD_FORMAT_COUNT) {
+                        (void)copy_palette_export(
+                            (NordExport)(chosen - NORD_FORMAT_COUNT));
+                    } else if (chosen >= 0) {
+                        current_format = (NordFormat)chosen;
+                        palette_shm_update();
+                        // Copy the color, or the selection, in the newly
+                        // selected format.
+                        if (!copy_selection()) {
+                            copy_color_from_box(box);
+                        }
                     }
+                    // Crossings during the menu went to its own loop.
+                    autohide_pointer_out();
                 }
+            } else if (event->button == BUTTON_MIDDLE) {
+                // Middle-click: pick a color from the screen.
+                uint32_t color = 0;
+                name_tip_hide();
+                if (eyedropper_pick(event->root_x, event->root_y, &color) ==
+                    0) {
+                    copy_color(color);
+                }
+                autohide_pointer_out();
             }
             break;
 
-        case ButtonRelease:
-            box = find_box(event->xbutton.x, event->xbutton.y);
+        case EVENT_BUTTON_RELEASE:
+            box = find_box(event->x, event->y);
             if (box && (get_last_clicked_box() == box)) {
                 colorbox_on_release(box);
-                draw_colorbox(box);
                 clear_last_clicked_box();
             }
+            if (event->button == BUTTON_LEFT) {
+                // Dragged from one box to another: build a gradient.
+                ColorBox *start = drag_from;
+                drag_from       = nullptr;
+                if (start && box && box != start) {
+                    name_tip_hide();
+                    (void)gradient_builder_run(start->color, box->color,
+                                               event->root_x, event->root_y);
+                    autohide_pointer_out();
+                }
+            }
             break;
 
-        case MotionNotify:
-            box = find_box(event->xmotion.x, event->xmotion.y);
+        case EVENT_MOTION:
+            autohide_pointer_in();
+            box = find_box(event->x, event->y);
+            idle_hover(box ? (int)box_index(box) : IDLE_NO_BOX);
+            name_tip_show(box, event->root_x - event->x,
+                          event->root_y - event->y);
             if (get_last_clicked_box() && (get_last_clicked_box() != box)) {
                 colorbox_on_release(get_last_clicked_box());
-                draw_colorbox(get_last_clicked_box());
                 clear_last_clicked_box();
             }
             break;
 
-        case SelectionRequest:
-            handle_selection_request(&event->xselectionrequest);
+        case EVENT_ENTER:
+            autohide_pointer_in();
             break;
 
-        case ClientMessage:
-            if ((Atom)event->xclient.data.l[0] == wm_delete) {
-                cleanup_dock();
-                exit(EXIT_SUCCESS);  // NOLINT(concurrency-mt-unsafe)
-            }
+        case EVENT_LEAVE:
+            idle_hover(IDLE_NO_BOX);
+            name_tip_hide();
+            autohide_pointer_out();
+            break;
+
+        case EVENT_HOTKEY: {
+            uint64_t start_ns = stats_now_ns();
+            hotkeys_handle(event->hotkey);
+            app.backend->flush();
+            stats_hotkey(start_ns);
+            break;
+        }
+
+        case EVENT_SCREEN_CHANGE:
+            relayout_dock();
             break;
 
+        case EVENT_CLOSE:
+            cleanup_dock();
+            exit(EXIT_SUCCESS);  // NOLINT(concurrency-mt-unsafe)
+
         default:
             break;
     }
 }
 
 void cleanup_dock(void) {
-    if (app.gc) {
-        XFreeGC(app.display, app.gc);
-        app.gc = nullptr;
-    }
-    if (app.window) {
-        XDestroyWindow(app.display, app.window);
-        app.window = 0;
+    workers_stop();
+    autohide_stop();
+    clipboard_watch_stop();
+    if (resize.timer_fd >= 0) {
+        unwatch_event_timer(resize.timer_fd);
+        (void)close(resize.timer_fd);
+        resize.timer_fd = -1;
     }
-    if (app.display) {
-        XCloseDisplay(app.display);
-        app.display = nullptr;
+    palette_shm_close();
+    if (app.backend) {
+        app.backend->close();
     }
 }
 
@@ -201,79 +487,5 @@ void set_clipboard(const char *text) {
     if (!text) {
         return;
     }
-
-    // Copy the provided text into our clipboard buffer.
-    strncpy(clipboard_text, text, CLIPBOARD_BUFFER_SIZE - 1);
-    clipboard_text[CLIPBOARD_BUFFER_SIZE - 1] = '\0';
-
-    // Obtain atoms for the CLIPBOARD selection and UTF8_STRING.
-    Atom clipboard   = XInternAtom(app.display, "CLIPBOARD", False);
-    Atom utf8_string = XInternAtom(app.display, "UTF8_STRING", False);
-
-    // Claim ownership of the CLIPBOARD.
-    XSetSelectionOwner(app.display, clipboard, app.window, CurrentTime);
-    if (XGetSelectionOwner(app.display, clipboard) != app.window) {
-        (void)fprintf(stderr, "Failed to set clipboard owner\n");
-        return;
-    }
-
-    // Update the window property to hold the clipboard text.
-    XChangeProperty(app.display, app.window, utf8_string, utf8_string, 8,
-                    PropModeReplace, (unsigned char *)clipboard_text,
-                    (int)strlen(clipboard_text));
-    XFlush(app.display);
-}
-
-void handle_selection_request(XSelectionRequestEvent *req) {
-    XSelectionEvent notify;
-    memset(&notify, 0, sizeof(notify));
-    notify.type      = SelectionNotify;
-    notify.requestor = req->requestor;
-    notify.selection = req->selection;
-    notify.target    = req->target;
-    notify.property  = req->property;
-    notify.time      = req->time;
-
-    Atom utf8_string   = XInternAtom(app.display, "UTF8_STRING", False);
-    Atom compound_text = XInternAtom(app.display, "COMPOUND_TEXT", False);
-    Atom targets_atom  = XInternAtom(app.display, "TARGETS", False);
-
-    if (req->target == targets_atom) {
-        Atom supported_targets[] = { targets_atom, XA_STRING, utf8_string,
-                                     compound_text };
-        XChangeProperty(
-            app.display, req->requestor, req->property, XA_ATOM, 32,
-            PropModeReplace, (unsigned char *)supported_targets,
-            sizeof(supported_targets) / sizeof(supported_targets[0]));
-    } else if (req->target == XA_STRING || req->target == utf8_string ||
-               req->target == compound_text) {
-        XChangeProperty(app.display, req->requestor, req->property, req->target,
-                        8, PropModeReplace, (unsigned char *)clipboard_text,
-                        (int)strlen(clipboard_text));
-    } else {
-        notify.property = None;
-    }
-    XSendEvent(app.display, req->requestor, True, 0, (XEvent *)&notify);
-}
-
-void set_above_state(Display *display, Window window) {
-    Atom net_wm_state = XInternAtom(display, "_NET_WM_STATE", False);
-    Atom net_wm_state_above =
-        XInternAtom(display, "_NET_WM_STATE_ABOVE", False);
-
-    XClientMessageEvent xclient;
-    memset(&xclient, 0, sizeof(xclient));
-    xclient.type         = ClientMessage;
-    xclient.window       = window;
-    xclient.message_type = net_wm_state;
-    xclient.format       = 32;
-    xclient.data.l[0]    = 1;
-    xclient.data.l[1]    = (long)net_wm_state_above;
-    xclient.data.l[2]    = 0;
-    xclient.data.l[3]    = 1;
-    xclient.data.l[4]    = 0;
-
-    XSendEvent(display, DefaultRootWindow(display), False,
-               SubstructureRedirectMask | SubstructureNotifyMask,
-               (XEvent *)&xclient);
+    app.backend->set_clipboard(text, strlen(text));
 }
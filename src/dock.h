@@ -12,32 +12,45 @@
 #ifndef DOCK_H
 #define DOCK_H
 
-#include <X11/Xlib.h>
 #include <stdint.h>
 
 #include "app_context.h"
+#include "backend.h"
 
-#define PADDING 5
+#define PADDING 5  // In 96 DPI pixels; see scaled().
 #define DOCK_HEIGHT_MARGIN 0.20  // Dock hight is at 80% of the screen height
 #define BACKGROUND 0x000000      // Black background for label rectangles
+#define RESIZE_SETTLE_MS 100     // Quiet time that ends a burst of resizes.
+#define MIN_LABEL_SCALE 0.5F     // Label size limits on a resized dock,
+#define MAX_LABEL_SCALE 2.0F     // relative to the monitor's scale.
 
-typedef struct {
-    unsigned long flags;
-    unsigned long functions;
-    unsigned long decorations;
-    long input_mode;
-    unsigned long status;
-} Hints;
+// Scale factor forced on the command line, or 0 to use the monitor's.
+extern float scale_override;
 
-extern const Hints hints;
+// Time the given number of full redraws after the first frame, then exit.
+void dock_benchmark_redraws(uint32_t count);
 
-// Initialize the dock window with the given dimensions.
-// Returns 0 on success or a negative value on error.
-int initialize_dock(Display *display, uint32_t dock_width,
-                    uint32_t dock_height);
+// Copy nord0 after the first frame and keep a worker busy for the given
+// number of seconds, then exit; pastes must be served meanwhile.
+void dock_benchmark_busy(uint32_t seconds);
 
-// Process an X11 event.
-void handle_event(XEvent *event);
+// Choose the monitor the dock is placed on: a monitor name, a zero-based
+// index, or nullptr for the primary monitor. Returns false if no monitor
+// matches.
+bool select_monitor(const char *spec);
+
+// Size the dock for the selected monitor and create its window on the active
+// backend. Returns 0 on success or a negative value on error.
+int initialize_dock(void);
+
+// Handle the events that go on whatever the user is doing: timers, among
+// them worker completions, window resizes and the clipboard watcher. Modal
+// loops pass their events here first so none of these is lost while a popup
+// is open. Returns true if the event was one of them.
+bool handle_background_event(const DockEvent *event);
+
+// Process a backend event.
+void handle_event(const DockEvent *event);
 
 // Clean up and free resources allocated by the dock.
 void cleanup_dock(void);
@@ -45,10 +58,4 @@ void cleanup_dock(void);
 // Set the clipboard content (for use when a color box is clicked).
 void set_clipboard(const char *text);
 
-// Handle clipboard selection requests.
-void handle_selection_request(XSelectionRequestEvent *req);
-
-// Ask the window manager to keep the dock window above others.
-void set_above_state(Display *display, Window window);
-
 #endif  // DOCK_H
@@ -0,0 +1,234 @@
+/*
+ * Filename: eyedropper.c
+ *
+ * Description: Implements the screen color picker. The pointer is grabbed so
+ * motion anywhere on the screen is reported; for each new position a small
+ * square of screen pixels is read, magnified on the client and sent to the
+ * loupe popup as a single image, captioned with the color, the nearest
+ * palette color and, unless names are off, the nearest named color.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "eyedropper.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "app_context.h"
+#include "backend.h"
+#include "color_box.h"
+#include "color_names.h"
+#include "context_menu.h"
+#include "dock.h"
+#include "raster.h"
+
+typedef struct {
+    Surface surface;
+    Raster samples;        // Screen pixels around the pointer.
+    Raster view;           // The loupe as shown: magnified pixels and caption.
+    uint32_t cell;         // Device pixels per magnified screen pixel.
+    uint32_t pad;          // Caption padding.
+    uint32_t font_scale;   // Caption text size.
+    uint32_t line_height;  // Height of one caption line.
+    uint32_t lines;        // Caption lines below the magnified pixels.
+    uint32_t color;        // Color under the pointer.
+    Monitor monitors[MAX_MONITORS];
+    size_t monitor_count;
+} Loupe;
+
+static int loupe_init(Loupe *loupe) {
+    memset(loupe, 0, sizeof(*loupe));
+    loupe->cell        = scaled(LOUPE_ZOOM);
+    loupe->pad         = scaled(2);
+    loupe->font_scale  = app.scale < 1.5F ? 1 : (uint32_t)(app.scale + 0.5F);
+    loupe->line_height = raster_text_metrics("", 0, loupe->font_scale).height +
+                         (2 * loupe->pad);
+    loupe->lines       = color_names_enabled() ? 3 : 2;
+
+    uint32_t size = LOUPE_SAMPLES * loupe->cell;
+    if (raster_init(&loupe->samples, LOUPE_SAMPLES, LOUPE_SAMPLES) != 0 ||
+        raster_init(&loupe->view, size,
+                    size + (loupe->lines * loupe->line_height)) != 0) {
+        raster_free(&loupe->samples);
+        return -1;
+    }
+    loupe->monitor_count = app.backend->monitors(loupe->monitors, MAX_MONITORS);
+    return 0;
+}
+
+static void loupe_free(Loupe *loupe) {
+    raster_free(&loupe->samples);
+    raster_free(&loupe->view);
+}
+
+// Draw a one pixel frame just inside the given square.
+static void outline(Raster *raster, int x, int y, uint32_t size,
+                    uint32_t color) {
+    raster_fill_rect(raster, x, y, size, 1, color);
+    raster_fill_rect(raster, x, y + (int)size - 1, size, 1, color);
+    raster_fill_rect(raster, x, y, 1, size, color);
+    raster_fill_rect(raster, x + (int)size - 1, y, 1, size, color);
+}
+
+static void caption_line(Loupe *loupe, uint32_t line, uint32_t color,
+                         const char *text) {
+    Raster *view    = &loupe->view;
+    uint32_t pad    = loupe->pad;
+    uint32_t swatch = loupe->line_height - (2 * pad);
+    int top         = (int)(view->width + (line * loupe->line_height));
+    int baseline    = top + (int)(pad + raster_text_ascent(loupe->font_scale));
+
+    raster_fill_rect(view, 0, top, view->width, loupe->line_height, BLACK);
+    raster_fill_rect(view, (int)pad, top + (int)pad, swatch, swatch, color);
+    raster_draw_text(view, (int)((2 * pad) + swatch), baseline, text,
+                     strlen(text), WHITE, loupe->font_scale);
+}
+
+static void render(Loupe *loupe) {
+    Raster *view  = &loupe->view;
+    uint32_t cell = loupe->cell;
+    raster_scale_nearest(view, 0, 0, &loupe->samples, cell);
+
+    // Frame the center pixel in black and white so it shows on any color.
+    int center = (int)((LOUPE_SAMPLES / 2) * cell);
+    outline(view, center - 1, center - 1, cell + 2, BLACK);
+    outline(view, center, center, cell, WHITE);
+
+    char hex[CLIPBOARD_BUFFER_SIZE];
+    nord_format_color(loupe->color, NORD_FORMAT_HTML_HEX, hex, sizeof(hex));
+    const ColorBox *nearest = nearest_box(loupe->color);
+    caption_line(loupe, 0, loupe->color, hex);
+    caption_line(loupe, 1, nearest->color, nearest->label);
+    if (loupe->lines > 2) {
+        ColorName name = color_name(loupe->color);
+        caption_line(loupe, 2, name.color, name.name);
+    }
+}
+
+// Put the loupe below and right of the pointer, flipping it to the other
+// side near the edges of the pointer's monitor.
+static void place(const Loupe *loupe, int x, int y, int *out_x, int *out_y) {
+    const Monitor *mon = &loupe->monitors[0];
+    for (size_t i = 0; i < loupe->monitor_count;  // NOLINT
+         i++) {
+        const Monitor *m = &loupe->monitors[i];
+        if (x >= m->x && x < m->x + (int)m->width && y >= m->y &&
+            y < m->y + (int)m->height) {
+            mon = m;
+            break;
+        }
+    }
+
+    int offset = (int)scaled(LOUPE_OFFSET);
+    int width  = (int)loupe->view.width;
+    int height = (int)loupe->view.height;
+    *out_x     = x + offset;
+    *out_y     = y + offset;
+    if (*out_x + width > mon->x + (int)mon->width) {
+        *out_x = x - offset - width;
+    }
+    if (*out_y + height > mon->y + (int)mon->height) {
+        *out_y = y - offset - height;
+    }
+}
+
+static void show(const Loupe *loupe) {
+    const Raster *view = &loupe->view;
+    app.backend->put_image(loupe->surface, 0, 0, view->width, view->height,
+                           view->pixels, view->stride);
+}
+
+// Sample the screen around x, y and redraw the loupe next to it. Returns
+// false if the screen cannot be read.
+static bool update(Loupe *loupe, int x, int y) {
+    const Backend *backend = app.backend;
+    int half               = LOUPE_SAMPLES / 2;
+    if (!backend->capture(x - half, y - half, LOUPE_SAMPLES, LOUPE_SAMPLES,
+                          loupe->samples.pixels, loupe->samples.stride)) {
+        return false;
+    }
+    loupe->color =
+        loupe->samples.pixels[(half * loupe->samples.stride) + half];
+    render(loupe);
+
+    int loupe_x = 0;
+    int loupe_y = 0;
+    place(loupe, x, y, &loupe_x, &loupe_y);
+    if (!loupe->surface) {
+        loupe->surface = backend->open_popup(
+            loupe_x, loupe_y, loupe->view.width, loupe->view.height);
+    } else {
+        backend->move_popup(loupe->surface, loupe_x, loupe_y);
+    }
+    if (loupe->surface) {
+        show(loupe);
+    }
+    backend->flush();
+    return true;
+}
+
+int eyedropper_pick(int x, int y, uint32_t *color) {
+    const Backend *backend = app.backend;
+    Loupe loupe;
+    if (loupe_init(&loupe) != 0) {
+        return -1;
+    }
+    if (!backend->grab_pointer(true)) {
+        (void)fprintf(stderr, "Cannot grab the pointer to pick a color.\n");
+        loupe_free(&loupe);
+        return -1;
+    }
+
+    int status = -1;
+    bool done  = !update(&loupe, x, y);
+    if (done) {
+        (void)fprintf(stderr, "Reading the screen is not supported by the %s "
+                              "backend.\n",
+                      backend->name);
+    }
+
+    // Handle everything that is queued before sampling again, so only the
+    // latest pointer position is read and drawn.
+    DockEvent ev;
+    while (!done && wait_event(backend, &ev)) {  // NOLINT(altera-unroll-loops)
+        bool moved = false;
+        do {  // NOLINT(altera-unroll-loops)
+            if (handle_background_event(&ev)) {
+                continue;
+            }
+            if (loupe.surface && ev.surface == loupe.surface &&
+                ev.type == EVENT_EXPOSE) {
+                show(&loupe);
+            } else if (ev.surface == DOCK_SURFACE &&
+                       ev.type == EVENT_MOTION) {
+                x     = ev.root_x;
+                y     = ev.root_y;
+                moved = true;
+            } else if (ev.type == EVENT_BUTTON_PRESS) {
+                done = true;
+                if ((ev.button == BUTTON_LEFT || ev.button == BUTTON_RIGHT) &&
+                    update(&loupe, ev.root_x, ev.root_y)) {
+                    *color = ev.button == BUTTON_LEFT
+                                 ? loupe.color
+                                 : nearest_box(loupe.color)->color;
+                    status = 0;
+                }
+            }
+        } while (!done && backend->next_event(&ev));
+        if (moved && !done) {
+            done = !update(&loupe, x, y);
+        }
+    }
+
+    if (loupe.surface) {
+        backend->close_popup(loupe.surface);
+    }
+    backend->grab_pointer(false);
+    loupe_free(&loupe);
+    return status;
+}
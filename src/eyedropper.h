@@ -0,0 +1,29 @@
+/*
+ * Filename: eyedropper.h
+ *
+ * Description: Declarations for the screen color picker. While it runs, a
+ * loupe follows the pointer showing the magnified pixels around it, the color
+ * under it, the nearest palette color and the nearest named color.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef EYEDROPPER_H
+#define EYEDROPPER_H
+
+#include <stdint.h>
+
+// Loupe layout, in 96 DPI pixels where noted.
+#define LOUPE_SAMPLES 15  // Screen pixels across the loupe; odd for a center.
+#define LOUPE_ZOOM 8      // Size of one magnified screen pixel.
+#define LOUPE_OFFSET 24   // Distance from the pointer to the loupe.
+
+// Pick a color from the screen, starting with the pointer at x, y. A left
+// click picks the color under the pointer, a right click the nearest palette
+// color and any other button cancels. Returns 0 and sets color on a pick, or
+// -1 if the pick was cancelled or the backend cannot read the screen.
+int eyedropper_pick(int x, int y, uint32_t *color);
+
+#endif  // EYEDROPPER_H
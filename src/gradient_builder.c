@@ -0,0 +1,222 @@
+/*
+ * Filename: gradient_builder.c
+ *
+ * Description: Implements the gradient builder. The pointer is grabbed like
+ * the color picker's, and everything queued is handled before the preview is
+ * drawn again, so it keeps up with the pointer. Only a change of stop count,
+ * space or notation redraws it: the stops are interpolated by libarcticnord,
+ * the strip between them is generated four pixels at a time by the
+ * rasterizer, and the whole preview goes to its popup as one image.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "gradient_builder.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "app_context.h"
+#include "backend.h"
+#include "context_menu.h"
+#include "dock.h"
+#include "raster.h"
+
+typedef struct {
+    Surface surface;
+    Raster view;  // The preview as shown: strip, stops and caption.
+    int x;        // Screen position of the preview.
+    int y;
+    uint32_t strip_height;
+    uint32_t stop_height;
+    uint32_t pad;
+    uint32_t font_scale;
+    uint32_t from;
+    uint32_t to;
+    size_t count;  // Stops in the gradient.
+    NordSpace space;
+    NordGradientFormat kind;
+    uint32_t stops[GRADIENT_MAX_STOPS];
+} Builder;
+
+static int builder_init(Builder *builder, uint32_t from, uint32_t to) {
+    uint32_t font_scale = app.scale < 1.5F ? 1 : (uint32_t)(app.scale + 0.5F);
+    memset(builder, 0, sizeof(*builder));
+    builder->from         = from;
+    builder->to           = to;
+    builder->count        = GRADIENT_DEFAULT_STOPS;
+    builder->space        = NORD_SPACE_OKLAB;
+    builder->kind         = NORD_GRADIENT_CSS;
+    builder->strip_height = scaled(GRADIENT_STRIP_HEIGHT);
+    builder->stop_height  = scaled(GRADIENT_STOP_HEIGHT);
+    builder->pad          = scaled(2);
+    builder->font_scale   = font_scale;
+
+    uint32_t caption = raster_text_metrics("", 0, builder->font_scale).height +
+                       (2 * builder->pad);
+    return raster_init(&builder->view, scaled(GRADIENT_WIDTH),
+                       builder->strip_height + builder->stop_height +
+                           caption);
+}
+
+// Left of the pointer, as the dock sits at the right of its monitor, unless
+// that leaves the monitor; vertically centered on the pointer.
+static void place(Builder *builder, int x, int y) {
+    const Monitor *mon = &app.monitor;
+    int offset         = (int)scaled(GRADIENT_OFFSET);
+    int width          = (int)builder->view.width;
+    int height         = (int)builder->view.height;
+    builder->x         = x - offset - width;
+    builder->y         = y - (height / 2);
+    if (builder->x < mon->x) {
+        builder->x = x + offset;
+    }
+    if (builder->y + height > mon->y + (int)mon->height) {
+        builder->y = mon->y + (int)mon->height - height;
+    }
+    if (builder->y < mon->y) {
+        builder->y = mon->y;
+    }
+}
+
+static void render(Builder *builder) {
+    Raster *view = &builder->view;
+    nord_gradient(builder->from, builder->to, builder->space, builder->stops,
+                  builder->count);
+    raster_fill_gradient(view, 0, 0, view->width, builder->strip_height,
+                         builder->stops, builder->count);
+
+    // The stops themselves, as separate swatches under the strip.
+    int top = (int)builder->strip_height;
+    for (size_t i = 0; i < builder->count; i++) {  // NOLINT
+        uint32_t left  = (uint32_t)((view->width * i) / builder->count);
+        uint32_t right = (uint32_t)((view->width * (i + 1)) / builder->count);
+        raster_fill_rect(view, (int)left, top, right - left,
+                         builder->stop_height, builder->stops[i]);
+    }
+
+    char caption[NORD_TEXT_SIZE * 2];
+    int len = snprintf(caption, sizeof(caption), "%zu stops, %s, %s",
+                       builder->count, nord_space_name(builder->space),
+                       nord_gradient_format_name(builder->kind));
+    top += (int)builder->stop_height;
+    raster_fill_rect(view, 0, top, view->width, view->height - (uint32_t)top,
+                     BLACK);
+    raster_draw_text(view, (int)builder->pad,
+                     top + (int)(builder->pad +
+                                 raster_text_ascent(builder->font_scale)),
+                     caption, len > 0 ? (size_t)len : 0, WHITE,
+                     builder->font_scale);
+}
+
+static void show(const Builder *builder) {
+    const Raster *view = &builder->view;
+    app.backend->put_image(builder->surface, 0, 0, view->width, view->height,
+                           view->pixels, view->stride);
+}
+
+static void redraw(Builder *builder) {
+    render(builder);
+    show(builder);
+    app.backend->flush();
+}
+
+static bool inside(const Builder *builder, int x, int y) {
+    return x >= builder->x && x < builder->x + (int)builder->view.width &&
+           y >= builder->y && y < builder->y + (int)builder->view.height;
+}
+
+// The stop count the pointer asks for: one more stop for each equal step
+// across the preview, clamped at its edges.
+static size_t stops_at(const Builder *builder, int x) {
+    int64_t offset = (int64_t)x - builder->x;
+    int64_t width  = builder->view.width;
+    int64_t range  = GRADIENT_MAX_STOPS - GRADIENT_MIN_STOPS + 1;
+    int64_t count  = GRADIENT_MIN_STOPS + ((offset * range) / width);
+    if (offset < 0 || count < GRADIENT_MIN_STOPS) {
+        return GRADIENT_MIN_STOPS;
+    }
+    return count > GRADIENT_MAX_STOPS ? GRADIENT_MAX_STOPS : (size_t)count;
+}
+
+static bool copy(const Builder *builder) {
+    static char text[GRADIENT_TEXT_SIZE];
+    size_t len = nord_format_gradient(builder->stops, builder->count,
+                                      builder->kind, current_format, text,
+                                      sizeof(text));
+    return len < sizeof(text) && app.backend->set_clipboard(text, len);
+}
+
+int gradient_builder_run(uint32_t from, uint32_t to, int x, int y) {
+    const Backend *backend = app.backend;
+    Builder builder;
+    if (builder_init(&builder, from, to) != 0) {
+        return -1;
+    }
+    if (!backend->grab_pointer(true)) {
+        (void)fprintf(stderr, "Cannot grab the pointer to build a "
+                              "gradient.\n");
+        raster_free(&builder.view);
+        return -1;
+    }
+    place(&builder, x, y);
+    builder.surface = backend->open_popup(builder.x, builder.y,
+                                          builder.view.width,
+                                          builder.view.height);
+    if (builder.surface != DOCK_SURFACE) {
+        redraw(&builder);
+    }
+
+    int status = -1;
+    bool done  = builder.surface == DOCK_SURFACE;
+    DockEvent ev;
+    while (!done && wait_event(backend, &ev)) {  // NOLINT(altera-unroll-loops)
+        bool changed = false;
+        do {  // NOLINT(altera-unroll-loops)
+            if (handle_background_event(&ev)) {
+                continue;
+            }
+            if (ev.surface == builder.surface && ev.type == EVENT_EXPOSE) {
+                show(&builder);
+            } else if (ev.surface == DOCK_SURFACE &&
+                       ev.type == EVENT_MOTION) {
+                size_t count = stops_at(&builder, ev.root_x);
+                if (count != builder.count) {
+                    builder.count = count;
+                    changed       = true;
+                }
+            } else if (ev.type == EVENT_BUTTON_PRESS) {
+                if (ev.button == BUTTON_MIDDLE) {
+                    builder.space =
+                        (NordSpace)((builder.space + 1) % NORD_SPACE_COUNT);
+                    changed = true;
+                } else if (ev.button == BUTTON_RIGHT) {
+                    builder.kind = (NordGradientFormat)((builder.kind + 1) %
+                                                        NORD_GRADIENT_COUNT);
+                    changed      = true;
+                } else if (ev.button == BUTTON_LEFT) {
+                    done = true;
+                    if (inside(&builder, ev.root_x, ev.root_y) &&
+                        copy(&builder)) {
+                        status = 0;
+                    }
+                }
+            }
+        } while (!done && backend->next_event(&ev));
+        if (changed && !done) {
+            redraw(&builder);
+        }
+    }
+
+    if (builder.surface != DOCK_SURFACE) {
+        backend->close_popup(builder.surface);
+    }
+    backend->grab_pointer(false);
+    backend->flush();
+    raster_free(&builder.view);
+    return status;
+}
@@ -0,0 +1,44 @@
+/*
+ * Filename: gradient_builder.h
+ *
+ * Description: Declarations for the gradient builder, opened by dragging from
+ * one box to another. A floating preview shows the gradient between the two
+ * colors, interpolated in OKLab or OKLCH, with as many stops as the pointer
+ * asks for, and copies it as a CSS linear-gradient(), a list of stops or a
+ * GLSL array.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef GRADIENT_BUILDER_H
+#define GRADIENT_BUILDER_H
+
+#include <stdint.h>
+
+#include "arctic_nord.h"
+
+// Preview layout, in 96 DPI pixels.
+#define GRADIENT_WIDTH 320        // Width of the gradient strip.
+#define GRADIENT_STRIP_HEIGHT 40  // Height of the smooth gradient.
+#define GRADIENT_STOP_HEIGHT 12   // Height of the row of separate stops.
+#define GRADIENT_OFFSET 24        // Distance from the pointer.
+
+#define GRADIENT_MIN_STOPS 2
+#define GRADIENT_MAX_STOPS 32
+#define GRADIENT_DEFAULT_STOPS 5
+
+// Room for the longest gradient text, with its NUL.
+#define GRADIENT_TEXT_SIZE (GRADIENT_MAX_STOPS * (NORD_TEXT_SIZE + 8) + 64)
+
+// Build a gradient from one color to another, with the pointer at x, y.
+// While the builder runs, the pointer's position across the preview sets
+// the number of stops. A left click on the preview copies the gradient,
+// a middle click switches between OKLab and OKLCH, a right click changes
+// how the gradient is written and a left click elsewhere cancels. Returns 0
+// if the gradient was copied, or -1 if it was cancelled or the backend
+// cannot grab the pointer.
+int gradient_builder_run(uint32_t from, uint32_t to, int x, int y);
+
+#endif  // GRADIENT_BUILDER_H
@@ -0,0 +1,128 @@
+/*
+ * Filename: hotkeys.c
+ *
+ * Description: Implements the global hotkeys. A hotkey copies the palette
+ * entry's preformatted string straight to the clipboard; nothing is drawn.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "hotkeys.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "app_context.h"
+#include "backend.h"
+#include "color_box.h"
+#include "context_menu.h"
+#include "dock.h"
+#include "palette_shm.h"
+
+#define DEFAULT_MODIFIERS (MOD_SUPER | MOD_ALT)
+// Keysyms are X11 values, which match ASCII for digits and lowercase letters.
+#define KEYSYM_SPACE 0x20U
+
+static const char palette_keys[PALETTE_LENGTH] = "0123456789abcdef";
+
+static struct {
+    bool enabled;
+    uint32_t modifiers;
+    const ColorBox *last;  // Box copied by the last hotkey.
+} hk;
+
+static const struct {
+    const char *name;
+    uint32_t mask;
+} modifier_names[] = {
+    { "shift", MOD_SHIFT }, { "ctrl", MOD_CONTROL }, { "control", MOD_CONTROL },
+    { "alt", MOD_ALT },     { "super", MOD_SUPER },
+};
+
+static bool parse_modifier(const char *name, size_t len, uint32_t *mask) {
+    for (size_t i = 0;  // NOLINT(altera-unroll-loops)
+         i < sizeof(modifier_names) / sizeof(modifier_names[0]); i++) {
+        if (strlen(modifier_names[i].name) == len &&
+            strncmp(modifier_names[i].name, name, len) == 0) {
+            *mask |= modifier_names[i].mask;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool hotkeys_enable(const char *modifiers) {
+    uint32_t mask = 0;
+    if (!modifiers) {
+        mask = DEFAULT_MODIFIERS;
+    } else {
+        const char *name = modifiers;
+        while (*name) {  // NOLINT(altera-unroll-loops)
+            size_t len = strcspn(name, "+");
+            if (!parse_modifier(name, len, &mask)) {
+                return false;
+            }
+            name += len;
+            if (*name == '+') {
+                name++;
+            }
+        }
+    }
+    // Hotkeys without modifiers would take the keys from every application.
+    if (mask == 0) {
+        return false;
+    }
+    hk.enabled   = true;
+    hk.modifiers = mask;
+    return true;
+}
+
+void hotkeys_install(void) {
+    if (!hk.enabled) {
+        return;
+    }
+    Hotkey hotkeys[PALETTE_LENGTH + 1];
+    for (uint32_t i = 0; i < PALETTE_LENGTH;  // NOLINT(altera-unroll-loops)
+         i++) {
+        hotkeys[i] = (Hotkey){ .id        = i,
+                               .keysym    = (uint32_t)palette_keys[i],
+                               .modifiers = hk.modifiers };
+    }
+    hotkeys[PALETTE_LENGTH] = (Hotkey){ .id        = HOTKEY_NEXT_FORMAT,
+                                        .keysym    = KEYSYM_SPACE,
+                                        .modifiers = hk.modifiers };
+
+    size_t count   = sizeof(hotkeys) / sizeof(hotkeys[0]);
+    size_t grabbed = app.backend->grab_hotkeys(hotkeys, count);
+    if (grabbed == 0) {
+        (void)fprintf(stderr, "Global hotkeys are not available on the %s "
+                              "backend.\n",
+                      app.backend->name);
+    } else if (grabbed < count) {
+        (void)fprintf(stderr,
+                      "%zu of %zu hotkeys are taken by other clients.\n",
+                      count - grabbed, count);
+    }
+}
+
+void hotkeys_handle(uint32_t id) {
+    if (id == HOTKEY_NEXT_FORMAT) {
+        current_format =
+            (NordFormat)((current_format + 1) % NORD_FORMAT_COUNT);
+        palette_shm_update();
+        // Like choosing a format from the menu, copy the last color again.
+        if (hk.last) {
+            copy_color_from_box(hk.last);
+        }
+        return;
+    }
+    const ColorBox *box = palette_box(id);
+    if (box) {
+        copy_color_from_box(box);
+        hk.last = box;
+    }
+}
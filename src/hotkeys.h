@@ -0,0 +1,31 @@
+/*
+ * Filename: hotkeys.h
+ *
+ * Description: Declarations for the global hotkeys. With the modifiers held,
+ * the keys 0-9 and a-f copy nord0 to nord15 in the current format and space
+ * switches to the next format, without touching the dock.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef HOTKEYS_H
+#define HOTKEYS_H
+
+#include <stdint.h>
+
+// Hotkey id of the format switch; palette entries use their index.
+#define HOTKEY_NEXT_FORMAT 16
+
+// Turn the hotkeys on with the given modifiers, such as "super+alt", or the
+// default modifiers for nullptr. Returns false if the list cannot be parsed.
+bool hotkeys_enable(const char *modifiers);
+
+// Grab the hotkeys, if they are on, on the active backend.
+void hotkeys_install(void);
+
+// Act on EVENT_HOTKEY.
+void hotkeys_handle(uint32_t id);
+
+#endif  // HOTKEYS_H
@@ -0,0 +1,104 @@
+/*
+ * Filename: idle.c
+ *
+ * Description: Implements the idle-time scheduler: a small queue of tasks
+ * run cooperatively from the event loop's wait, with slice timings and queue
+ * depth recorded in the runtime statistics.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "idle.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stats.h"
+
+typedef struct {
+    IdleStep step;
+    void *data;
+    int box;
+} IdleTask;
+
+static struct {
+    IdleTask tasks[IDLE_MAX_TASKS];  // In the order they were queued.
+    size_t count;
+    int hovered;
+    bool started;
+} idle = { .hovered = IDLE_NO_BOX };
+
+bool idle_queue(IdleStep step, void *data, int box) {
+    if (idle.count == IDLE_MAX_TASKS) {
+        return false;
+    }
+    idle.tasks[idle.count++] =
+        (IdleTask){ .step = step, .data = data, .box = box };
+    stats.idle_queued++;
+    stats.idle_depth = idle.count;
+    if (idle.count > stats.idle_depth_max) {
+        stats.idle_depth_max = idle.count;
+    }
+    return true;
+}
+
+void idle_start(void) {
+    idle.started = true;
+}
+
+void idle_hover(int box) {
+    idle.hovered = box;
+}
+
+bool idle_pending(void) {
+    return idle.started && idle.count > 0;
+}
+
+// The task for the hovered box, if any is queued, or else the oldest.
+static size_t next_task(void) {
+    if (idle.hovered != IDLE_NO_BOX) {
+        for (size_t i = 0; i < idle.count; i++) {  // NOLINT
+            if (idle.tasks[i].box == idle.hovered) {
+                return i;
+            }
+        }
+    }
+    return 0;
+}
+
+static void remove_task(size_t index) {
+    for (size_t i = index; i + 1 < idle.count; i++) {  // NOLINT
+        idle.tasks[i] = idle.tasks[i + 1];
+    }
+    idle.count--;
+}
+
+void idle_run_slice(bool (*input_pending)(void *context), void *context) {
+    if (!idle_pending()) {
+        return;
+    }
+    uint64_t start_ns = stats_now_ns();
+    uint64_t elapsed  = 0;
+    bool preempted    = false;
+    while (idle.count > 0 && elapsed < IDLE_SLICE_NS) {  // NOLINT
+        size_t index = next_task();
+        if (idle.tasks[index].step(idle.tasks[index].data)) {
+            remove_task(index);
+        }
+        stats.idle_steps++;
+        elapsed = stats_now_ns() - start_ns;
+        if (input_pending(context)) {
+            preempted = true;
+            break;
+        }
+    }
+    stats.idle_slices++;
+    stats.idle_preempted += preempted;
+    stats.idle_total_ns += elapsed;
+    if (elapsed > stats.idle_max_ns) {
+        stats.idle_max_ns = elapsed;
+    }
+    stats.idle_depth = idle.count;
+}
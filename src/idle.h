@@ -0,0 +1,49 @@
+/*
+ * Filename: idle.h
+ *
+ * Description: Declarations for the idle-time scheduler. Caches that are
+ * worth having but not worth waiting for are queued as tasks and built a
+ * step at a time while the event loop has nothing else to do: never before
+ * the first frame, never while input is waiting, and for at most
+ * IDLE_SLICE_NS before the loop looks for input again.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define IDLE_MAX_TASKS 32
+#define IDLE_SLICE_NS 1000000U  // Longest slice of idle work, 1 ms.
+
+// No box: the task is not tied to what the pointer is over.
+#define IDLE_NO_BOX (-1)
+
+// Do one small piece of a task, well under a slice. Returns true once the
+// task is done.
+typedef bool (*IdleStep)(void *data);
+
+// Queue a task. Tasks run in the order they were queued, except that those
+// for the box under the pointer run first. Returns false if the queue is
+// full.
+bool idle_queue(IdleStep step, void *data, int box);
+
+// Allow idle work to run, once the first frame is out.
+void idle_start(void);
+
+// The palette index of the box under the pointer, or IDLE_NO_BOX.
+void idle_hover(int box);
+
+// Whether there is idle work that may run now.
+bool idle_pending(void);
+
+// Run queued steps until the slice is used up, the queue is empty or
+// input_pending() reports input, which is checked after every step.
+void idle_run_slice(bool (*input_pending)(void *context), void *context);
+
+#endif  // IDLE_H
@@ -2,53 +2,305 @@
  * Filename: main.c
  *
  * Description: Main entry point for the Arctic Nord Dock application.
- * Initializes the X11 display and dock, and runs the main event loop.
+ * Selects the platform backend, initializes the dock, and runs the main event
+ * loop, or exports the palette without opening a display.
  *
  * Author: Michael Knap
  * Date: 2025-02-13
  * License: MIT
  */
 
-#include <X11/Xlib.h>
+#define _POSIX_C_SOURCE 200809L
+
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
 
 #include "app_context.h"
+#include "autohide.h"
+#include "backend.h"
+#include "backend_null.h"
+#include "backend_xlib.h"
+#include "clipboard_watch.h"
 #include "color_box.h"
+#include "color_names.h"
+#include "context_menu.h"
 #include "dock.h"
+#include "hotkeys.h"
+#include "mem_report.h"
+#include "palette_shm.h"
+#include "render_cache.h"
+#include "stats.h"
+
+static void usage(const char *argv0) {
+    (void)fprintf(stderr,
+                  "Usage: %s [--backend=xlib|xcb|null] "
+                  "[--monitor=NAME|N] [--all-monitors] [--scale=F] "
+                  "[--translucent=auto|on|off] [--render=core|software] "
+                  "[--autohide] [--hotkeys[=MODS]] [--watch-clipboard] "
+                  "[--clicks=N] [--keys=N] "
+                  "[--redraws=N] [--busy=SECONDS] [--stats] [--mem-report] "
+                  "[--format=NAME] "
+                  "[--export=KIND] [--names=SET] [--name=COLOR] "
+                  "[--separator=TEXT] [--no-render-cache]\n"
+                  "  --backend=NAME  platform backend (default: xlib)\n"
+                  "  --monitor=SPEC  place the dock on a monitor by name or "
+                  "index (default: primary)\n"
+                  "  --all-monitors  run one dock instance per monitor\n"
+                  "  --scale=F       HiDPI scale factor (default: from "
+                  "Xft.dpi or the monitor size)\n"
+                  "  --translucent=MODE\n"
+                  "                  xlib backend only: rounded boxes on a "
+                  "translucent background\n"
+                  "                  (default: auto, when a compositor "
+                  "runs)\n"
+                  "  --render=MODE   xlib backend only: core drawing requests "
+                  "or client-side\n"
+                  "                  rendering presented with MIT-SHM "
+                  "(default: core)\n"
+                  "  --autohide      xlib backend only: slide the dock out "
+                  "of view until the pointer\n"
+                  "                  reaches the screen edge\n"
+                  "  --hotkeys[=MODS]\n"
+                  "                  xlib backend only: MODS+0..9/a..f copy "
+                  "nord0..nord15 and\n"
+                  "                  MODS+space switches format (default: "
+                  "super+alt)\n"
+                  "  --watch-clipboard\n"
+                  "                  xlib backend only: mark the box nearest "
+                  "to a color another\n"
+                  "                  application copies\n"
+                  "  --clicks=N      null backend only: replay N clicks on "
+                  "the first box\n"
+                  "  --keys=N        null backend only: replay N hotkeys, "
+                  "with --hotkeys\n"
+                  "  --redraws=N     time N full redraws after the first "
+                  "frame, then exit\n"
+                  "  --busy=SECONDS  copy nord0 and keep a worker busy for "
+                  "SECONDS, then exit\n"
+                  "  --stats         print round trips and latencies on exit\n"
+                  "  --mem-report    print resident memory and allocations "
+                  "by phase on exit\n"
+                  "  --format=NAME   format to copy in, such as html-hex or "
+                  "vec3 (default: html-hex)\n"
+                  "  --export=KIND   write the whole palette to standard "
+                  "output and exit: css,\n"
+                  "                  scss, json, xresources, glsl, hlsl, "
+                  "alacritty, kitty or foot\n"
+                  "  --names=SET     color names shown for boxes and picked "
+                  "colors: css, x11,\n"
+                  "                  xkcd when built in, or off (default: "
+                  "css)\n"
+                  "  --name=COLOR    print the nearest name in every table "
+                  "and exit\n"
+                  "  --separator=TEXT\n"
+                  "                  text between the colors of a Ctrl+click "
+                  "selection, with \\n\n"
+                  "                  and \\t escapes (default: \\n)\n"
+                  "  --no-render-cache\n"
+                  "                  draw the first frame instead of showing "
+                  "the cached one,\n"
+                  "                  and leave the cache alone\n",
+                  argv0);
+}
+
+// Name a color given in any format the dock copies, from every table.
+static int print_names(const char *text) {
+    uint32_t color = 0;
+    if (nord_parse_color(text, strlen(text), &color, nullptr) != 0) {
+        (void)fprintf(stderr, "Not a color: %s\n", text);
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < color_names_tables(); i++) {  // NOLINT
+        ColorName name = color_name_in(i, color);
+        (void)printf("%-5s #%06X %s\n", color_names_title(i), name.color,
+                     name.name);
+    }
+    return EXIT_SUCCESS;
+}
+
+static void print_stats(void) {
+    stats_print(stderr, app.backend ? app.backend->name : "none");
+}
+
+static void print_mem_report(void) {
+    mem_report_print(stderr);
+}
+
+int main(int argc, char **argv) {
+    stats.start_ns = stats_now_ns();
 
-int main(void) {
-    Display *display = XOpenDisplay(nullptr);
-    if (!display) {
-        (void)fprintf(stderr, "Unable to open display.\n");
+    const char *backend_name = "xlib";
+    const char *monitor_spec = nullptr;
+    bool all_monitors        = false;
+    uint32_t clicks          = 0;
+    uint32_t keys            = 0;
+    int export_kind          = -1;
+    const char *name_color   = nullptr;
+
+    for (int i = 1; i < argc; i++) {  // NOLINT(altera-unroll-loops)
+        if (strncmp(argv[i], "--backend=", 10) == 0) {
+            backend_name = argv[i] + 10;
+        } else if (strncmp(argv[i], "--monitor=", 10) == 0) {
+            monitor_spec = argv[i] + 10;
+        } else if (strcmp(argv[i], "--all-monitors") == 0) {
+            all_monitors = true;
+        } else if (strncmp(argv[i], "--scale=", 8) == 0) {
+            scale_override = strtof(argv[i] + 8, nullptr);
+        } else if (strcmp(argv[i], "--translucent=auto") == 0) {
+            xlib_backend_set_translucency(TRANSLUCENCY_AUTO);
+        } else if (strcmp(argv[i], "--translucent=on") == 0) {
+            xlib_backend_set_translucency(TRANSLUCENCY_ON);
+        } else if (strcmp(argv[i], "--translucent=off") == 0) {
+            xlib_backend_set_translucency(TRANSLUCENCY_OFF);
+        } else if (strcmp(argv[i], "--render=core") == 0) {
+            xlib_backend_use_software(false);
+        } else if (strcmp(argv[i], "--render=software") == 0) {
+            xlib_backend_use_software(true);
+        } else if (strcmp(argv[i], "--autohide") == 0) {
+            autohide_enable();
+        } else if (strcmp(argv[i], "--hotkeys") == 0) {
+            (void)hotkeys_enable(nullptr);
+        } else if (strncmp(argv[i], "--hotkeys=", 10) == 0) {
+            if (!hotkeys_enable(argv[i] + 10)) {
+                (void)fprintf(stderr, "Unknown modifiers: %s\n", argv[i] + 10);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--watch-clipboard") == 0) {
+            clipboard_watch_enable();
+        } else if (strncmp(argv[i], "--keys=", 7) == 0) {
+            keys = (uint32_t)strtoul(argv[i] + 7, nullptr, 10);
+        } else if (strncmp(argv[i], "--clicks=", 9) == 0) {
+            clicks = (uint32_t)strtoul(argv[i] + 9, nullptr, 10);
+        } else if (strncmp(argv[i], "--redraws=", 10) == 0) {
+            dock_benchmark_redraws(
+                (uint32_t)strtoul(argv[i] + 10, nullptr, 10));
+        } else if (strncmp(argv[i], "--busy=", 7) == 0) {
+            dock_benchmark_busy((uint32_t)strtoul(argv[i] + 7, nullptr, 10));
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            (void)atexit(print_stats);
+        } else if (strcmp(argv[i], "--mem-report") == 0) {
+            mem_report_enable();
+            (void)atexit(print_mem_report);
+        } else if (strncmp(argv[i], "--format=", 9) == 0) {
+            int format = nord_format_lookup(argv[i] + 9);
+            if (format < 0) {
+                (void)fprintf(stderr, "Unknown format: %s\n", argv[i] + 9);
+                return EXIT_FAILURE;
+            }
+            current_format = (NordFormat)format;
+        } else if (strncmp(argv[i], "--export=", 9) == 0) {
+            export_kind = nord_export_lookup(argv[i] + 9);
+            if (export_kind < 0) {
+                (void)fprintf(stderr, "Unknown export: %s\n", argv[i] + 9);
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--names=", 8) == 0) {
+            if (!color_names_select(argv[i] + 8)) {
+                (void)fprintf(stderr, "Unknown names: %s\n", argv[i] + 8);
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--name=", 7) == 0) {
+            name_color = argv[i] + 7;
+        } else if (strncmp(argv[i], "--separator=", 12) == 0) {
+            if (!set_selection_separator(argv[i] + 12)) {
+                (void)fprintf(stderr, "Separator too long: %s\n",
+                              argv[i] + 12);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--no-render-cache") == 0) {
+            render_cache_disable();
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The name indexes are built while the dock is idle, or by the first
+    // lookup.
+    color_names_init();
+    if (name_color) {
+        return print_names(name_color);
+    }
+
+    // Exports are streamed straight from the palette tables; no display is
+    // opened.
+    if (export_kind >= 0) {
+        static NordWriter writer;
+        nord_writer_fd(&writer, STDOUT_FILENO);
+        if (export_palette(&writer, (NordExport)export_kind) != 0) {
+            perror("export");
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    mem_phase(MEM_PHASE_CONNECT);
+    app.backend = find_backend(backend_name);
+    if (!app.backend) {
+        (void)fprintf(stderr, "Unknown backend: %s\n", backend_name);
+        return EXIT_FAILURE;
+    }
+    if (app.backend->open() != 0) {
         return EXIT_FAILURE;
     }
 
-    int screen              = DefaultScreen(display);
-    uint32_t display_height = DisplayHeight(display, screen);
+    // One instance per monitor: the connection is closed before forking so
+    // each process opens its own, and this process keeps the primary.
+    static Monitor monitors[MAX_MONITORS];
+    if (all_monitors) {
+        size_t count = app.backend->monitors(monitors, MAX_MONITORS);
+        app.backend->close();
+        monitor_spec = nullptr;
+        for (size_t i = 1; i < count; i++) {  // NOLINT(altera-unroll-loops)
+            pid_t pid = fork();
+            if (pid == 0) {
+                monitor_spec = monitors[i].name;
+                break;
+            }
+            if (pid < 0) {
+                perror("fork");
+            }
+        }
+        if (app.backend->open() != 0) {
+            return EXIT_FAILURE;
+        }
+    }
 
-    // Calculate the size of each color box and the dock dimensions.
-    app.rect_size =
-        (uint32_t)((display_height - (DOCK_HEIGHT_MARGIN * display_height)) /
-                   PALETTE_LENGTH);
-    app.dock_width  = 2 * PADDING + app.rect_size;
-    app.dock_height = PALETTE_LENGTH * (app.rect_size + PADDING) + PADDING;
+    if (!select_monitor(monitor_spec)) {
+        (void)fprintf(stderr, "Unknown monitor: %s\n", monitor_spec);
+        cleanup_dock();
+        return EXIT_FAILURE;
+    }
 
     // Initialize the dock window.
-    if (initialize_dock(display, app.dock_width, app.dock_height) != 0) {
-        XCloseDisplay(display);
+    mem_phase(MEM_PHASE_WINDOW);
+    if (initialize_dock() != 0) {
+        cleanup_dock();
         return EXIT_FAILURE;
     }
 
     initialize_color_boxes();
+    palette_shm_open();
+    hotkeys_install();
+    clipboard_watch_install();
+    mem_phase(MEM_PHASE_FIRST_FRAME);
+
+    if (app.backend == &null_backend) {
+        int inside = (int)scaled(PADDING) + 1;
+        null_backend_queue_clicks(inside, inside, clicks);
+        null_backend_queue_hotkeys(keys);
+    }
 
-    // This loop blocks waiting for the next X event.
-    // Termination occurs only when the WM_DELETE_WINDOW event is received.
-    XEvent event;
-    while (1) {  // NOLINT(altera-unroll-loops)
-        XNextEvent(display, &event);
+    // This loop blocks waiting for the next event. With an X server,
+    // termination occurs only when the WM_DELETE_WINDOW event is received;
+    // the null backend stops once its event queue runs dry.
+    DockEvent event;
+    while (wait_event(app.backend, &event)) {  // NOLINT(altera-unroll-loops)
         handle_event(&event);
     }
 
@@ -0,0 +1,255 @@
+/*
+ * Filename: mem_report.c
+ *
+ * Description: Implements the memory report. In builds made with
+ * ALLOC_HOOKS=1 the allocation wrappers replace malloc() and friends for the
+ * whole process, Xlib's allocations included, and forward to glibc's own
+ * entry points; each call costs a few relaxed atomic additions. The
+ * resident set size is read from /proc without allocating, so sampling it
+ * does not disturb the counts.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "mem_report.h"
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__) && defined(ALLOC_HOOKS)
+#define COUNT_ALLOCATIONS 1
+#include <errno.h>
+#include <malloc.h>
+#endif
+
+#define STATUS_SIZE 2048
+
+static _Atomic uint64_t allocations[MEM_PHASE_COUNT];
+static _Atomic uint64_t frees[MEM_PHASE_COUNT];
+static _Atomic uint64_t bytes[MEM_PHASE_COUNT];
+static _Atomic int current_phase;
+static uint64_t phase_rss_kib[MEM_PHASE_COUNT];
+static bool sampling;  // Read the resident set size at phase ends.
+
+#ifdef COUNT_ALLOCATIONS
+
+static _Atomic uint64_t live_bytes;
+static _Atomic uint64_t peak_bytes;
+
+// glibc's allocator, under the names it exports for wrappers like these.
+extern void *__libc_malloc(size_t size);  // NOLINT
+extern void *__libc_calloc(size_t count, size_t size);  // NOLINT
+extern void *__libc_realloc(void *ptr, size_t size);  // NOLINT
+extern void *__libc_memalign(size_t alignment, size_t size);  // NOLINT
+extern void *__libc_valloc(size_t size);  // NOLINT
+extern void *__libc_pvalloc(size_t size);  // NOLINT
+extern void __libc_free(void *ptr);  // NOLINT
+
+static void *count_allocation(void *ptr) {
+    if (!ptr) {
+        return ptr;
+    }
+    int phase     = atomic_load_explicit(&current_phase, memory_order_relaxed);
+    uint64_t size = malloc_usable_size(ptr);
+    atomic_fetch_add_explicit(&allocations[phase], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bytes[phase], size, memory_order_relaxed);
+    uint64_t live =
+        atomic_fetch_add_explicit(&live_bytes, size, memory_order_relaxed) +
+        size;
+    uint64_t peak = atomic_load_explicit(&peak_bytes, memory_order_relaxed);
+    while (live > peak &&  // NOLINT(altera-unroll-loops)
+           !atomic_compare_exchange_weak_explicit(&peak_bytes, &peak, live,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+    return ptr;
+}
+
+static void count_free(void *ptr) {
+    int phase     = atomic_load_explicit(&current_phase, memory_order_relaxed);
+    uint64_t size = malloc_usable_size(ptr);
+    atomic_fetch_add_explicit(&frees[phase], 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&live_bytes, size, memory_order_relaxed);
+}
+
+void *malloc(size_t size) {
+    return count_allocation(__libc_malloc(size));
+}
+
+void *calloc(size_t count, size_t size) {
+    return count_allocation(__libc_calloc(count, size));
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (!ptr) {
+        return malloc(size);
+    }
+    if (size == 0) {
+        free(ptr);
+        return nullptr;
+    }
+    uint64_t old_size = malloc_usable_size(ptr);
+    void *result      = __libc_realloc(ptr, size);
+    if (result) {
+        int phase = atomic_load_explicit(&current_phase, memory_order_relaxed);
+        atomic_fetch_add_explicit(&frees[phase], 1, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&live_bytes, old_size, memory_order_relaxed);
+    }
+    return count_allocation(result);
+}
+
+void free(void *ptr) {
+    if (ptr) {
+        count_free(ptr);
+        __libc_free(ptr);
+    }
+}
+
+// Aligned allocations are freed with free(), so they are counted too.
+void *memalign(size_t alignment, size_t size) {
+    return count_allocation(__libc_memalign(alignment, size));
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+void *valloc(size_t size) {
+    return count_allocation(__libc_valloc(size));
+}
+
+void *pvalloc(size_t size) {
+    return count_allocation(__libc_pvalloc(size));
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void *result = memalign(alignment, size);
+    if (!result) {
+        return ENOMEM;
+    }
+    *ptr = result;
+    return 0;
+}
+
+#endif  // COUNT_ALLOCATIONS
+
+bool mem_counting(void) {
+#ifdef COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t mem_heap_peak(void) {
+#ifdef COUNT_ALLOCATIONS
+    return atomic_load_explicit(&peak_bytes, memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+// A "Name:   1234 kB" line of /proc/self/status, in KiB.
+static uint64_t status_kib(const char *name) {
+    char status[STATUS_SIZE];
+    int fd = open("/proc/self/status", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+    ssize_t len = read(fd, status, sizeof(status) - 1);
+    (void)close(fd);
+    if (len <= 0) {
+        return 0;
+    }
+    status[len] = '\0';
+
+    size_t name_len  = strlen(name);
+    const char *line = status;
+    while (line) {  // NOLINT(altera-unroll-loops)
+        if (strncmp(line, name, name_len) == 0 && line[name_len] == ':') {
+            return strtoull(line + name_len + 1, nullptr, 10);
+        }
+        line = strchr(line, '\n');
+        line = line ? line + 1 : nullptr;
+    }
+    return 0;
+}
+
+uint64_t mem_rss_kib(void) {
+    return status_kib("VmRSS");
+}
+
+uint64_t mem_rss_peak_kib(void) {
+    return status_kib("VmHWM");
+}
+
+void mem_report_enable(void) {
+    sampling = true;
+}
+
+void mem_phase(MemPhase phase) {
+    int running = atomic_load_explicit(&current_phase, memory_order_relaxed);
+    if ((int)phase <= running || phase >= MEM_PHASE_COUNT) {
+        return;
+    }
+    uint64_t rss = sampling ? mem_rss_kib() : 0;
+    for (int i = running; i < (int)phase; i++) {  // NOLINT
+        phase_rss_kib[i] = rss;
+    }
+    atomic_store_explicit(&current_phase, (int)phase, memory_order_relaxed);
+}
+
+MemPhaseStats mem_phase_stats(MemPhase phase) {
+    MemPhaseStats out;
+    out.allocations =
+        atomic_load_explicit(&allocations[phase], memory_order_relaxed);
+    out.frees   = atomic_load_explicit(&frees[phase], memory_order_relaxed);
+    out.bytes   = atomic_load_explicit(&bytes[phase], memory_order_relaxed);
+    out.rss_kib = phase_rss_kib[phase];
+    int running = atomic_load_explicit(&current_phase, memory_order_relaxed);
+    if ((int)phase == running) {
+        out.rss_kib = mem_rss_kib();
+    }
+    return out;
+}
+
+void mem_report_print(FILE *out) {
+    static const char *const names[MEM_PHASE_COUNT] = {
+        "startup", "connect", "window", "first frame", "steady"
+    };
+    int running = atomic_load_explicit(&current_phase, memory_order_relaxed);
+    (void)fprintf(out,
+                  "phase          allocs     frees    KiB alloc   KiB rss\n");
+    for (int i = 0; i <= running; i++) {  // NOLINT(altera-unroll-loops)
+        MemPhaseStats phase = mem_phase_stats((MemPhase)i);
+        if (mem_counting()) {
+            (void)fprintf(out, "%-11s %9llu %9llu %12.1f %9llu\n", names[i],
+                          (unsigned long long)phase.allocations,
+                          (unsigned long long)phase.frees,
+                          (double)phase.bytes / 1024.0,
+                          (unsigned long long)phase.rss_kib);
+        } else {
+            (void)fprintf(out, "%-11s %9s %9s %12s %9llu\n", names[i], "-",
+                          "-", "-", (unsigned long long)phase.rss_kib);
+        }
+    }
+    if (mem_counting()) {
+        (void)fprintf(out, "heap peak:     %.1f KiB\n",
+                      (double)mem_heap_peak() / 1024.0);
+    }
+    (void)fprintf(out, "rss peak:      %llu KiB\n",
+                  (unsigned long long)mem_rss_peak_kib());
+}
@@ -0,0 +1,62 @@
+/*
+ * Filename: mem_report.h
+ *
+ * Description: Declarations for the memory report printed by --mem-report:
+ * resident set size, heap high-water mark and allocation counts for each
+ * phase of the dock's life. Allocations are counted by wrappers around the C
+ * library's allocator in dynamically linked glibc builds made with
+ * ALLOC_HOOKS=1; other builds report the resident set size only.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef MEM_REPORT_H
+#define MEM_REPORT_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+typedef enum {
+    MEM_PHASE_STARTUP,      // Arguments and the color name indexes.
+    MEM_PHASE_CONNECT,      // Opening the backend and finding monitors.
+    MEM_PHASE_WINDOW,       // Creating the window and laying out the boxes.
+    MEM_PHASE_FIRST_FRAME,  // Up to the first frame being flushed.
+    MEM_PHASE_STEADY,       // Everything after the first frame.
+    MEM_PHASE_COUNT
+} MemPhase;
+
+typedef struct {
+    uint64_t allocations;  // Calls that returned new memory.
+    uint64_t frees;        // Calls that released memory.
+    uint64_t bytes;        // Usable bytes of the new memory.
+    uint64_t rss_kib;      // Resident set size when the phase ended.
+} MemPhaseStats;
+
+// Whether this build counts allocations.
+bool mem_counting(void);
+
+// Sample the resident set size as each phase ends, for the report.
+// Allocations are counted either way.
+void mem_report_enable(void);
+
+// End the running phase and start the given one. Phases only move forward,
+// so marking a phase that has already started does nothing.
+void mem_phase(MemPhase phase);
+
+// The counts of a phase, with the resident set size sampled now for the
+// running one.
+MemPhaseStats mem_phase_stats(MemPhase phase);
+
+// Resident set size and its peak, from /proc/self/status, in KiB. Returns 0
+// if it cannot be read.
+uint64_t mem_rss_kib(void);
+uint64_t mem_rss_peak_kib(void);
+
+// Largest number of bytes allocated at once.
+uint64_t mem_heap_peak(void);
+
+void mem_report_print(FILE *out);
+
+#endif  // MEM_REPORT_H
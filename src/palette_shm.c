@@ -0,0 +1,57 @@
+/*
+ * Filename: palette_shm.c
+ *
+ * Description: Implements publishing the palette, with every color already
+ * formatted, whenever the format or the palette changes.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "palette_shm.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arctic_nord_shm.h"
+#include "color_box.h"
+#include "context_menu.h"
+
+static NordShm shm = { .fd = -1 };
+
+void palette_shm_open(void) {
+    if (nord_shm_create(&shm, nullptr) != 0) {
+        // EWOULDBLOCK means another dock is already publishing.
+        if (errno != EWOULDBLOCK) {
+            perror("Cannot publish the palette");
+        }
+        return;
+    }
+    palette_shm_update();
+}
+
+void palette_shm_update(void) {
+    if (!shm.segment) {
+        return;
+    }
+    NordShmPalette palette = { .format = (uint32_t)current_format,
+                               .count  = PALETTE_LENGTH };
+    (void)snprintf(palette.format_name, sizeof(palette.format_name), "%s",
+                   nord_format_name(current_format));
+    for (size_t i = 0; i < PALETTE_LENGTH;  // NOLINT(altera-unroll-loops)
+         i++) {
+        const ColorBox *box = palette_box(i);
+        NordShmEntry *entry = &palette.entries[i];
+        entry->color        = box->color;
+        (void)snprintf(entry->label, sizeof(entry->label), "%s", box->label);
+        (void)snprintf(entry->text, sizeof(entry->text), "%s", box_text(box));
+    }
+    nord_shm_publish(&shm, &palette);
+}
+
+void palette_shm_close(void) {
+    nord_shm_destroy(&shm, nullptr);
+}
@@ -0,0 +1,26 @@
+/*
+ * Filename: palette_shm.h
+ *
+ * Description: Declarations for publishing the dock's palette and current
+ * format to other programs through the shared-memory segment described in
+ * arctic_nord_shm.h.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef PALETTE_SHM_H
+#define PALETTE_SHM_H
+
+// Create the segment and publish the current state. With several docks
+// running, only the first one publishes.
+void palette_shm_open(void);
+
+// Publish the state again after the format or the palette changed.
+void palette_shm_update(void);
+
+// Remove the segment.
+void palette_shm_close(void);
+
+#endif  // PALETTE_SHM_H
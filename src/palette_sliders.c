@@ -0,0 +1,283 @@
+/*
+ * Filename: palette_sliders.c
+ *
+ * Description: Implements the palette sliders. The pointer is grabbed like
+ * the gradient builder's, and everything queued is handled before a frame is
+ * drawn, so a drag produces one frame per batch of pointer motion. A frame
+ * transforms the palette in one batch through libarcticnord, redraws only
+ * the boxes whose color changed and puts the panel to its popup as one
+ * image. Strings are not formatted until a box is copied.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "palette_sliders.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "app_context.h"
+#include "backend.h"
+#include "color_box.h"
+#include "context_menu.h"
+#include "dock.h"
+#include "palette_shm.h"
+#include "raster.h"
+#include "stats.h"
+
+typedef enum {
+    SLIDER_HUE,
+    SLIDER_LIGHTNESS,
+    SLIDER_CHROMA,
+    SLIDER_TEMPERATURE,
+    SLIDER_COUNT
+} SliderKind;
+
+typedef struct {
+    const char *name;
+    float min;
+    float max;
+    float neutral;
+    int decimals;  // Shown in the caption.
+    bool shift;    // The value is added rather than a factor, so it is signed.
+} Slider;
+
+static const Slider sliders[SLIDER_COUNT] = {
+    [SLIDER_HUE]         = { "Hue", -180.0F, 180.0F, 0.0F, 0, true },
+    [SLIDER_LIGHTNESS]   = { "Lightness", 0.5F, 1.5F, 1.0F, 2, false },
+    [SLIDER_CHROMA]      = { "Chroma", 0.0F, 2.0F, 1.0F, 2, false },
+    [SLIDER_TEMPERATURE] = { "Warmth", -1.0F, 1.0F, 0.0F, 2, true },
+};
+
+// Slider positions, kept between panels as the palette keeps its transform.
+static float values[SLIDER_COUNT] = {
+    [SLIDER_HUE]         = 0.0F,
+    [SLIDER_LIGHTNESS]   = 1.0F,
+    [SLIDER_CHROMA]      = 1.0F,
+    [SLIDER_TEMPERATURE] = 0.0F,
+};
+
+typedef struct {
+    Surface surface;
+    Raster view;
+    int x;  // Screen position of the panel.
+    int y;
+    uint32_t row_height;
+    uint32_t label_width;
+    uint32_t pad;
+    uint32_t font_scale;
+} Panel;
+
+static int panel_init(Panel *panel) {
+    uint32_t font_scale = app.scale < 1.5F ? 1 : (uint32_t)(app.scale + 0.5F);
+    memset(panel, 0, sizeof(*panel));
+    panel->pad         = scaled(2);
+    panel->font_scale  = font_scale;
+    panel->label_width = scaled(SLIDER_LABEL_WIDTH);
+    panel->row_height  = scaled(SLIDER_ROW_HEIGHT);
+
+    uint32_t text = raster_text_metrics("", 0, font_scale).height;
+    if (panel->row_height < text + (2 * panel->pad)) {
+        panel->row_height = text + (2 * panel->pad);
+    }
+    return raster_init(&panel->view, scaled(SLIDER_PANEL_WIDTH),
+                       SLIDER_COUNT * panel->row_height);
+}
+
+// Left of the pointer, as the dock sits at the right of its monitor, unless
+// that leaves the monitor; vertically centered on the pointer.
+static void place(Panel *panel, int x, int y) {
+    const Monitor *mon = &app.monitor;
+    int offset         = (int)scaled(SLIDER_OFFSET);
+    int width          = (int)panel->view.width;
+    int height         = (int)panel->view.height;
+    panel->x           = x - offset - width;
+    panel->y           = y - (height / 2);
+    if (panel->x < mon->x) {
+        panel->x = x + offset;
+    }
+    if (panel->y + height > mon->y + (int)mon->height) {
+        panel->y = mon->y + (int)mon->height - height;
+    }
+    if (panel->y < mon->y) {
+        panel->y = mon->y;
+    }
+}
+
+// The track of every slider runs from the captions to the right edge, less
+// half a knob at each end.
+static int track_x(const Panel *panel) {
+    return (int)(panel->label_width + scaled(SLIDER_KNOB_WIDTH));
+}
+
+static uint32_t track_width(const Panel *panel) {
+    return panel->view.width - panel->label_width -
+           (2 * scaled(SLIDER_KNOB_WIDTH));
+}
+
+static void render(Panel *panel) {
+    Raster *view    = &panel->view;
+    uint32_t knob   = scaled(SLIDER_KNOB_WIDTH);
+    uint32_t track  = scaled(SLIDER_TRACK_HEIGHT);
+    uint32_t width  = track_width(panel);
+    uint32_t ascent = raster_text_ascent(panel->font_scale);
+    raster_fill_rect(view, 0, 0, view->width, view->height, BLACK);
+
+    for (size_t i = 0; i < SLIDER_COUNT; i++) {  // NOLINT(altera-unroll-loops)
+        const Slider *slider = &sliders[i];
+        int top              = (int)(i * panel->row_height);
+        int middle           = top + (int)(panel->row_height / 2);
+        int baseline         = middle + (int)(ascent / 2);
+        float range          = slider->max - slider->min;
+
+        char caption[NORD_TEXT_SIZE];
+        int len = snprintf(caption, sizeof(caption),
+                           slider->shift ? "%s %+.*f" : "%s %.*f",
+                           slider->name, slider->decimals, (double)values[i]);
+        raster_draw_text(view, (int)panel->pad, baseline, caption,
+                         len > 0 ? (size_t)len : 0, WHITE, panel->font_scale);
+
+        raster_fill_rect(view, track_x(panel), middle - (int)(track / 2),
+                         width, track, DARK_GREY);
+        int neutral = track_x(panel) +
+                      (int)((slider->neutral - slider->min) / range *
+                            (float)width);
+        raster_fill_rect(view, neutral, middle - (int)track, 1, 2 * track,
+                         LIGHT_GREY);
+        int at = track_x(panel) +
+                 (int)((values[i] - slider->min) / range * (float)width);
+        raster_fill_rect(view, at - (int)(knob / 2), top + (int)panel->pad,
+                         knob, panel->row_height - (2 * panel->pad), WHITE);
+    }
+}
+
+static void show(const Panel *panel) {
+    const Raster *view = &panel->view;
+    app.backend->put_image(panel->surface, 0, 0, view->width, view->height,
+                           view->pixels, view->stride);
+}
+
+// Transform the palette for the sliders as they stand and show them.
+static void draw_frame(Panel *panel) {
+    uint64_t start_ns       = stats_now_ns();
+    NordTransform transform = {
+        .hue         = values[SLIDER_HUE],
+        .lightness   = values[SLIDER_LIGHTNESS],
+        .chroma      = values[SLIDER_CHROMA],
+        .temperature = values[SLIDER_TEMPERATURE],
+    };
+    (void)transform_palette(&transform);
+    render(panel);
+    show(panel);
+    app.backend->flush();
+    stats_frame(start_ns);
+}
+
+// The slider under the point, or -1.
+static int row_at(const Panel *panel, int x, int y) {
+    if (x < panel->x || x >= panel->x + (int)panel->view.width ||
+        y < panel->y || y >= panel->y + (int)panel->view.height) {
+        return -1;
+    }
+    return (y - panel->y) / (int)panel->row_height;
+}
+
+// Move the slider to the pointer's position along its track. Returns
+// whether its value changed.
+static bool slide(const Panel *panel, int row, int x) {
+    const Slider *slider = &sliders[row];
+    float range          = slider->max - slider->min;
+    float neutral        = (slider->neutral - slider->min) / range;
+    float along          = (float)(x - panel->x - track_x(panel)) /
+                  (float)track_width(panel);
+    along = along < 0.0F ? 0.0F : along > 1.0F ? 1.0F : along;
+    if (along > neutral - SLIDER_SNAP && along < neutral + SLIDER_SNAP) {
+        along = neutral;
+    }
+    float value = slider->min + (along * range);
+    if (value == values[row]) {
+        return false;
+    }
+    values[row] = value;
+    return true;
+}
+
+int palette_sliders_run(int x, int y) {
+    const Backend *backend = app.backend;
+    Panel panel;
+    if (panel_init(&panel) != 0) {
+        return -1;
+    }
+    if (!backend->grab_pointer(true)) {
+        (void)fprintf(stderr, "Cannot grab the pointer to show the "
+                              "sliders.\n");
+        raster_free(&panel.view);
+        return -1;
+    }
+    place(&panel, x, y);
+    panel.surface = backend->open_popup(panel.x, panel.y, panel.view.width,
+                                        panel.view.height);
+    if (panel.surface != DOCK_SURFACE) {
+        draw_frame(&panel);
+    }
+
+    int dragging = -1;  // The slider held by the left button, or -1.
+    bool moved   = false;
+    bool done    = panel.surface == DOCK_SURFACE;
+    DockEvent ev;
+    while (!done && wait_event(backend, &ev)) {  // NOLINT(altera-unroll-loops)
+        bool changed = false;
+        do {  // NOLINT(altera-unroll-loops)
+            if (handle_background_event(&ev)) {
+                continue;
+            }
+            if (ev.surface == panel.surface && ev.type == EVENT_EXPOSE) {
+                show(&panel);
+            } else if (ev.type == EVENT_MOTION && dragging >= 0) {
+                if (slide(&panel, dragging, ev.root_x)) {
+                    changed = true;
+                }
+            } else if (ev.type == EVENT_BUTTON_RELEASE &&
+                       ev.button == BUTTON_LEFT) {
+                dragging = -1;
+            } else if (ev.type == EVENT_BUTTON_PRESS) {
+                int row = row_at(&panel, ev.root_x, ev.root_y);
+                if (ev.button == BUTTON_LEFT) {
+                    dragging = row;
+                    done     = row < 0;
+                    if (row >= 0 && slide(&panel, row, ev.root_x)) {
+                        changed = true;
+                    }
+                } else if (ev.button == BUTTON_RIGHT && row >= 0) {
+                    values[row] = sliders[row].neutral;
+                    changed     = true;
+                } else if (ev.button == BUTTON_MIDDLE) {
+                    for (size_t i = 0; i < SLIDER_COUNT; i++) {  // NOLINT
+                        values[i] = sliders[i].neutral;
+                    }
+                    changed = true;
+                }
+            }
+        } while (!done && backend->next_event(&ev));
+        if (changed && !done) {
+            draw_frame(&panel);
+            moved = true;
+        }
+    }
+
+    if (panel.surface != DOCK_SURFACE) {
+        backend->close_popup(panel.surface);
+    }
+    backend->grab_pointer(false);
+    // Readers of the shared palette see the result once, not every frame.
+    if (moved) {
+        palette_shm_update();
+    }
+    backend->flush();
+    raster_free(&panel.view);
+    return 0;
+}
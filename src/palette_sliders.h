@@ -0,0 +1,36 @@
+/*
+ * Filename: palette_sliders.h
+ *
+ * Description: Declarations for the palette sliders, opened by Shift+right
+ * clicking a box. A floating panel of sliders turns the hue of the whole
+ * palette and scales its lightness and chroma in OKLCH, or moves its white
+ * point warmer or cooler, and the boxes follow while a slider is dragged.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef PALETTE_SLIDERS_H
+#define PALETTE_SLIDERS_H
+
+// Panel layout, in 96 DPI pixels.
+#define SLIDER_PANEL_WIDTH 280
+#define SLIDER_LABEL_WIDTH 110  // Captions, left of the tracks.
+#define SLIDER_ROW_HEIGHT 22
+#define SLIDER_TRACK_HEIGHT 4
+#define SLIDER_KNOB_WIDTH 6
+#define SLIDER_OFFSET 24  // Distance from the pointer.
+
+// A slider snaps to its neutral value within this fraction of its track,
+// so the untouched palette can be found again.
+#define SLIDER_SNAP 0.02F
+
+// Show the sliders with the pointer at x, y, and change the palette as they
+// are dragged until a left click outside the panel closes it. A right click
+// on a slider puts it back to neutral and a middle click resets all of them.
+// The palette keeps its last transform. Returns 0 once the panel is closed,
+// or -1 if the backend cannot grab the pointer.
+int palette_sliders_run(int x, int y);
+
+#endif  // PALETTE_SLIDERS_H
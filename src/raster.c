@@ -0,0 +1,448 @@
+/*
+ * Filename: raster.c
+ *
+ * Description: Implements the client-side software rasterizer used by
+ * backends that do not have a display server to draw for them, and by the
+ * Xlib backend's shared-memory rendering path.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include "raster.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "builtin_font.h"
+
+int raster_init(Raster *raster, uint32_t width, uint32_t height) {
+    raster->pixels = calloc((size_t)width * height, sizeof(uint32_t));
+    if (!raster->pixels) {
+        return -1;
+    }
+    raster->width  = width;
+    raster->height = height;
+    raster->stride = width;
+    return 0;
+}
+
+void raster_free(Raster *raster) {
+    free(raster->pixels);
+    raster->pixels = nullptr;
+    raster->width  = 0;
+    raster->height = 0;
+    raster->stride = 0;
+}
+
+// Fill one row four pixels at a time.
+static void fill_row(uint32_t *dst, size_t count, uint32_t color) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i value = _mm_set1_epi32((int)color);
+    for (; i + 4 <= count; i += 4) {  // NOLINT(altera-unroll-loops)
+        _mm_storeu_si128((__m128i *)(dst + i), value);
+    }
+#elif defined(__ARM_NEON)
+    uint32x4_t value = vdupq_n_u32(color);
+    for (; i + 4 <= count; i += 4) {  // NOLINT(altera-unroll-loops)
+        vst1q_u32(dst + i, value);
+    }
+#endif
+    for (; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        dst[i] = color;
+    }
+}
+
+void raster_fill_rect(Raster *raster, int x, int y, uint32_t width,
+                      uint32_t height, uint32_t color) {
+    int64_t x0 = x < 0 ? 0 : x;
+    int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = (int64_t)x + width;
+    int64_t y1 = (int64_t)y + height;
+    if (x1 > raster->width) {
+        x1 = raster->width;
+    }
+    if (y1 > raster->height) {
+        y1 = raster->height;
+    }
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    // Fill the first row, then copy it down.
+    size_t count    = (size_t)(x1 - x0);
+    uint32_t *first = raster->pixels + (y0 * raster->stride) + x0;
+    fill_row(first, count, color);
+    for (int64_t row = y0 + 1; row < y1;  // NOLINT(altera-unroll-loops)
+         row++) {
+        memcpy(raster->pixels + (row * raster->stride) + x0, first,
+               count * sizeof(uint32_t));
+    }
+}
+
+// One channel of a ramp in 16.16 fixed point, rounded to the nearest level.
+static int32_t ramp_start(uint32_t from, uint32_t shift) {
+    return (int32_t)(((from >> shift) & 0xFFU) << 16U) + 0x8000;
+}
+
+static int32_t ramp_step(uint32_t from, uint32_t to, uint32_t shift,
+                         size_t span) {
+    int32_t a = (int32_t)((from >> shift) & 0xFFU);
+    int32_t b = (int32_t)((to >> shift) & 0xFFU);
+    return (int32_t)(((int64_t)(b - a) * 65536) / (int64_t)span);
+}
+
+static uint32_t ramp_pixel(const int32_t *start, const int32_t *step,
+                           size_t i) {
+    uint32_t r = (uint32_t)((start[0] + ((int32_t)i * step[0])) >> 16);
+    uint32_t g = (uint32_t)((start[1] + ((int32_t)i * step[1])) >> 16);
+    uint32_t b = (uint32_t)((start[2] + ((int32_t)i * step[2])) >> 16);
+    return (r << 16U) | (g << 8U) | b;
+}
+
+// Write pixels first to first + count of a ramp that moves from one color
+// to the other over span pixels, four pixels at a time.
+static void ramp_row(uint32_t *dst, size_t first, size_t count, size_t span,
+                     uint32_t from, uint32_t to) {
+    int32_t start[3];
+    int32_t step[3];
+    for (uint32_t c = 0; c < 3; c++) {  // NOLINT(altera-unroll-loops)
+        uint32_t shift = 16U - (8U * c);
+        step[c]        = ramp_step(from, to, shift, span);
+        start[c]       = ramp_start(from, shift) + ((int32_t)first * step[c]);
+    }
+
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i value[3];
+    __m128i advance[3];
+    for (uint32_t c = 0; c < 3; c++) {  // NOLINT(altera-unroll-loops)
+        value[c]   = _mm_set_epi32(start[c] + (3 * step[c]),
+                                   start[c] + (2 * step[c]),
+                                   start[c] + step[c], start[c]);
+        advance[c] = _mm_set1_epi32(4 * step[c]);
+    }
+    for (; i + 4 <= count; i += 4) {  // NOLINT(altera-unroll-loops)
+        __m128i r = _mm_slli_epi32(_mm_srai_epi32(value[0], 16), 16);
+        __m128i g = _mm_slli_epi32(_mm_srai_epi32(value[1], 16), 8);
+        __m128i b = _mm_srai_epi32(value[2], 16);
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         _mm_or_si128(_mm_or_si128(r, g), b));
+        for (uint32_t c = 0; c < 3; c++) {  // NOLINT(altera-unroll-loops)
+            value[c] = _mm_add_epi32(value[c], advance[c]);
+        }
+    }
+#elif defined(__ARM_NEON)
+    int32x4_t value[3];
+    int32x4_t advance[3];
+    for (uint32_t c = 0; c < 3; c++) {  // NOLINT(altera-unroll-loops)
+        const int32_t lanes[4] = { start[c], start[c] + step[c],
+                                   start[c] + (2 * step[c]),
+                                   start[c] + (3 * step[c]) };
+        value[c]               = vld1q_s32(lanes);
+        advance[c]             = vdupq_n_s32(4 * step[c]);
+    }
+    for (; i + 4 <= count; i += 4) {  // NOLINT(altera-unroll-loops)
+        int32x4_t r = vshlq_n_s32(vshrq_n_s32(value[0], 16), 16);
+        int32x4_t g = vshlq_n_s32(vshrq_n_s32(value[1], 16), 8);
+        int32x4_t b = vshrq_n_s32(value[2], 16);
+        vst1q_u32(dst + i, vreinterpretq_u32_s32(vorrq_s32(vorrq_s32(r, g),
+                                                          b)));
+        for (uint32_t c = 0; c < 3; c++) {  // NOLINT(altera-unroll-loops)
+            value[c] = vaddq_s32(value[c], advance[c]);
+        }
+    }
+#endif
+    for (; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        dst[i] = ramp_pixel(start, step, i);
+    }
+}
+
+void raster_fill_gradient(Raster *raster, int x, int y, uint32_t width,
+                          uint32_t height, const uint32_t *stops,
+                          size_t count) {
+    if (count < 2 || width < 2) {
+        if (count > 0) {
+            raster_fill_rect(raster, x, y, width, height, stops[0]);
+        }
+        return;
+    }
+    int64_t x0 = x < 0 ? 0 : x;
+    int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = (int64_t)x + width;
+    int64_t y1 = (int64_t)y + height;
+    if (x1 > raster->width) {
+        x1 = raster->width;
+    }
+    if (y1 > raster->height) {
+        y1 = raster->height;
+    }
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    // Each segment reaches its next stop one pixel past its end, where the
+    // following segment starts; the last one reaches it on its last pixel.
+    uint32_t *row   = raster->pixels + (y0 * raster->stride);
+    size_t segments = count - 1;
+    for (size_t s = 0; s < segments; s++) {  // NOLINT(altera-unroll-loops)
+        int64_t left  = x + (int64_t)(((uint64_t)width * s) / segments);
+        int64_t right = x + (int64_t)(((uint64_t)width * (s + 1)) / segments);
+        int64_t from  = left > x0 ? left : x0;
+        int64_t to    = right < x1 ? right : x1;
+        size_t span   = (size_t)(right - left);
+        if (s + 1 == segments && span > 1) {
+            span--;
+        }
+        if (from < to && span > 0) {
+            ramp_row(row + from, (size_t)(from - left), (size_t)(to - from),
+                     span, stops[s], stops[s + 1]);
+        }
+    }
+    for (int64_t r = y0 + 1; r < y1; r++) {  // NOLINT(altera-unroll-loops)
+        memcpy(raster->pixels + (r * raster->stride) + x0, row + x0,
+               (size_t)(x1 - x0) * sizeof(uint32_t));
+    }
+}
+
+void raster_scale_nearest(Raster *raster, int x, int y, const Raster *src,
+                          uint32_t factor) {
+    if (factor == 0) {
+        return;
+    }
+    // Every source pixel becomes a vector-filled run of factor pixels; each
+    // output row is then copied down factor - 1 times.
+    for (uint32_t sy = 0; sy < src->height; sy++) {  // NOLINT
+        int64_t top = (int64_t)y + ((int64_t)sy * factor);
+        if (top >= raster->height) {
+            break;
+        }
+        int64_t row0 = top < 0 ? 0 : top;
+        int64_t row1 = top + factor;
+        if (row1 > raster->height) {
+            row1 = raster->height;
+        }
+        if (row0 >= row1) {
+            continue;
+        }
+
+        uint32_t *first      = raster->pixels + (row0 * raster->stride);
+        const uint32_t *line = src->pixels + ((size_t)sy * src->stride);
+        int64_t x0           = raster->width;
+        int64_t x1           = 0;
+        for (uint32_t sx = 0; sx < src->width; sx++) {  // NOLINT
+            int64_t left  = (int64_t)x + ((int64_t)sx * factor);
+            int64_t right = left + factor;
+            left          = left < 0 ? 0 : left;
+            right         = right > raster->width ? raster->width : right;
+            if (left >= right) {
+                continue;
+            }
+            fill_row(first + left, (size_t)(right - left), line[sx]);
+            x0 = left < x0 ? left : x0;
+            x1 = right;
+        }
+        for (int64_t row = row0 + 1; row < row1;  // NOLINT
+             row++) {
+            memcpy(raster->pixels + (row * raster->stride) + x0, first + x0,
+                   (size_t)(x1 - x0) * sizeof(uint32_t));
+        }
+    }
+}
+
+static void draw_glyph(Raster *raster, int x, int top, unsigned char ch,
+                       uint32_t color, uint32_t scale) {
+    if (ch < BUILTIN_FONT_FIRST || ch > BUILTIN_FONT_LAST) {
+        ch = '?';
+    }
+    const uint8_t *rows = builtin_font[ch - BUILTIN_FONT_FIRST];
+    if (scale > 1) {
+        for (int gy = 0; gy < BUILTIN_FONT_HEIGHT; gy++) {  // NOLINT
+            for (int gx = 0; gx < BUILTIN_FONT_WIDTH; gx++) {  // NOLINT
+                if (rows[gy] & (0x80U >> (unsigned)gx)) {
+                    raster_fill_rect(raster, x + (gx * (int)scale),
+                                     top + (gy * (int)scale), scale, scale,
+                                     color);
+                }
+            }
+        }
+        return;
+    }
+    for (int gy = 0; gy < BUILTIN_FONT_HEIGHT;  // NOLINT(altera-unroll-loops)
+         gy++) {
+        int py = top + gy;
+        if (py < 0 || py >= (int)raster->height || !rows[gy]) {
+            continue;
+        }
+        uint32_t *dst = raster->pixels + ((size_t)py * raster->stride);
+        for (int gx = 0; gx < BUILTIN_FONT_WIDTH;  // NOLINT(altera-unroll-loops)
+             gx++) {
+            int px = x + gx;
+            if ((rows[gy] & (0x80U >> (unsigned)gx)) && px >= 0 &&
+                px < (int)raster->width) {
+                dst[px] = color;
+            }
+        }
+    }
+}
+
+void raster_draw_text(Raster *raster, int x, int y, const char *text,
+                      size_t len, uint32_t color, uint32_t scale) {
+    int top = y - (BUILTIN_FONT_ASCENT * (int)scale);
+    for (size_t i = 0; i < len; i++) {  // NOLINT(altera-unroll-loops)
+        draw_glyph(raster, x + (int)(i * BUILTIN_FONT_WIDTH * scale), top,
+                   (unsigned char)text[i], color, scale);
+    }
+}
+
+TextMetrics raster_text_metrics(const char *text, size_t len, uint32_t scale) {
+    TextMetrics metrics = { 0, 0 };
+    if (!text) {
+        return metrics;
+    }
+    metrics.width  = (uint32_t)(len * BUILTIN_FONT_WIDTH * scale);
+    metrics.height = BUILTIN_FONT_HEIGHT * scale;
+    return metrics;
+}
+
+uint32_t raster_text_ascent(uint32_t scale) {
+    return BUILTIN_FONT_ASCENT * scale;
+}
+
+int glyph_cache_set(GlyphCache *cache, unsigned char ch,
+                    const uint8_t *coverage, uint32_t width, uint32_t height,
+                    int pitch, int left, int top, int advance) {
+    if (ch < GLYPH_CACHE_FIRST || ch > GLYPH_CACHE_LAST) {
+        return -1;
+    }
+    RasterGlyph *glyph = &cache->glyphs[ch - GLYPH_CACHE_FIRST];
+    free(glyph->coverage);
+    memset(glyph, 0, sizeof(*glyph));
+    glyph->left    = left;
+    glyph->top     = top;
+    glyph->advance = advance;
+    if (width == 0 || height == 0) {
+        return 0;
+    }
+
+    glyph->coverage = malloc((size_t)width * height);
+    if (!glyph->coverage) {
+        return -1;
+    }
+    for (uint32_t row = 0; row < height; row++) {  // NOLINT
+        memcpy(glyph->coverage + ((size_t)row * width),
+               coverage + ((ptrdiff_t)row * pitch), width);
+    }
+    glyph->width  = width;
+    glyph->height = height;
+    return 0;
+}
+
+int glyph_cache_init_builtin(GlyphCache *cache, uint32_t scale) {
+    uint32_t width  = BUILTIN_FONT_WIDTH * scale;
+    uint32_t height = BUILTIN_FONT_HEIGHT * scale;
+    uint8_t *bitmap = malloc((size_t)width * height);
+    if (!bitmap) {
+        return -1;
+    }
+
+    int status = 0;
+    for (int ch = GLYPH_CACHE_FIRST; ch <= GLYPH_CACHE_LAST;  // NOLINT
+         ch++) {
+        const uint8_t *rows = builtin_font[ch - BUILTIN_FONT_FIRST];
+        for (uint32_t py = 0; py < height; py++) {  // NOLINT
+            for (uint32_t px = 0; px < width; px++) {  // NOLINT
+                bool set = rows[py / scale] & (0x80U >> (px / scale));
+                bitmap[(py * width) + px] = set ? 0xFF : 0x00;
+            }
+        }
+        if (glyph_cache_set(cache, (unsigned char)ch, bitmap, width, height,
+                            (int)width, 0, BUILTIN_FONT_ASCENT * (int)scale,
+                            (int)width) != 0) {
+            status = -1;
+            break;
+        }
+    }
+    free(bitmap);
+    cache->ascent  = BUILTIN_FONT_ASCENT * scale;
+    cache->descent = (BUILTIN_FONT_HEIGHT - BUILTIN_FONT_ASCENT) * scale;
+    return status;
+}
+
+void glyph_cache_free(GlyphCache *cache) {
+    for (size_t i = 0;  // NOLINT(altera-unroll-loops)
+         i < sizeof(cache->glyphs) / sizeof(cache->glyphs[0]); i++) {
+        free(cache->glyphs[i].coverage);
+    }
+    memset(cache, 0, sizeof(*cache));
+}
+
+// Mix color into dst by an 8-bit coverage value.
+static uint32_t blend(uint32_t dst, uint32_t color, uint32_t alpha) {
+    uint32_t out = 0;
+    for (unsigned int shift = 0; shift < 24;  // NOLINT(altera-unroll-loops)
+         shift += 8) {
+        uint32_t src = (color >> shift) & 0xFFU;
+        uint32_t old = (dst >> shift) & 0xFFU;
+        out |= ((src * alpha + old * (255U - alpha) + 127U) / 255U) << shift;
+    }
+    return out;
+}
+
+static void blit_glyph(Raster *raster, int x, int y, const RasterGlyph *glyph,
+                       uint32_t color) {
+    for (uint32_t gy = 0; gy < glyph->height; gy++) {  // NOLINT
+        int py = y + (int)gy;
+        if (py < 0 || py >= (int)raster->height) {
+            continue;
+        }
+        const uint8_t *src = glyph->coverage + ((size_t)gy * glyph->width);
+        uint32_t *dst      = raster->pixels + ((size_t)py * raster->stride);
+        for (uint32_t gx = 0; gx < glyph->width; gx++) {  // NOLINT
+            int px = x + (int)gx;
+            if (!src[gx] || px < 0 || px >= (int)raster->width) {
+                continue;
+            }
+            dst[px] = src[gx] == 0xFF ? color : blend(dst[px], color, src[gx]);
+        }
+    }
+}
+
+void raster_draw_glyphs(Raster *raster, int x, int y, const GlyphCache *cache,
+                        const char *text, size_t len, uint32_t color) {
+    for (size_t i = 0; i < len; i++) {  // NOLINT(altera-unroll-loops)
+        unsigned char ch = (unsigned char)text[i];
+        if (ch < GLYPH_CACHE_FIRST || ch > GLYPH_CACHE_LAST) {
+            ch = '?';
+        }
+        const RasterGlyph *glyph = &cache->glyphs[ch - GLYPH_CACHE_FIRST];
+        if (glyph->coverage) {
+            blit_glyph(raster, x + glyph->left, y - glyph->top, glyph, color);
+        }
+        x += glyph->advance;
+    }
+}
+
+TextMetrics glyph_cache_metrics(const GlyphCache *cache, const char *text,
+                                size_t len) {
+    TextMetrics metrics = { 0, cache->ascent + cache->descent };
+    for (size_t i = 0; i < len; i++) {  // NOLINT(altera-unroll-loops)
+        unsigned char ch = (unsigned char)text[i];
+        if (ch < GLYPH_CACHE_FIRST || ch > GLYPH_CACHE_LAST) {
+            ch = '?';
+        }
+        metrics.width +=
+            (uint32_t)cache->glyphs[ch - GLYPH_CACHE_FIRST].advance;
+    }
+    return metrics;
+}
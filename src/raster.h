@@ -0,0 +1,99 @@
+/*
+ * Filename: raster.h
+ *
+ * Description: Declarations for the client-side software rasterizer, which
+ * draws rectangles and text into a 32-bit XRGB framebuffer. Text comes
+ * either straight from the builtin font or from a glyph cache of
+ * antialiased coverage bitmaps.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "backend.h"
+
+// A 32-bit XRGB framebuffer. The stride is measured in pixels.
+typedef struct {
+    uint32_t *pixels;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+} Raster;
+
+// Allocate a cleared framebuffer. Returns 0 on success or -1 on error.
+int raster_init(Raster *raster, uint32_t width, uint32_t height);
+void raster_free(Raster *raster);
+
+// Drawing is clipped to the framebuffer bounds.
+void raster_fill_rect(Raster *raster, int x, int y, uint32_t width,
+                      uint32_t height, uint32_t color);
+
+// Fill the area with a left-to-right gradient through count evenly spaced
+// stops, blended in sRGB between neighbouring stops as CSS does. Pixels are
+// generated four at a time with SSE2 or NEON where available.
+void raster_fill_gradient(Raster *raster, int x, int y, uint32_t width,
+                          uint32_t height, const uint32_t *stops,
+                          size_t count);
+
+// Draw src enlarged factor times with nearest-neighbour sampling, with its
+// top-left corner at x, y.
+void raster_scale_nearest(Raster *raster, int x, int y, const Raster *src,
+                          uint32_t factor);
+
+// Draw text with its baseline at y using the builtin font, with every font
+// pixel enlarged to a scale x scale block.
+void raster_draw_text(Raster *raster, int x, int y, const char *text,
+                      size_t len, uint32_t color, uint32_t scale);
+
+TextMetrics raster_text_metrics(const char *text, size_t len, uint32_t scale);
+
+// Height of the builtin font above its baseline.
+uint32_t raster_text_ascent(uint32_t scale);
+
+#define GLYPH_CACHE_FIRST 0x20
+#define GLYPH_CACHE_LAST 0x7E
+
+// An 8-bit coverage bitmap for one character.
+typedef struct {
+    uint8_t *coverage;  // width * height bytes, or nullptr for blank glyphs.
+    uint32_t width;
+    uint32_t height;
+    int left;     // Pen position to the bitmap's left edge.
+    int top;      // Baseline to the bitmap's top edge, upwards.
+    int advance;  // Pen movement after the glyph.
+} RasterGlyph;
+
+// Rendered glyphs for printable ASCII, built once per font and size.
+typedef struct {
+    RasterGlyph glyphs[GLYPH_CACHE_LAST - GLYPH_CACHE_FIRST + 1];
+    uint32_t ascent;
+    uint32_t descent;
+} GlyphCache;
+
+// Store a copy of a coverage bitmap whose rows are pitch bytes apart.
+// Returns 0 on success or -1 on error.
+int glyph_cache_set(GlyphCache *cache, unsigned char ch,
+                    const uint8_t *coverage, uint32_t width, uint32_t height,
+                    int pitch, int left, int top, int advance);
+
+// Fill the cache from the builtin font enlarged by scale. Returns 0 on
+// success or -1 on error.
+int glyph_cache_init_builtin(GlyphCache *cache, uint32_t scale);
+
+void glyph_cache_free(GlyphCache *cache);
+
+// Blend text from the cache with its baseline at y.
+void raster_draw_glyphs(Raster *raster, int x, int y, const GlyphCache *cache,
+                        const char *text, size_t len, uint32_t color);
+
+TextMetrics glyph_cache_metrics(const GlyphCache *cache, const char *text,
+                                size_t len);
+
+#endif  // RASTER_H
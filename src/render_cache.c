@@ -0,0 +1,282 @@
+/*
+ * Filename: render_cache.c
+ *
+ * Description: Implements the render cache. An entry is a small header and
+ * the dock's pixels as the backend keeps them, in one file named after its
+ * key. It is mapped and handed to the backend in one put, and stays mapped
+ * until the check has compared it with the dock drawn for real. New entries
+ * are written to a temporary file by a worker and renamed into place, so a
+ * reader never sees half of one.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "render_cache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "app_context.h"
+#include "color_box.h"
+#include "idle.h"
+#include "stats.h"
+#include "workers.h"
+
+#define RENDER_CACHE_MAGIC "ANDFRAME"
+
+// 64-bit FNV-1a.
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+// The pixels follow the header, width x height of them, rows packed.
+typedef struct {
+    char magic[8];
+    uint64_t key;
+    uint32_t width;
+    uint32_t height;
+} FrameHeader;
+
+static struct {
+    bool disabled;
+    bool tried;   // The first frame has been drawn, from the cache or not.
+    bool queued;  // The check has been queued.
+    uint64_t key;
+    const FrameHeader *entry;  // Entry shown, mapped, until it is checked.
+    size_t entry_size;
+    size_t next_box;  // Next box the check draws over a cached frame.
+} cache;
+
+// A frame on its way to disk. The main thread leaves it alone until the
+// worker is done.
+static struct {
+    char parent[RENDER_CACHE_PATH_SIZE];
+    char dir[RENDER_CACHE_PATH_SIZE];
+    char path[RENDER_CACHE_PATH_SIZE];
+    FrameHeader *frame;
+    size_t size;
+} job;
+
+void render_cache_disable(void) {
+    cache.disabled = true;
+}
+
+static uint64_t hash(uint64_t h, const void *data, size_t len) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < len; i++) {  // NOLINT(altera-unroll-loops)
+        h = (h ^ bytes[i]) * FNV_PRIME;
+    }
+    return h;
+}
+
+// Everything the drawn dock depends on: the backend and how it draws, with
+// its label font sized from the scale and the box size, the layout and the
+// boxes.
+static uint64_t dock_key(void) {
+    const char *backend = app.backend->name;
+    const char *tag     = app.backend->render_tag();
+    uint32_t layout[]   = { RENDER_CACHE_VERSION, app.dock_width,
+                            app.dock_height,      app.rect_size,
+                            app.columns,          app.monitor.height };
+    uint64_t h          = hash(FNV_OFFSET, backend, strlen(backend) + 1);
+    h                   = hash(h, tag, strlen(tag) + 1);
+    h                   = hash(h, layout, sizeof(layout));
+    h                   = hash(h, &app.scale, sizeof(app.scale));
+    for (size_t i = 0; i < PALETTE_LENGTH; i++) {  // NOLINT
+        const ColorBox *box = palette_box(i);
+        h = hash(h, &box->color, sizeof(box->color));
+        h = hash(h, box->label, box->label_length);
+    }
+    return h;
+}
+
+static size_t frame_size(uint32_t width, uint32_t height) {
+    return sizeof(FrameHeader) + ((size_t)width * height * sizeof(uint32_t));
+}
+
+static const uint32_t *frame_pixels(const FrameHeader *frame) {
+    return (const uint32_t *)(frame + 1);
+}
+
+// The cache directory and the one holding it, and the entry for the key.
+static bool entry_paths(char *parent, char *dir, char *path, uint64_t key) {
+    const char *base = getenv("XDG_CACHE_HOME");  // NOLINT
+    const char *home = getenv("HOME");            // NOLINT
+    int len          = 0;
+    if (base && base[0] == '/') {
+        len = snprintf(parent, RENDER_CACHE_PATH_SIZE, "%s", base);
+    } else if (home && home[0] == '/') {
+        len = snprintf(parent, RENDER_CACHE_PATH_SIZE, "%s/.cache", home);
+    } else {
+        return false;
+    }
+    if (len <= 0 || len >= RENDER_CACHE_PATH_SIZE) {
+        return false;
+    }
+    len = snprintf(dir, RENDER_CACHE_PATH_SIZE, "%s/" RENDER_CACHE_DIR,
+                   parent);
+    if (len <= 0 || len >= RENDER_CACHE_PATH_SIZE) {
+        return false;
+    }
+    len = snprintf(path, RENDER_CACHE_PATH_SIZE, "%s/%016llx.frame", dir,
+                   (unsigned long long)key);
+    return len > 0 && len < RENDER_CACHE_PATH_SIZE;
+}
+
+static void release_entry(void) {
+    if (cache.entry) {
+        (void)munmap((void *)cache.entry, cache.entry_size);
+        cache.entry = nullptr;
+    }
+}
+
+bool render_cache_show(void) {
+    if (cache.tried) {
+        return false;
+    }
+    cache.tried = true;
+    char parent[RENDER_CACHE_PATH_SIZE];
+    char dir[RENDER_CACHE_PATH_SIZE];
+    char path[RENDER_CACHE_PATH_SIZE];
+    cache.key = dock_key();
+    if (cache.disabled || !entry_paths(parent, dir, path, cache.key)) {
+        return false;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    size_t size = frame_size(app.dock_width, app.dock_height);
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (uint64_t)st.st_size == size) {
+        map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    (void)close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    cache.entry      = map;
+    cache.entry_size = size;
+
+    const FrameHeader *entry = cache.entry;
+    if (memcmp(entry->magic, RENDER_CACHE_MAGIC, sizeof(entry->magic)) != 0 ||
+        entry->key != cache.key || entry->width != app.dock_width ||
+        entry->height != app.dock_height ||
+        !app.backend->put_dock(frame_pixels(entry), entry->width,
+                               entry->height, entry->width)) {
+        release_entry();
+        return false;
+    }
+    stats.cache_hits++;
+    return true;
+}
+
+static bool write_all(int fd, const void *data, size_t size) {
+    const char *bytes = data;
+    while (size > 0) {  // NOLINT(altera-unroll-loops)
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+static void write_run(void *data) {
+    (void)data;
+    char temp[RENDER_CACHE_PATH_SIZE + 16];
+    (void)mkdir(job.parent, 0700);
+    (void)mkdir(job.dir, 0700);
+    (void)snprintf(temp, sizeof(temp), "%s.%ld", job.path, (long)getpid());
+    int fd = open(temp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return;
+    }
+    bool ok = write_all(fd, job.frame, job.size);
+    if (close(fd) != 0 || !ok || rename(temp, job.path) != 0) {
+        (void)unlink(temp);
+    }
+}
+
+static void write_done(void *data) {
+    (void)data;
+    free(job.frame);
+    job.frame = nullptr;
+}
+
+// Read the dock back and write it unless the entry shown matches. A box
+// held down, selected or highlighted is not how the dock starts, so nothing
+// is written then; the next start tries again.
+static void check_frame(void) {
+    uint32_t width     = app.dock_width;
+    uint32_t height    = app.dock_height;
+    size_t size        = frame_size(width, height);
+    FrameHeader *frame = nullptr;
+    if (!get_last_clicked_box() && selection_count() == 0 &&
+        !highlighted_box()) {
+        frame = malloc(size);
+    }
+    if (!frame || !app.backend->read_dock((uint32_t *)(frame + 1), width,
+                                          height, width)) {
+        free(frame);
+        release_entry();
+        return;
+    }
+    memcpy(frame->magic, RENDER_CACHE_MAGIC, sizeof(frame->magic));
+    frame->key    = dock_key();
+    frame->width  = width;
+    frame->height = height;
+
+    bool same = cache.entry && cache.entry_size == size &&
+                memcmp(cache.entry, frame, size) == 0;
+    release_entry();
+    if (same || !entry_paths(job.parent, job.dir, job.path, frame->key)) {
+        free(frame);
+        return;
+    }
+    job.frame = frame;
+    job.size  = size;
+    if (!workers_submit(write_run, write_done, nullptr)) {
+        write_run(nullptr);
+        write_done(nullptr);
+    }
+}
+
+// Idle task: draw one box over the cached frame per step, then check the
+// whole dock.
+static bool check_step(void *data) {
+    (void)data;
+    if (cache.entry && cache.next_box < PALETTE_LENGTH) {
+        draw_colorbox(palette_box(cache.next_box++));
+        return false;
+    }
+    app.backend->flush();
+    check_frame();
+    return true;
+}
+
+void render_cache_check(void) {
+    if (cache.queued || !cache.tried || cache.disabled) {
+        return;
+    }
+    cache.queued = true;
+    (void)idle_queue(check_step, nullptr, IDLE_NO_BOX);
+}
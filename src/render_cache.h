@@ -0,0 +1,42 @@
+/*
+ * Filename: render_cache.h
+ *
+ * Description: Declarations for the render cache, which keeps the drawn dock
+ * on disk so the next start can put it up before the label font is opened
+ * or a box is drawn. Entries are keyed by the palette and labels, the dock's
+ * size and layout, its scale, the backend and its render tag, which names
+ * the pixel format, drawing path and font the frame depends on. A shown
+ * entry is checked against a real drawing in the background and replaced
+ * if it differs.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef RENDER_CACHE_H
+#define RENDER_CACHE_H
+
+// Entries live in $XDG_CACHE_HOME/RENDER_CACHE_DIR, or ~/.cache without it.
+#define RENDER_CACHE_DIR "arctic-nord-dock"
+#define RENDER_CACHE_PATH_SIZE 512
+
+// Changed whenever the way the dock is drawn changes, so old entries are
+// never shown.
+#define RENDER_CACHE_VERSION 1U
+
+// Neither read nor write the cache.
+void render_cache_disable(void);
+
+// Put up the cached frame for the dock as it is laid out, the first time
+// the dock is drawn. Returns true if a matching entry was shown, in which
+// case the caller flushes instead of drawing the boxes.
+bool render_cache_show(void);
+
+// Queue the idle task that follows the first frame. After a cached frame it
+// draws the boxes, one per step, and compares the result with the entry;
+// after a drawn one it reads the dock back. An entry that is missing or
+// differs is written by a worker. Does nothing after the first call.
+void render_cache_check(void);
+
+#endif  // RENDER_CACHE_H
@@ -0,0 +1,378 @@
+/*
+ * Filename: selection_server.c
+ *
+ * Description: Implements serving an X selection: replies to conversion
+ * requests, INCR transfers paced by the requestors' property deletions, and
+ * cleanup after requestors that disappear or stall.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "selection_server.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "stats.h"
+
+#define NS_PER_MS 1000000ULL
+#define NS_PER_S 1000000000ULL
+#define REQUEST_HEADER_BYTES 256  // Room left for the ChangeProperty header.
+
+// Xlib has a single error handler, so the server it protects is global.
+static SelectionServer *active        = nullptr;
+static XErrorHandler previous_handler = nullptr;
+
+static void release(SelectionData *data) {
+    if (data && --data->refs == 0) {
+        free(data->bytes);
+        free(data);
+    }
+}
+
+// Free a transfer's entry. Input selection on the requestor is withdrawn
+// with its last transfer, unless the window is known to be gone.
+static void end_transfer(SelectionServer *server, SelectionTransfer *transfer,
+                         bool window_exists) {
+    Window requestor = transfer->requestor;
+    release(transfer->data);
+    memset(transfer, 0, sizeof(*transfer));
+    if (!window_exists) {
+        return;
+    }
+    for (size_t i = 0; i < SELECTION_MAX_TRANSFERS; i++) {  // NOLINT
+        if (server->transfers[i].requestor == requestor) {
+            return;
+        }
+    }
+    XSelectInput(server->display, requestor, NoEventMask);
+}
+
+static void end_requestor(SelectionServer *server, Window requestor) {
+    for (size_t i = 0; i < SELECTION_MAX_TRANSFERS; i++) {  // NOLINT
+        if (server->transfers[i].requestor == requestor) {
+            end_transfer(server, &server->transfers[i], false);
+        }
+    }
+}
+
+// Requestors may destroy their windows at any time, so requests to windows
+// that no longer exist are expected to fail; they only end the transfers.
+// Xlib can call this while a chunk is being sent, so the transfers are only
+// marked here and freed on the next pass.
+static int catch_requestor_error(Display *display, XErrorEvent *error) {
+    bool requestor_request = error->request_code == X_ChangeProperty ||
+                             error->request_code == X_SendEvent ||
+                             error->request_code == X_ChangeWindowAttributes;
+    if (active && error->error_code == BadWindow && requestor_request &&
+        error->resourceid != active->owner) {
+        for (size_t i = 0; i < SELECTION_MAX_TRANSFERS; i++) {  // NOLINT
+            if (active->transfers[i].requestor == error->resourceid) {
+                active->transfers[i].gone = true;
+            }
+        }
+        return 0;
+    }
+    return previous_handler ? previous_handler(display, error) : 0;
+}
+
+void selection_server_init(SelectionServer *server, Display *display,
+                           Window owner, const SelectionAtoms *atoms) {
+    memset(server, 0, sizeof(*server));
+    server->display = display;
+    server->owner   = owner;
+    server->atoms   = *atoms;
+
+    long max_request = XExtendedMaxRequestSize(display);
+    if (max_request == 0) {
+        max_request = XMaxRequestSize(display);
+    }
+    size_t limit  = ((size_t)max_request * 4) - REQUEST_HEADER_BYTES;
+    server->chunk = limit < SELECTION_CHUNK ? limit : SELECTION_CHUNK;
+    // Without the timer, stalled transfers are dropped by later traffic.
+    server->timer_fd =
+        timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    active           = server;
+    previous_handler = XSetErrorHandler(catch_requestor_error);
+}
+
+void selection_server_free(SelectionServer *server) {
+    for (size_t i = 0; i < SELECTION_MAX_TRANSFERS; i++) {  // NOLINT
+        if (server->transfers[i].requestor) {
+            end_transfer(server, &server->transfers[i], false);
+        }
+    }
+    release(server->data);
+    server->data    = nullptr;
+    server->display = nullptr;
+    if (server->timer_fd >= 0) {
+        (void)close(server->timer_fd);
+        server->timer_fd = -1;
+    }
+    if (active == server) {
+        XSetErrorHandler(previous_handler);
+        active = nullptr;
+    }
+}
+
+int selection_server_own(SelectionServer *server, const char *text,
+                         size_t len) {
+    if (len > SELECTION_MAX_BYTES) {
+        len = SELECTION_MAX_BYTES;
+    }
+    // Reuse the buffer unless a transfer is still sending it.
+    SelectionData *data = server->data;
+    if (!data || data->refs > 1 || data->capacity < len) {
+        data = calloc(1, sizeof(*data));
+        if (!data || !(data->bytes = malloc(len ? len : 1))) {
+            free(data);
+            return -1;
+        }
+        data->capacity = len;
+        data->refs     = 1;
+        release(server->data);
+        server->data = data;
+    }
+    memcpy(data->bytes, text, len);
+    data->len = len;
+
+    XSetSelectionOwner(server->display, server->atoms.selection, server->owner,
+                       CurrentTime);
+    Window owner =
+        XGetSelectionOwner(server->display, server->atoms.selection);
+    stats_round_trip();
+    if (owner != server->owner) {
+        (void)fprintf(stderr, "Failed to set clipboard owner\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Start an INCR transfer, replacing any earlier one to the same property.
+// Returns false if the table is full of live transfers.
+static bool start_transfer(SelectionServer *server, Window requestor,
+                           Atom property, Atom type) {
+    uint64_t now_ns         = stats_now_ns();
+    SelectionTransfer *slot = nullptr;
+    for (size_t i = 0; i < SELECTION_MAX_TRANSFERS; i++) {  // NOLINT
+        SelectionTransfer *transfer = &server->transfers[i];
+        if (transfer->requestor == requestor &&
+            transfer->property == property) {
+            release(transfer->data);
+            slot = transfer;
+            break;
+        }
+        if (transfer->requestor &&
+            (transfer->gone ||
+             now_ns - transfer->last_ns > SELECTION_TIMEOUT_MS * NS_PER_MS)) {
+            end_transfer(server, transfer, !transfer->gone);
+        }
+        if (!transfer->requestor && !slot) {
+            slot = transfer;
+        }
+    }
+    if (!slot) {
+        return false;
+    }
+
+    // Watch the requestor before it can see the reply, so no deletion is
+    // missed.
+    XSelectInput(server->display, requestor,
+                 PropertyChangeMask | StructureNotifyMask);
+    server->data->refs++;
+    *slot = (SelectionTransfer){ .requestor = requestor,
+                                 .property  = property,
+                                 .type      = type,
+                                 .data      = server->data,
+                                 .last_ns   = now_ns };
+    long size = (long)server->data->len;
+    XChangeProperty(server->display, requestor, property, server->atoms.incr,
+                    32, PropModeReplace, (unsigned char *)&size, 1);
+    return true;
+}
+
+static void handle_request(SelectionServer *server,
+                           const XSelectionRequestEvent *req) {
+    const SelectionAtoms *atoms = &server->atoms;
+    // Obsolete requestors leave the property out and expect the target.
+    Atom property = req->property ? req->property : req->target;
+
+    XSelectionEvent notify;
+    memset(&notify, 0, sizeof(notify));
+    notify.type      = SelectionNotify;
+    notify.requestor = req->requestor;
+    notify.selection = req->selection;
+    notify.target    = req->target;
+    notify.property  = property;
+    notify.time      = req->time;
+
+    bool text_target = req->target == XA_STRING ||
+                       req->target == atoms->utf8_string ||
+                       req->target == atoms->compound_text;
+    if (req->target == atoms->targets) {
+        Atom supported_targets[] = { atoms->targets, XA_STRING,
+                                     atoms->utf8_string, atoms->compound_text };
+        XChangeProperty(
+            server->display, req->requestor, property, XA_ATOM, 32,
+            PropModeReplace, (unsigned char *)supported_targets,
+            sizeof(supported_targets) / sizeof(supported_targets[0]));
+    } else if (text_target && server->data &&
+               server->data->len <= server->chunk) {
+        XChangeProperty(server->display, req->requestor, property,
+                        req->target, 8, PropModeReplace,
+                        (unsigned char *)server->data->bytes,
+                        (int)server->data->len);
+    } else if (!text_target || !server->data ||
+               !start_transfer(server, req->requestor, property,
+                               req->target)) {
+        notify.property = None;
+    }
+    XSendEvent(server->display, req->requestor, True, 0, (XEvent *)&notify);
+}
+
+static SelectionTransfer *find_transfer(SelectionServer *server,
+                                        Window requestor, Atom property) {
+    for (size_t i = 0; i < SELECTION_MAX_TRANSFERS; i++) {  // NOLINT
+        SelectionTransfer *transfer = &server->transfers[i];
+        if (transfer->requestor == requestor &&
+            transfer->property == property) {
+            return transfer;
+        }
+    }
+    return nullptr;
+}
+
+bool selection_server_handle_event(SelectionServer *server,
+                                   const XEvent *event) {
+    SelectionTransfer *transfer = nullptr;
+    switch (event->type) {
+        case SelectionRequest:
+            if (event->xselectionrequest.owner != server->owner) {
+                return false;
+            }
+            handle_request(server, &event->xselectionrequest);
+            return true;
+
+        case SelectionClear:
+            // Another client owns the selection now; running transfers keep
+            // their reference to the old text.
+            if (event->xselectionclear.selection != server->atoms.selection) {
+                return false;
+            }
+            release(server->data);
+            server->data = nullptr;
+            return true;
+
+        case PropertyNotify:
+            // Deleting the property asks for the next chunk.
+            transfer = find_transfer(server, event->xproperty.window,
+                                     event->xproperty.atom);
+            if (!transfer) {
+                return false;
+            }
+            if (event->xproperty.state == PropertyDelete) {
+                transfer->ready = true;
+            }
+            return true;
+
+        case DestroyNotify:
+            if (event->xdestroywindow.window == server->owner) {
+                return false;
+            }
+            end_requestor(server, event->xdestroywindow.window);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// Fire when the transfer idle the longest without being ready times out, or
+// never if none is waiting on its requestor.
+static void arm_timeout(const SelectionServer *server, uint64_t now_ns) {
+    if (server->timer_fd < 0) {
+        return;
+    }
+    uint64_t timeout_ns = SELECTION_TIMEOUT_MS * NS_PER_MS;
+    uint64_t delay_ns   = 0;
+    for (size_t i = 0; i < SELECTION_MAX_TRANSFERS; i++) {  // NOLINT
+        const SelectionTransfer *transfer = &server->transfers[i];
+        if (!transfer->requestor || transfer->ready) {
+            continue;
+        }
+        // Just past the deadline, since the pump drops transfers idle for
+        // longer than the timeout.
+        uint64_t idle_ns = now_ns - transfer->last_ns;
+        uint64_t left_ns = idle_ns < timeout_ns ? timeout_ns - idle_ns + 1 : 1;
+        if (delay_ns == 0 || left_ns < delay_ns) {
+            delay_ns = left_ns;
+        }
+    }
+    struct itimerspec spec = {
+        .it_value = { .tv_sec  = (time_t)(delay_ns / NS_PER_S),
+                      .tv_nsec = (long)(delay_ns % NS_PER_S) },
+    };
+    (void)timerfd_settime(server->timer_fd, 0, &spec, nullptr);
+}
+
+void selection_server_pump(SelectionServer *server) {
+    uint64_t now_ns = stats_now_ns();
+    bool sent       = false;
+    size_t first    = server->next;
+    for (size_t n = 0; n < SELECTION_MAX_TRANSFERS; n++) {  // NOLINT
+        SelectionTransfer *transfer =
+            &server->transfers[(first + n) % SELECTION_MAX_TRANSFERS];
+        if (!transfer->requestor) {
+            continue;
+        }
+        if (transfer->gone) {
+            end_transfer(server, transfer, false);
+            continue;
+        }
+        if (!transfer->ready) {
+            if (now_ns - transfer->last_ns >
+                SELECTION_TIMEOUT_MS * NS_PER_MS) {
+                end_transfer(server, transfer, true);
+            }
+            continue;
+        }
+
+        // One chunk per transfer and pass; an empty chunk ends it.
+        const SelectionData *data = transfer->data;
+        size_t count              = data->len - transfer->offset;
+        if (count > server->chunk) {
+            count = server->chunk;
+        }
+        XChangeProperty(server->display, transfer->requestor,
+                        transfer->property, transfer->type, 8,
+                        PropModeReplace,
+                        (unsigned char *)data->bytes + transfer->offset,
+                        (int)count);
+        transfer->offset += count;
+        transfer->ready   = false;
+        transfer->last_ns = now_ns;
+        sent              = true;
+        if (count == 0 && !transfer->gone) {
+            end_transfer(server, transfer, true);
+        }
+    }
+    server->next = (first + 1) % SELECTION_MAX_TRANSFERS;
+    arm_timeout(server, now_ns);
+    if (sent) {
+        XFlush(server->display);
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * Filename: selection_server.h
+ *
+ * Description: Declarations for serving an X selection to many requestors at
+ * once. Small replies go out straight away; larger ones use the ICCCM INCR
+ * protocol, with one entry per requestor and property in a fixed-size
+ * transfer table. Transfers advance one chunk per pass in turn, so each
+ * waits on its own requestor only, and they are dropped when the
+ * requestor's window is destroyed or it stops reading. A timerfd wakes the
+ * event loop when a stalled transfer is due, so it is dropped on time even
+ * if no other selection traffic arrives.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef SELECTION_SERVER_H
+#define SELECTION_SERVER_H
+
+#include <X11/Xlib.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SELECTION_MAX_TRANSFERS 32
+#define SELECTION_MAX_BYTES (1U << 20U)  // Longest text that can be owned.
+#define SELECTION_CHUNK (64U << 10U)     // Largest reply and INCR chunk.
+#define SELECTION_TIMEOUT_MS 5000  // Idle time before a transfer is dropped.
+
+// Selection contents. Transfers keep the text they started with, so the
+// text is shared by reference until its last transfer finishes.
+typedef struct {
+    char *bytes;
+    size_t len;
+    size_t capacity;
+    uint32_t refs;
+} SelectionData;
+
+// An INCR transfer to one requestor property.
+typedef struct {
+    Window requestor;  // None for a free entry.
+    Atom property;
+    Atom type;
+    SelectionData *data;
+    size_t offset;     // Bytes sent so far.
+    uint64_t last_ns;  // Time of the last progress.
+    bool ready;        // The requestor read the last chunk.
+    bool gone;         // The requestor's window no longer exists.
+} SelectionTransfer;
+
+typedef struct {
+    Atom selection;
+    Atom targets;
+    Atom utf8_string;
+    Atom compound_text;
+    Atom incr;
+} SelectionAtoms;
+
+typedef struct {
+    Display *display;
+    Window owner;
+    SelectionAtoms atoms;
+    SelectionData *data;  // Current contents, or nullptr.
+    size_t chunk;         // Chunk size allowed by the server.
+    SelectionTransfer transfers[SELECTION_MAX_TRANSFERS];
+    size_t next;          // Transfer to serve first on the next pass.
+    int timer_fd;         // Expires when a stalled transfer is due, or -1.
+} SelectionServer;
+
+// Serve the atoms' selection from the owner window. Errors caused by
+// requestors that go away mid-transfer are ignored from here on. Poll
+// timer_fd, when it is not -1, next to the display connection and pump once
+// it expires.
+void selection_server_init(SelectionServer *server, Display *display,
+                           Window owner, const SelectionAtoms *atoms);
+
+// Drop all transfers and the contents and close the timer. The server is
+// ready to be set up again afterwards.
+void selection_server_free(SelectionServer *server);
+
+// Own the selection with a copy of the text, at most SELECTION_MAX_BYTES.
+// Returns 0 on success or -1 if the ownership or the copy failed.
+int selection_server_own(SelectionServer *server, const char *text,
+                         size_t len);
+
+// Consume the event if it belongs to the selection or one of its transfers.
+bool selection_server_handle_event(SelectionServer *server,
+                                   const XEvent *event);
+
+// Send the next chunk of every transfer whose requestor is ready for it,
+// drop the stalled ones and arm the timer for the next to stall.
+void selection_server_pump(SelectionServer *server);
+
+#endif  // SELECTION_SERVER_H
@@ -0,0 +1,219 @@
+/*
+ * Filename: shm_image.c
+ *
+ * Description: Implements the client-side XImage used by the Xlib backend's
+ * software rendering path, backed by MIT-SHM when the server allows it.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include "shm_image.h"
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include "stats.h"
+
+static bool attach_failed = false;
+
+static int catch_attach_error(Display *display, XErrorEvent *error) {
+    (void)display;
+    (void)error;
+    attach_failed = true;
+    return 0;
+}
+
+// Attach a shared segment. Remote servers cannot map it, which only shows
+// up as an error once the request has been processed.
+static bool create_shared(ShmImage *img, Visual *visual, unsigned int depth,
+                          uint32_t width, uint32_t height) {
+    img->image = XShmCreateImage(img->display, visual, depth, ZPixmap, nullptr,
+                                 &img->segment, width, height);
+    if (!img->image) {
+        return false;
+    }
+
+    size_t size        = (size_t)img->image->bytes_per_line * height;
+    img->segment.shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (img->segment.shmid < 0) {
+        XDestroyImage(img->image);
+        img->image = nullptr;
+        return false;
+    }
+    img->segment.shmaddr  = shmat(img->segment.shmid, nullptr, 0);
+    img->image->data      = img->segment.shmaddr;
+    img->segment.readOnly = False;
+
+    bool attached = false;
+    if (img->segment.shmaddr != (char *)-1) {
+        attach_failed          = false;
+        XErrorHandler previous = XSetErrorHandler(catch_attach_error);
+        XShmAttach(img->display, &img->segment);
+        XSync(img->display, False);
+        stats_round_trip();
+        XSetErrorHandler(previous);
+        attached = !attach_failed;
+    }
+
+    // The segment disappears once both sides have detached.
+    (void)shmctl(img->segment.shmid, IPC_RMID, nullptr);
+    if (!attached) {
+        if (img->segment.shmaddr != (char *)-1) {
+            (void)shmdt(img->segment.shmaddr);
+        }
+        img->image->data = nullptr;
+        XDestroyImage(img->image);
+        img->image = nullptr;
+        return false;
+    }
+    img->completion = XShmGetEventBase(img->display) + ShmCompletion;
+    img->shared     = true;
+    return true;
+}
+
+static bool create_plain(ShmImage *img, Visual *visual, unsigned int depth,
+                         uint32_t width, uint32_t height) {
+    char *data = calloc((size_t)width * height, sizeof(uint32_t));
+    if (!data) {
+        return false;
+    }
+    img->image = XCreateImage(img->display, visual, depth, ZPixmap, 0, data,
+                              width, height, 32, 0);
+    if (!img->image) {
+        free(data);
+        return false;
+    }
+    return true;
+}
+
+int shm_image_create(ShmImage *img, Display *display, uint32_t width,
+                     uint32_t height, bool allow_shm) {
+    memset(img, 0, sizeof(*img));
+    img->display = display;
+
+    int screen         = DefaultScreen(display);
+    Visual *visual     = DefaultVisual(display, screen);
+    unsigned int depth = (unsigned int)DefaultDepth(display, screen);
+
+    if (allow_shm) {
+        allow_shm = XShmQueryExtension(display);
+        stats_round_trip();
+    }
+    if (!(allow_shm && create_shared(img, visual, depth, width, height)) &&
+        !create_plain(img, visual, depth, width, height)) {
+        return -1;
+    }
+
+    // The rasterizer writes 32-bit XRGB pixels in host byte order.
+    const uint32_t probe = 1;
+    int host_order       = *(const uint8_t *)&probe ? LSBFirst : MSBFirst;
+    if (img->image->bits_per_pixel != 32 ||
+        img->image->byte_order != host_order) {
+        shm_image_destroy(img);
+        return -1;
+    }
+    img->raster.pixels = (uint32_t *)(void *)img->image->data;
+    img->raster.width  = width;
+    img->raster.height = height;
+    img->raster.stride = (uint32_t)img->image->bytes_per_line / 4U;
+    memset(img->image->data, 0, (size_t)img->image->bytes_per_line * height);
+    return 0;
+}
+
+void shm_image_destroy(ShmImage *img) {
+    if (!img->image) {
+        return;
+    }
+    if (img->shared) {
+        shm_image_wait(img);
+        XShmDetach(img->display, &img->segment);
+        img->image->data = nullptr;
+        XDestroyImage(img->image);
+        (void)shmdt(img->segment.shmaddr);
+    } else {
+        XDestroyImage(img->image);
+    }
+    memset(img, 0, sizeof(*img));
+}
+
+void shm_image_put(ShmImage *img, Drawable drawable, GC gc, int x, int y,
+                   uint32_t width, uint32_t height) {
+    if (img->shared) {
+        XShmPutImage(img->display, drawable, gc, img->image, x, y, x, y, width,
+                     height, True);
+        img->busy = true;
+    } else {
+        XPutImage(img->display, drawable, gc, img->image, x, y, x, y, width,
+                  height);
+    }
+}
+
+void shm_image_get(ShmImage *img, Drawable drawable, int x, int y,
+                   uint32_t drawable_width, uint32_t drawable_height) {
+    int64_t x0 = x < 0 ? 0 : x;
+    int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = (int64_t)x + img->raster.width;
+    int64_t y1 = (int64_t)y + img->raster.height;
+    x1         = x1 > drawable_width ? drawable_width : x1;
+    y1         = y1 > drawable_height ? drawable_height : y1;
+
+    shm_image_wait(img);
+    if (img->shared && x0 == x && y0 == y &&
+        x1 - x0 == img->raster.width && y1 - y0 == img->raster.height) {
+        XShmGetImage(img->display, drawable, img->image, x, y, AllPlanes);
+        stats_round_trip();
+        return;
+    }
+
+    memset(img->image->data, 0,
+           (size_t)img->image->bytes_per_line * img->raster.height);
+    if (x0 < x1 && y0 < y1) {
+        XGetSubImage(img->display, drawable, (int)x0, (int)y0,
+                     (unsigned int)(x1 - x0), (unsigned int)(y1 - y0),
+                     AllPlanes, ZPixmap, img->image, (int)(x0 - x),
+                     (int)(y0 - y));
+        stats_round_trip();
+    }
+}
+
+// Several images may be shared at once, so a completion is matched to its
+// segment as well as its type.
+static bool completes(const ShmImage *img, const XEvent *event) {
+    return img->shared && event->type == img->completion &&
+           ((const XShmCompletionEvent *)(const void *)event)->shmseg ==
+               img->segment.shmseg;
+}
+
+static Bool is_completion(Display *display, XEvent *event, XPointer arg) {
+    (void)display;
+    return completes((const ShmImage *)(void *)arg, event);
+}
+
+void shm_image_wait(ShmImage *img) {
+    if (!img->busy) {
+        return;
+    }
+    XEvent event;
+    XIfEvent(img->display, &event, is_completion, (XPointer)img);
+    stats_round_trip();
+    img->busy = false;
+}
+
+bool shm_image_handle_event(ShmImage *img, const XEvent *event) {
+    if (!completes(img, event)) {
+        return false;
+    }
+    img->busy = false;
+    return true;
+}
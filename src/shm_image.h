@@ -0,0 +1,60 @@
+/*
+ * Filename: shm_image.h
+ *
+ * Description: Declarations for a client-side XImage that the software
+ * rasterizer draws into. The image lives in MIT-SHM shared memory when the
+ * server supports it, so presenting it copies nothing over the socket, and
+ * falls back to a plain XImage sent with XPutImage otherwise.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef SHM_IMAGE_H
+#define SHM_IMAGE_H
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <stdint.h>
+
+#include "raster.h"
+
+typedef struct {
+    Display *display;
+    XImage *image;
+    XShmSegmentInfo segment;
+    bool shared;     // The image is attached through MIT-SHM.
+    bool busy;       // The server may still be reading the segment.
+    int completion;  // Event type of ShmCompletion.
+    Raster raster;   // Pixels of the image, for drawing.
+} ShmImage;
+
+// Create a cleared 32-bit image for the default visual, shared if allow_shm
+// is set and the server can attach the segment. Returns 0 on success or -1
+// if the visual cannot be drawn by the rasterizer.
+int shm_image_create(ShmImage *img, Display *display, uint32_t width,
+                     uint32_t height, bool allow_shm);
+
+void shm_image_destroy(ShmImage *img);
+
+// Copy part of the image to a drawable.
+void shm_image_put(ShmImage *img, Drawable drawable, GC gc, int x, int y,
+                   uint32_t width, uint32_t height);
+
+// Read the image's size of pixels at x, y from a drawable of the given size.
+// Areas outside the drawable read as black. A shared image inside it is
+// read with a single XShmGetImage; otherwise XGetSubImage fetches the part
+// that overlaps.
+void shm_image_get(ShmImage *img, Drawable drawable, int x, int y,
+                   uint32_t drawable_width, uint32_t drawable_height);
+
+// Block until the server has finished reading the image, so the pixels can
+// be changed again.
+void shm_image_wait(ShmImage *img);
+
+// Consume the event if it reports that a put has completed.
+bool shm_image_handle_event(ShmImage *img, const XEvent *event);
+
+#endif  // SHM_IMAGE_H
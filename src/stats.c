@@ -0,0 +1,141 @@
+/*
+ * Filename: stats.c
+ *
+ * Description: Implements the runtime statistics counters and their report.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stats.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+DockStats stats = {};
+
+uint64_t stats_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+void stats_first_frame(void) {
+    if (stats.startup_ns == 0) {
+        stats.startup_ns = stats_now_ns() - stats.start_ns;
+    }
+}
+
+void stats_click(uint64_t start_ns) {
+    uint64_t elapsed = stats_now_ns() - start_ns;
+    stats.clicks++;
+    stats.click_total_ns += elapsed;
+    if (elapsed > stats.click_max_ns) {
+        stats.click_max_ns = elapsed;
+    }
+}
+
+void stats_hotkey(uint64_t start_ns) {
+    uint64_t elapsed = stats_now_ns() - start_ns;
+    stats.hotkeys++;
+    stats.hotkey_total_ns += elapsed;
+    if (elapsed > stats.hotkey_max_ns) {
+        stats.hotkey_max_ns = elapsed;
+    }
+}
+
+void stats_redraw(uint64_t start_ns) {
+    uint64_t elapsed = stats_now_ns() - start_ns;
+    stats.redraws++;
+    stats.redraw_total_ns += elapsed;
+    if (elapsed > stats.redraw_max_ns) {
+        stats.redraw_max_ns = elapsed;
+    }
+}
+
+void stats_frame(uint64_t start_ns) {
+    uint64_t elapsed = stats_now_ns() - start_ns;
+    stats.frames++;
+    stats.frame_total_ns += elapsed;
+    if (elapsed > stats.frame_max_ns) {
+        stats.frame_max_ns = elapsed;
+    }
+}
+
+void stats_clip(uint64_t start_ns) {
+    uint64_t elapsed = stats_now_ns() - start_ns;
+    stats.clip_total_ns += elapsed;
+    if (elapsed > stats.clip_max_ns) {
+        stats.clip_max_ns = elapsed;
+    }
+}
+
+void stats_print(FILE *out, const char *backend_name) {
+    uint64_t click_avg_ns =
+        stats.clicks ? stats.click_total_ns / stats.clicks : 0;
+    uint64_t redraw_avg_ns =
+        stats.redraws ? stats.redraw_total_ns / stats.redraws : 0;
+    (void)fprintf(out,
+                  "backend:      %s\n"
+                  "round trips:  %llu\n"
+                  "startup:      %.3f ms%s\n"
+                  "clicks:       %llu (avg %.1f us, max %.1f us)\n"
+                  "wakeups:      %llu\n",
+                  backend_name, (unsigned long long)stats.round_trips,
+                  (double)stats.startup_ns / 1e6,
+                  stats.cache_hits ? " (render cache)" : "",
+                  (unsigned long long)stats.clicks,
+                  (double)click_avg_ns / 1e3, (double)stats.click_max_ns / 1e3,
+                  (unsigned long long)stats.wakeups);
+    if (stats.redraws) {
+        (void)fprintf(out, "redraws:      %llu (avg %.1f us, max %.1f us)\n",
+                      (unsigned long long)stats.redraws,
+                      (double)redraw_avg_ns / 1e3,
+                      (double)stats.redraw_max_ns / 1e3);
+    }
+    if (stats.hotkeys) {
+        uint64_t hotkey_avg_ns = stats.hotkey_total_ns / stats.hotkeys;
+        (void)fprintf(out, "hotkeys:      %llu (avg %.1f us, max %.1f us)\n",
+                      (unsigned long long)stats.hotkeys,
+                      (double)hotkey_avg_ns / 1e3,
+                      (double)stats.hotkey_max_ns / 1e3);
+    }
+    if (stats.frames) {
+        uint64_t frame_avg_ns = stats.frame_total_ns / stats.frames;
+        (void)fprintf(out, "frames:       %llu (avg %.1f us, max %.1f us)\n",
+                      (unsigned long long)stats.frames,
+                      (double)frame_avg_ns / 1e3,
+                      (double)stats.frame_max_ns / 1e3);
+    }
+    if (stats.clip_changes) {
+        uint64_t clip_avg_ns = stats.clip_total_ns / stats.clip_changes;
+        (void)fprintf(out,
+                      "clipboard:    %llu changes, %llu reads (%llu bytes), "
+                      "avg %.1f us per change, max %.1f us\n",
+                      (unsigned long long)stats.clip_changes,
+                      (unsigned long long)stats.clip_reads,
+                      (unsigned long long)stats.clip_bytes,
+                      (double)clip_avg_ns / 1e3,
+                      (double)stats.clip_max_ns / 1e3);
+    }
+    if (stats.idle_queued) {
+        uint64_t slice_avg_ns =
+            stats.idle_slices ? stats.idle_total_ns / stats.idle_slices : 0;
+        (void)fprintf(out,
+                      "idle tasks:   %llu (queued now %llu, max %llu)\n"
+                      "idle slices:  %llu (%llu steps, %llu preempted, "
+                      "avg %.1f us, max %.1f us)\n",
+                      (unsigned long long)stats.idle_queued,
+                      (unsigned long long)stats.idle_depth,
+                      (unsigned long long)stats.idle_depth_max,
+                      (unsigned long long)stats.idle_slices,
+                      (unsigned long long)stats.idle_steps,
+                      (unsigned long long)stats.idle_preempted,
+                      (double)slice_avg_ns / 1e3,
+                      (double)stats.idle_max_ns / 1e3);
+    }
+}
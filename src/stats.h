@@ -0,0 +1,83 @@
+/*
+ * Filename: stats.h
+ *
+ * Description: Declarations for the runtime statistics that compare backends:
+ * blocking round trips to the display server, startup time, click latency,
+ * full-dock redraw time, hotkey latency, event loop wakeups, the idle
+ * scheduler's queue and slices, and the frames of the palette sliders.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct {
+    uint64_t start_ns;         // Process start, as seen by main().
+    uint64_t startup_ns;       // Time until the first frame was flushed.
+    uint64_t round_trips;      // Requests that blocked waiting for a reply.
+    uint64_t clicks;           // Left clicks handled.
+    uint64_t click_total_ns;   // Sum of click-to-clipboard-ready latencies.
+    uint64_t click_max_ns;     // Worst click-to-clipboard-ready latency.
+    uint64_t redraws;          // Full-dock redraws timed by --redraws.
+    uint64_t redraw_total_ns;  // Sum of redraw times, server work included.
+    uint64_t redraw_max_ns;    // Worst redraw time.
+    uint64_t wakeups;          // Times the event loop woke from poll().
+    uint64_t hotkeys;          // Global hotkeys handled.
+    uint64_t hotkey_total_ns;  // Sum of keypress-to-clipboard-ready latencies.
+    uint64_t hotkey_max_ns;    // Worst keypress-to-clipboard-ready latency.
+    uint64_t idle_queued;      // Idle tasks queued.
+    uint64_t idle_depth;       // Idle tasks still queued.
+    uint64_t idle_depth_max;   // Most idle tasks queued at once.
+    uint64_t idle_steps;       // Idle task steps run.
+    uint64_t idle_slices;      // Slices of idle work run.
+    uint64_t idle_preempted;   // Slices cut short by input.
+    uint64_t idle_total_ns;    // Sum of idle slice times.
+    uint64_t idle_max_ns;      // Longest idle slice.
+    uint64_t frames;           // Palette slider frames drawn.
+    uint64_t frame_total_ns;   // Sum of slider frame times.
+    uint64_t frame_max_ns;     // Longest slider frame.
+    uint64_t cache_hits;       // First frames shown from the render cache.
+    uint64_t clip_changes;     // Clipboard owner changes by other clients.
+    uint64_t clip_reads;       // Clipboard texts asked for.
+    uint64_t clip_bytes;       // Bytes of clipboard text received.
+    uint64_t clip_total_ns;    // Sum of the clipboard watcher's work.
+    uint64_t clip_max_ns;      // Longest the watcher took for one event.
+} DockStats;
+
+extern DockStats stats;
+
+// Monotonic clock in nanoseconds.
+uint64_t stats_now_ns(void);
+
+// Record that the calling code blocked on a reply from the server.
+static inline void stats_round_trip(void) {
+    stats.round_trips++;
+}
+
+// Record the end of startup, if it has not been recorded yet.
+void stats_first_frame(void);
+
+// Record a click that started at the given time.
+void stats_click(uint64_t start_ns);
+
+// Record a hotkey that was read from the backend at the given time.
+void stats_hotkey(uint64_t start_ns);
+
+// Record a full redraw that started at the given time.
+void stats_redraw(uint64_t start_ns);
+
+// Record a palette slider frame that started at the given time.
+void stats_frame(uint64_t start_ns);
+
+// Record clipboard watcher work on an event that started at the given time.
+void stats_clip(uint64_t start_ns);
+
+void stats_print(FILE *out, const char *backend_name);
+
+#endif  // STATS_H
@@ -0,0 +1,171 @@
+/*
+ * Filename: workers.c
+ *
+ * Description: Implements the worker pool. Jobs wait in a ring under one
+ * mutex; a worker that finishes one moves it to the finished list and bumps
+ * an eventfd that wait_event() polls with the timers, so the main loop sleeps
+ * in the same poll() whether it waits for the display or for a job. The
+ * threads are created on the first job, which keeps a dock that never runs
+ * one single-threaded, and after --all-monitors has forked.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include "workers.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "backend.h"
+
+typedef struct {
+    WorkerRun run;
+    WorkerDone done;
+    void *data;
+} WorkerJob;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_t threads[WORKER_THREADS];
+    size_t thread_count;
+    WorkerJob queued[WORKER_JOBS];  // Ring of jobs not yet taken.
+    size_t head;
+    size_t queued_count;
+    WorkerJob finished[WORKER_JOBS];  // Awaiting workers_collect().
+    size_t finished_count;
+    size_t pending;  // Queued, running or finished jobs.
+    int event_fd;
+    bool stopping;
+} pool = { .lock     = PTHREAD_MUTEX_INITIALIZER,
+           .wake     = PTHREAD_COND_INITIALIZER,
+           .event_fd = -1 };
+
+// Wake the main loop. Past EINTR an eventfd write only fails when the
+// counter is about to overflow, and the main loop is awake then anyway.
+static void signal_finished(void) {
+    const uint64_t one = 1;
+    while (write(pool.event_fd, &one, sizeof(one)) < 0 &&  // NOLINT
+           errno == EINTR) {
+    }
+}
+
+static void *worker_main(void *arg) {
+    (void)arg;
+    // On Linux the nice value is per thread.
+    (void)setpriority(PRIO_PROCESS, 0, WORKER_NICE);
+
+    pthread_mutex_lock(&pool.lock);
+    while (!pool.stopping) {  // NOLINT(altera-unroll-loops)
+        if (pool.queued_count == 0) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+            continue;
+        }
+        WorkerJob job = pool.queued[pool.head];
+        pool.head     = (pool.head + 1) % WORKER_JOBS;
+        pool.queued_count--;
+        pthread_mutex_unlock(&pool.lock);
+
+        job.run(job.data);
+
+        pthread_mutex_lock(&pool.lock);
+        pool.finished[pool.finished_count++] = job;
+        signal_finished();
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return nullptr;
+}
+
+static bool start_workers(void) {
+    if (pool.thread_count > 0) {
+        return true;
+    }
+    pool.event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (pool.event_fd < 0) {
+        return false;
+    }
+    if (!watch_event_timer(pool.event_fd)) {
+        (void)close(pool.event_fd);
+        pool.event_fd = -1;
+        return false;
+    }
+    for (size_t i = 0; i < WORKER_THREADS; i++) {  // NOLINT
+        if (pthread_create(&pool.threads[pool.thread_count], nullptr,
+                           worker_main, nullptr) == 0) {
+            pool.thread_count++;
+        }
+    }
+    // Without a thread the eventfd would stay polled and a later submit
+    // would open another one.
+    if (pool.thread_count == 0) {
+        unwatch_event_timer(pool.event_fd);
+        (void)close(pool.event_fd);
+        pool.event_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool workers_submit(WorkerRun run, WorkerDone done, void *data) {
+    if (pool.stopping || !start_workers()) {
+        return false;
+    }
+    pthread_mutex_lock(&pool.lock);
+    bool queued = pool.pending < WORKER_JOBS;
+    if (queued) {
+        size_t tail = (pool.head + pool.queued_count) % WORKER_JOBS;
+        pool.queued[tail] =
+            (WorkerJob){ .run = run, .done = done, .data = data };
+        pool.queued_count++;
+        pool.pending++;
+        pthread_cond_signal(&pool.wake);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return queued;
+}
+
+bool workers_own_fd(int fd) {
+    return fd >= 0 && fd == pool.event_fd;
+}
+
+void workers_collect(void) {
+    WorkerJob finished[WORKER_JOBS];
+    pthread_mutex_lock(&pool.lock);
+    size_t count = pool.finished_count;
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        finished[i] = pool.finished[i];
+    }
+    pool.finished_count = 0;
+    pool.pending -= count;
+    pthread_mutex_unlock(&pool.lock);
+
+    // Completions may submit further jobs, so none runs under the lock.
+    for (size_t i = 0; i < count; i++) {  // NOLINT(altera-unroll-loops)
+        if (finished[i].done) {
+            finished[i].done(finished[i].data);
+        }
+    }
+}
+
+void workers_stop(void) {
+    if (pool.thread_count == 0) {
+        return;
+    }
+    pthread_mutex_lock(&pool.lock);
+    pool.stopping     = true;
+    pool.queued_count = 0;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+    // The eventfd stays open for workers still running; only the polling
+    // stops.
+    unwatch_event_timer(pool.event_fd);
+}
@@ -0,0 +1,44 @@
+/*
+ * Filename: workers.h
+ *
+ * Description: Declarations for the worker pool that runs heavy jobs off the
+ * main thread, so the event loop keeps serving clipboard requests and input
+ * while they run. A job's work runs on a worker and its completion runs on
+ * the main thread, which alone talks to the display.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef WORKERS_H
+#define WORKERS_H
+
+#include <stddef.h>
+
+#define WORKER_THREADS 2
+#define WORKER_JOBS 16  // Jobs queued, running or awaiting completion.
+#define WORKER_NICE 10  // Workers yield the CPU to the main thread.
+
+// The job's work, on a worker thread. It must not use the backend or any
+// state the main thread changes while it runs.
+typedef void (*WorkerRun)(void *data);
+
+// The job's completion, on the main thread, from the event loop.
+typedef void (*WorkerDone)(void *data);
+
+// Queue a job, starting the workers on first use. Returns false if
+// WORKER_JOBS jobs are pending or the workers cannot be started.
+bool workers_submit(WorkerRun run, WorkerDone done, void *data);
+
+// Whether an EVENT_TIMER came from the workers' completion eventfd.
+bool workers_own_fd(int fd);
+
+// Run the completions of the jobs that have finished.
+void workers_collect(void);
+
+// Drop the jobs not yet started and stop reporting completions. Jobs
+// already running are left to end with the process.
+void workers_stop(void);
+
+#endif  // WORKERS_H
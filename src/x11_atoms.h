@@ -0,0 +1,40 @@
+/*
+ * Filename: x11_atoms.h
+ *
+ * Description: The X11 atoms used by the X backends, shared so that each
+ * backend can intern the same set in whatever way suits its protocol library.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#ifndef X11_ATOMS_H
+#define X11_ATOMS_H
+
+typedef enum {
+    ATOM_MOTIF_WM_HINTS,
+    ATOM_WM_PROTOCOLS,
+    ATOM_WM_DELETE_WINDOW,
+    ATOM_NET_WM_NAME,
+    ATOM_NET_WM_STATE,
+    ATOM_NET_WM_STATE_ABOVE,
+    ATOM_UTF8_STRING,
+    ATOM_COMPOUND_TEXT,
+    ATOM_TARGETS,
+    ATOM_CLIPBOARD,
+    ATOM_INCR,
+    ATOM_NET_WM_SYNC_REQUEST,
+    ATOM_NET_WM_SYNC_REQUEST_COUNTER,
+    ATOM_COUNT
+} AtomId;
+
+static const char *const atom_names[ATOM_COUNT] = {
+    "_MOTIF_WM_HINTS",  "WM_PROTOCOLS",        "WM_DELETE_WINDOW",
+    "_NET_WM_NAME",     "_NET_WM_STATE",       "_NET_WM_STATE_ABOVE",
+    "UTF8_STRING",      "COMPOUND_TEXT",       "TARGETS",
+    "CLIPBOARD",        "INCR",                "_NET_WM_SYNC_REQUEST",
+    "_NET_WM_SYNC_REQUEST_COUNTER"
+};
+
+#endif  // X11_ATOMS_H
@@ -0,0 +1,548 @@
+/*
+ * Filename: arctic_nord_test.c
+ *
+ * Description: Tests for libarcticnord, linked against the shared library so
+ * the exported API is what gets tested. Every format is written and read
+ * back for a spread of colors across the sRGB cube, color-space conversions
+ * are checked for round trips, and the parser is given malformed input.
+ * Every exporter writes the palette to a buffer and to a file, and the two
+ * must agree. The k-d tree must find the same colors as a linear scan.
+ * Gradients must keep their ends, move steadily between them and be written
+ * in each notation. Palette transforms must leave colors alone at identity,
+ * give the same colors in a batch as one at a time and move hue, chroma,
+ * lightness and warmth the right way. Prints each failure and exits nonzero
+ * if there was any.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "arctic_nord.h"
+#include "arctic_nord_export.h"
+#include "arctic_nord_index.h"
+
+// Colors tested: the palette and every COLOR_STEP-th color of the cube.
+#define COLOR_STEP 997U
+#define COLOR_LIMIT 0x1000000U
+
+// Size of the table indexed by the k-d tree test, with repeated colors so
+// ties must go to the first.
+#define INDEX_COLORS 2000U
+#define INDEX_DISTINCT 1500U
+
+static size_t checks;
+static size_t failures;
+
+static void expect(bool ok, const char *what, uint32_t color) {
+    checks++;
+    if (!ok) {
+        failures++;
+        (void)fprintf(stderr, "FAIL: %s for #%06X\n", what, color);
+    }
+}
+
+static uint32_t channel_error(uint32_t a, uint32_t b) {
+    uint32_t worst = 0;
+    for (uint32_t shift = 0; shift < 24; shift += 8) {  // NOLINT
+        int32_t diff = (int32_t)((a >> shift) & 0xFFU) -
+                       (int32_t)((b >> shift) & 0xFFU);
+        uint32_t error = (uint32_t)(diff < 0 ? -diff : diff);
+        worst          = error > worst ? error : worst;
+    }
+    return worst;
+}
+
+// Largest channel error after writing and reading a format. Hex and the
+// CSS formats are exact; floats keep two decimals, and HSL whole degrees and
+// percents, which move a saturated channel by up to 5.
+static uint32_t format_tolerance(NordFormat format) {
+    switch (format) {
+        case NORD_FORMAT_FLOAT:
+        case NORD_FORMAT_VEC3:
+        case NORD_FORMAT_VEC4:
+            return 1;
+        case NORD_FORMAT_HSL:
+            return 5;
+        default:
+            return 0;
+    }
+}
+
+// Formats the library writes without printf, written with it. Vec4 stands
+// in for the other float formats.
+static bool reference_format(uint32_t color, NordFormat format, char *buf,
+                             size_t buf_size) {
+    unsigned int r = (color >> 16U) & 0xFFU;
+    unsigned int g = (color >> 8U) & 0xFFU;
+    unsigned int b = color & 0xFFU;
+    switch (format) {
+        case NORD_FORMAT_HTML_HEX:
+            (void)snprintf(buf, buf_size, "#%02X%02X%02X", r, g, b);
+            return true;
+        case NORD_FORMAT_RAW_HEX:
+            (void)snprintf(buf, buf_size, "0x%02x%02x%02x", r, g, b);
+            return true;
+        case NORD_FORMAT_CSS_RGB:
+            (void)snprintf(buf, buf_size, "rgb(%u, %u, %u);", r, g, b);
+            return true;
+        case NORD_FORMAT_CSS_RGBA:
+            (void)snprintf(buf, buf_size, "rgba(%u, %u, %u, 1);", r, g, b);
+            return true;
+        case NORD_FORMAT_VEC4:
+            (void)snprintf(buf, buf_size, "vec4(%.2ff, %.2ff, %.2ff, 1.00f)",
+                           r / 255.0, g / 255.0, b / 255.0);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void test_round_trip(uint32_t color) {
+    for (int f = 0; f < NORD_FORMAT_COUNT; f++) {  // NOLINT
+        NordFormat format = (NordFormat)f;
+        char text[NORD_TEXT_SIZE];
+        size_t len = nord_format_color(color, format, text, sizeof(text));
+        expect(len == strlen(text) && len < sizeof(text), "format length",
+               color);
+        char expected[NORD_TEXT_SIZE];
+        if (reference_format(color, format, expected, sizeof(expected))) {
+            expect(strcmp(text, expected) == 0, expected, color);
+        }
+
+        uint32_t parsed = 0;
+        NordFormat kind = NORD_FORMAT_COUNT;
+        bool ok         = nord_parse_color(text, len, &parsed, &kind) == 0;
+        expect(ok && kind == format, nord_format_name(format), color);
+        expect(ok && channel_error(parsed, color) <= format_tolerance(format),
+               text, color);
+    }
+
+    NordOklab lab = nord_rgb_to_oklab(color);
+    expect(nord_oklab_to_rgb(lab) == color, "OKLab round trip", color);
+    NordOklch lch = nord_oklab_to_oklch(lab);
+    expect(lch.h >= 0.0F && lch.h < 360.0F && lch.c >= 0.0F, "OKLCH range",
+           color);
+    expect(nord_oklab_to_rgb(nord_oklch_to_oklab(lch)) == color,
+           "OKLCH round trip", color);
+    expect(nord_hsl_to_rgb(nord_rgb_to_hsl(color)) == color, "HSL round trip",
+           color);
+}
+
+static void test_parse(const char *text, int status, uint32_t expected) {
+    uint32_t color = 0;
+    int result     = nord_parse_color(text, strlen(text), &color, nullptr);
+    checks++;
+    if (result != status || (status == 0 && color != expected)) {
+        failures++;
+        (void)fprintf(stderr, "FAIL: parsing \"%s\" gave %d, #%06X\n", text,
+                      result, color);
+    }
+}
+
+static void test_parser(void) {
+    test_parse("#abc", 0, 0xAABBCC);
+    test_parse("  #2e3440  ", 0, NORD0);
+    test_parse("0X88C0D0", 0, NORD8);
+    test_parse("RGB(1,2,3)", 0, 0x010203);
+    test_parse("rgb( 191 , 97 , 106 ) ;", 0, NORD11);
+    test_parse("rgba(0, 0, 255, 0.5)", 0, 0x0000FF);
+    test_parse("hsl(0, 100%, 50%)", 0, 0xFF0000);
+    test_parse("hsl(240, 100%, 25%);", 0, 0x000080);
+    test_parse("1.0, 0.5, 0", 0, 0xFF8000);
+    test_parse("vec3(.5f, 1f, 0.0)", 0, 0x80FF00);
+    test_parse("vec4(0.00f, 0.00f, 0.00f, 1.00f)", 0, 0x000000);
+
+    test_parse("", -1, 0);
+    test_parse("#", -1, 0);
+    test_parse("#12345", -1, 0);
+    test_parse("#1234567", -1, 0);
+    test_parse("0x12345g", -1, 0);
+    test_parse("rgb(256, 0, 0)", -1, 0);
+    test_parse("rgb(1.5, 0, 0)", -1, 0);
+    test_parse("rgb(1, 2)", -1, 0);
+    test_parse("rgb(1, 2, 3", -1, 0);
+    test_parse("rgb(1, 2, 3) x", -1, 0);
+    test_parse("rgba(1, 2, 3, 2)", -1, 0);
+    test_parse("hsl(10, 20, 30)", -1, 0);
+    test_parse("hsl(400, 20%, 30%)", -1, 0);
+    test_parse("vec3(1.5, 0, 0)", -1, 0);
+    test_parse("vec4(1, 0, 0)", -1, 0);
+    test_parse("1, 2", -1, 0);
+    test_parse("-1, 0, 0", -1, 0);
+    test_parse("nord8", -1, 0);
+
+    // The text is bounded by its length, not a NUL.
+    uint32_t color = 0;
+    expect(nord_parse_color("#88C0D0FF", 7, &color, nullptr) == 0 &&
+               color == NORD8,
+           "parsing a prefix", NORD8);
+}
+
+static void test_palette(void) {
+    NordOklab palette[NORD_PALETTE_LENGTH];
+    nord_rgb_to_oklab_n(nord_palette, NORD_PALETTE_LENGTH, palette);
+    for (size_t i = 0; i < NORD_PALETTE_LENGTH; i++) {  // NOLINT
+        expect(nord_nearest(palette, NORD_PALETTE_LENGTH, palette[i]) == i,
+               "nearest palette color to itself", nord_palette[i]);
+    }
+    expect(nord_nearest(palette, NORD_PALETTE_LENGTH,
+                        nord_rgb_to_oklab(0x000000)) == 0,
+           "nearest palette color to black", 0x000000);
+    expect(nord_nearest(palette, NORD_PALETTE_LENGTH,
+                        nord_rgb_to_oklab(0xFF0000)) == 11,
+           "nearest palette color to red", 0xFF0000);
+    expect(nord_nearest(palette, 0, palette[0]) == 0, "empty palette", 0);
+
+    NordOklab white = nord_rgb_to_oklab(0xFFFFFF);
+    expect(fabsf(white.l - 1.0F) < 1e-3F && fabsf(white.a) < 1e-3F &&
+               fabsf(white.b) < 1e-3F,
+           "white in OKLab", 0xFFFFFF);
+
+    char texts[NORD_PALETTE_LENGTH][NORD_TEXT_SIZE];
+    size_t lengths[NORD_PALETTE_LENGTH];
+    for (int f = 0; f < NORD_FORMAT_COUNT; f++) {  // NOLINT
+        nord_format_colors(nord_palette, NORD_PALETTE_LENGTH, (NordFormat)f,
+                           texts, lengths);
+        for (size_t i = 0; i < NORD_PALETTE_LENGTH; i++) {  // NOLINT
+            char text[NORD_TEXT_SIZE];
+            size_t len = nord_format_color(nord_palette[i], (NordFormat)f,
+                                           text, sizeof(text));
+            expect(len == lengths[i] && strcmp(text, texts[i]) == 0,
+                   "batch formatting", nord_palette[i]);
+        }
+    }
+
+    char text[4];
+    size_t len = nord_format_color(NORD8, NORD_FORMAT_HTML_HEX, text,
+                                   sizeof(text));
+    expect(len == 7 && strcmp(text, "#88") == 0, "truncated formatting",
+           NORD8);
+    len = nord_format_color(NORD8, NORD_FORMAT_COUNT, text, sizeof(text));
+    expect(len == 0 && text[0] == '\0', "unknown format", NORD8);
+    expect(strcmp(nord_format_name(NORD_FORMAT_COUNT), "") == 0,
+           "unknown format name", 0);
+}
+
+// The palette with its labels, texts in the exporter's format.
+static char export_labels[NORD_PALETTE_LENGTH][8];
+static char export_texts[NORD_PALETTE_LENGTH][NORD_TEXT_SIZE];
+
+static NordExportPalette export_palette(NordExport kind, NordFormat preferred,
+                                        size_t count) {
+    nord_format_colors(nord_palette, NORD_PALETTE_LENGTH,
+                       nord_export_format(kind, preferred), export_texts,
+                       nullptr);
+    for (size_t i = 0; i < NORD_PALETTE_LENGTH; i++) {  // NOLINT
+        (void)snprintf(export_labels[i], sizeof(export_labels[i]), "nord%zu",
+                       i);
+    }
+    return (NordExportPalette){ .count        = count,
+                                .labels       = export_labels[0],
+                                .label_stride = sizeof(export_labels[0]),
+                                .texts        = export_texts[0],
+                                .text_stride  = sizeof(export_texts[0]) };
+}
+
+// Export the first two colors and compare with the expected text.
+static void test_export_text(NordExport kind, NordFormat preferred,
+                             const char *expected) {
+    static char buf[256];
+    static NordWriter writer;
+    NordExportPalette palette = export_palette(kind, preferred, 2);
+    nord_writer_buffer(&writer, buf, sizeof(buf));
+    int status = nord_export(&writer, kind, &palette);
+    checks++;
+    if (status != 0 || writer.total != strlen(expected) ||
+        memcmp(buf, expected, writer.total) != 0) {
+        failures++;
+        (void)fprintf(stderr, "FAIL: %s export gave \"%.*s\"\n",
+                      nord_export_name(kind), (int)writer.total, buf);
+    }
+}
+
+// The whole palette through a file must equal the buffer, and a buffer that
+// is too small must still report the full size.
+static void test_export_fd(NordExport kind) {
+    static char buf[4096];
+    static char file_buf[4096];
+    static NordWriter writer;
+    NordExportPalette palette =
+        export_palette(kind, NORD_FORMAT_CSS_RGB, NORD_PALETTE_LENGTH);
+    nord_writer_buffer(&writer, buf, sizeof(buf));
+    expect(nord_export(&writer, kind, &palette) == 0 &&
+               writer.total < sizeof(buf),
+           nord_export_name(kind), 0);
+    size_t total = writer.total;
+
+    FILE *file = tmpfile();
+    if (!file) {
+        expect(false, "tmpfile", 0);
+        return;
+    }
+    nord_writer_fd(&writer, fileno(file));
+    expect(nord_export(&writer, kind, &palette) == 0 && writer.total == total,
+           "export to a file", 0);
+    rewind(file);
+    size_t read = fread(file_buf, 1, sizeof(file_buf), file);
+    expect(read == total && memcmp(buf, file_buf, total) == 0,
+           "file export matches the buffer", 0);
+    (void)fclose(file);
+
+    char small[8];
+    nord_writer_buffer(&writer, small, sizeof(small));
+    expect(nord_export(&writer, kind, &palette) == 0 &&
+               writer.total == total && memcmp(small, buf, sizeof(small)) == 0,
+           "truncated export", 0);
+}
+
+static void test_export(void) {
+    test_export_text(NORD_EXPORT_CSS, NORD_FORMAT_CSS_RGB,
+                     ":root {\n  --nord0: rgb(46, 52, 64);\n"
+                     "  --nord1: rgb(59, 66, 82);\n}\n");
+    test_export_text(NORD_EXPORT_SCSS, NORD_FORMAT_VEC3,
+                     "$palette: (\n  \"nord0\": #2E3440,\n"
+                     "  \"nord1\": #3B4252,\n);\n");
+    test_export_text(NORD_EXPORT_JSON, NORD_FORMAT_HSL,
+                     "{\n  \"nord0\": \"hsl(220, 16%, 22%)\",\n"
+                     "  \"nord1\": \"hsl(222, 16%, 28%)\"\n}\n");
+    test_export_text(NORD_EXPORT_XRESOURCES, NORD_FORMAT_HSL,
+                     "#define nord0 #2E3440\n#define nord1 #3B4252\n");
+    test_export_text(NORD_EXPORT_GLSL, NORD_FORMAT_HTML_HEX,
+                     "const vec3 nord0 = vec3(0.18f, 0.20f, 0.25f);\n"
+                     "const vec3 nord1 = vec3(0.23f, 0.26f, 0.32f);\n");
+    test_export_text(NORD_EXPORT_HLSL, NORD_FORMAT_HTML_HEX,
+                     "static const float3 nord0 = "
+                     "float3(0.18f, 0.20f, 0.25f);\n"
+                     "static const float3 nord1 = "
+                     "float3(0.23f, 0.26f, 0.32f);\n");
+
+    for (int k = 0; k < NORD_EXPORT_COUNT; k++) {  // NOLINT
+        test_export_fd((NordExport)k);
+    }
+
+    // Terminal themes need all 16 colors.
+    static NordWriter writer;
+    char buf[64];
+    NordExportPalette palette =
+        export_palette(NORD_EXPORT_FOOT, NORD_FORMAT_HTML_HEX, 2);
+    nord_writer_buffer(&writer, buf, sizeof(buf));
+    errno = 0;
+    expect(nord_export(&writer, NORD_EXPORT_FOOT, &palette) == -1 &&
+               errno == EINVAL,
+           "terminal theme of 2 colors", 0);
+    expect(nord_export(&writer, NORD_EXPORT_COUNT, &palette) == -1 &&
+               errno == EINVAL,
+           "unknown exporter", 0);
+
+    expect(nord_export_lookup("Xresources") == NORD_EXPORT_XRESOURCES &&
+               nord_export_lookup("KITTY") == NORD_EXPORT_KITTY &&
+               nord_export_lookup("vim") == -1,
+           "exporter lookup", 0);
+    expect(nord_format_lookup("html-hex") == NORD_FORMAT_HTML_HEX &&
+               nord_format_lookup("css_rgba") == NORD_FORMAT_CSS_RGBA &&
+               nord_format_lookup("css") == -1,
+           "format lookup", 0);
+}
+
+static void test_index(void) {
+    static uint32_t colors[INDEX_COLORS];
+    static NordOklab labs[INDEX_COLORS];
+    static NordIndexNode nodes[INDEX_COLORS];
+    for (uint32_t i = 0; i < INDEX_COLORS; i++) {  // NOLINT
+        colors[i] = ((i % INDEX_DISTINCT) * 2654435761U) & 0xFFFFFFU;
+    }
+    nord_rgb_to_oklab_n(colors, INDEX_COLORS, labs);
+
+    NordIndex index;
+    for (size_t count = 0; count <= INDEX_COLORS;  // NOLINT
+         count = count < 8 ? count + 1 : count * 4) {
+        nord_index_build(&index, colors, count, nodes);
+        for (uint32_t color = 0; color < COLOR_LIMIT;  // NOLINT
+             color += COLOR_STEP * 7) {
+            NordOklab lab = nord_rgb_to_oklab(color);
+            expect(nord_index_nearest(&index, lab) ==
+                       nord_nearest(labs, count, lab),
+                   "k-d tree nearest", color);
+        }
+    }
+    nord_index_build(&index, colors, INDEX_COLORS, nodes);
+    for (uint32_t i = 0; i < INDEX_COLORS; i++) {  // NOLINT
+        expect(nord_index_nearest(&index, labs[i]) == i % INDEX_DISTINCT,
+               "k-d tree exact match", colors[i]);
+    }
+}
+
+static void test_gradient(void) {
+    uint32_t stops[5];
+    for (int space = 0; space < NORD_SPACE_COUNT; space++) {  // NOLINT
+        for (size_t i = 0; i < NORD_PALETTE_LENGTH; i++) {    // NOLINT
+            uint32_t from = nord_palette[i];
+            uint32_t to   = nord_palette[NORD_PALETTE_LENGTH - 1 - i];
+            nord_gradient(from, to, (NordSpace)space, stops, 5);
+            expect(stops[0] == from && stops[4] == to, "gradient ends", from);
+
+            // Lightness moves one way from end to end.
+            float step = nord_rgb_to_oklab(to).l - nord_rgb_to_oklab(from).l;
+            for (size_t s = 1; s < 5; s++) {  // NOLINT
+                float moved = nord_rgb_to_oklab(stops[s]).l -
+                              nord_rgb_to_oklab(stops[s - 1]).l;
+                expect(moved * step >= -1e-3F, "gradient lightness", from);
+            }
+        }
+    }
+    nord_gradient(NORD11, NORD0, NORD_SPACE_OKLAB, stops, 1);
+    expect(stops[0] == NORD11, "single stop gradient", NORD11);
+
+    // Gray takes the hue of the other end, so OKLCH keeps the red hue.
+    nord_gradient(0xFF0000, 0x808080, NORD_SPACE_OKLCH, stops, 3);
+    NordOklch mid = nord_oklab_to_oklch(nord_rgb_to_oklab(stops[1]));
+    NordOklch red = nord_oklab_to_oklch(nord_rgb_to_oklab(0xFF0000));
+    expect(fabsf(mid.h - red.h) < 2.0F, "gray gradient hue", stops[1]);
+
+    // Red to blue through OKLCH takes the short way, past magenta.
+    nord_gradient(0xFF0000, 0x0000FF, NORD_SPACE_OKLCH, stops, 3);
+    expect(((stops[1] >> 16U) & 0xFFU) > 0x80 && (stops[1] & 0xFFU) > 0x80 &&
+               ((stops[1] >> 8U) & 0xFFU) < 0x40,
+           "hue takes the short way", stops[1]);
+
+    const uint32_t two[2] = { NORD0, NORD6 };
+    char text[128];
+    nord_format_gradient(two, 2, NORD_GRADIENT_CSS, NORD_FORMAT_HTML_HEX,
+                         text, sizeof(text));
+    expect(strcmp(text, "linear-gradient(to right, #2E3440, #ECEFF4);") == 0,
+           "CSS gradient", NORD0);
+    nord_format_gradient(two, 2, NORD_GRADIENT_STOPS, NORD_FORMAT_CSS_RGB,
+                         text, sizeof(text));
+    expect(strcmp(text, "rgb(46, 52, 64);\nrgb(236, 239, 244);") == 0,
+           "gradient stops", NORD0);
+    size_t len = nord_format_gradient(two, 2, NORD_GRADIENT_GLSL,
+                                      NORD_FORMAT_HTML_HEX, text,
+                                      sizeof(text));
+    expect(strcmp(text, "const vec3 gradient[2] = vec3[2](\n"
+                        "    vec3(0.18f, 0.20f, 0.25f),\n"
+                        "    vec3(0.93f, 0.94f, 0.96f)\n);") == 0 &&
+               len == strlen(text),
+           "GLSL gradient", NORD0);
+
+    char small[8];
+    expect(nord_format_gradient(two, 2, NORD_GRADIENT_GLSL,
+                                NORD_FORMAT_HTML_HEX, small,
+                                sizeof(small)) == len &&
+               strlen(small) == sizeof(small) - 1,
+           "truncated gradient", NORD0);
+}
+
+// Red minus blue, which warming raises.
+static int warmth(uint32_t color) {
+    return (int)((color >> 16U) & 0xFFU) - (int)(color & 0xFFU);
+}
+
+static void test_transform(void) {
+    static NordOklab labs[INDEX_COLORS];
+    static uint32_t colors[INDEX_COLORS];
+    static uint32_t out[INDEX_COLORS];
+    for (uint32_t i = 0; i < INDEX_COLORS; i++) {  // NOLINT
+        colors[i] = (i * COLOR_STEP * 2654435761U) & 0xFFFFFFU;
+    }
+    nord_rgb_to_oklab_n(colors, INDEX_COLORS, labs);
+
+    NordTransform same = NORD_TRANSFORM_IDENTITY;
+    nord_transform_n(labs, INDEX_COLORS, &same, out);
+    for (uint32_t i = 0; i < INDEX_COLORS; i++) {  // NOLINT
+        expect(out[i] == nord_oklab_to_rgb(labs[i]), "identity transform",
+               colors[i]);
+    }
+
+    // A batch that ends partway through a block gives the same colors as
+    // transforming them one at a time.
+    NordTransform turn = { .hue         = 120.0F,
+                           .lightness   = 1.1F,
+                           .chroma      = 0.8F,
+                           .temperature = 0.5F };
+    nord_transform_n(labs, INDEX_COLORS - 3, &turn, out);
+    for (uint32_t i = 0; i < INDEX_COLORS - 3; i++) {  // NOLINT
+        uint32_t one = 0;
+        nord_transform_n(&labs[i], 1, &turn, &one);
+        expect(out[i] == one, "batch transform", colors[i]);
+    }
+
+    turn = (NordTransform){ .hue = 360.0F, .lightness = 1.0F, .chroma = 1.0F };
+    nord_transform_n(labs, INDEX_COLORS, &turn, out);
+    for (uint32_t i = 0; i < INDEX_COLORS; i++) {  // NOLINT
+        expect(channel_error(out[i], nord_oklab_to_rgb(labs[i])) <= 1,
+               "full hue turn", colors[i]);
+    }
+
+    NordTransform gray = { .lightness = 1.0F, .chroma = 0.0F };
+    nord_transform_n(labs, INDEX_COLORS, &gray, out);
+    for (uint32_t i = 0; i < INDEX_COLORS; i++) {  // NOLINT
+        uint32_t r = (out[i] >> 16U) & 0xFFU;
+        expect(channel_error(out[i], (r << 16U) | (r << 8U) | r) <= 1,
+               "no chroma is gray", colors[i]);
+    }
+
+    NordTransform dark = { .lightness = 0.0F, .chroma = 0.0F };
+    nord_transform_n(labs, INDEX_COLORS, &dark, out);
+    for (uint32_t i = 0; i < INDEX_COLORS; i++) {  // NOLINT
+        expect(out[i] == 0, "no lightness is black", colors[i]);
+    }
+
+    NordOklab white = nord_rgb_to_oklab(NORD6);
+    uint32_t warm   = 0;
+    uint32_t cool   = 0;
+    NordTransform t = NORD_TRANSFORM_IDENTITY;
+    t.temperature   = 1.0F;
+    nord_transform_n(&white, 1, &t, &warm);
+    t.temperature = -1.0F;
+    nord_transform_n(&white, 1, &t, &cool);
+    expect(warmth(warm) > warmth(NORD6) && warmth(cool) < warmth(NORD6),
+           "temperature", NORD6);
+
+    // Half a turn takes red toward cyan.
+    NordOklab red = nord_rgb_to_oklab(0xFF0000);
+    uint32_t cyan = 0;
+    t = (NordTransform){ .hue = 180.0F, .lightness = 1.0F, .chroma = 1.0F };
+    nord_transform_n(&red, 1, &t, &cyan);
+    expect(warmth(cyan) < 0 && ((cyan >> 8U) & 0xFFU) > ((cyan >> 16U) & 0xFFU),
+           "half hue turn", cyan);
+}
+
+int main(void) {
+    for (size_t i = 0; i < NORD_PALETTE_LENGTH; i++) {  // NOLINT
+        test_round_trip(nord_palette[i]);
+    }
+    for (uint32_t color = 0; color < COLOR_LIMIT;  // NOLINT
+         color += COLOR_STEP) {
+        test_round_trip(color);
+    }
+    test_round_trip(0xFFFFFF);
+    // Every channel value in the float formats.
+    for (uint32_t v = 0; v < 256; v++) {  // NOLINT(altera-unroll-loops)
+        test_round_trip((v << 16U) | ((255U - v) << 8U) | v);
+    }
+    test_parser();
+    test_palette();
+    test_export();
+    test_index();
+    test_gradient();
+    test_transform();
+
+    if (failures) {
+        (void)fprintf(stderr, "%zu of %zu checks failed.\n", failures,
+                      checks);
+        return EXIT_FAILURE;
+    }
+    (void)printf("All %zu checks passed.\n", checks);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/*
+ * Filename: dock_test.c
+ *
+ * Description: Tests for the dock as a whole, run on the null backend so no
+ * X server is needed. The first frame must paint every box in its palette
+ * color, and a later expose must repaint them. A click must copy the box's
+ * color and show it pressed until the release, and a Ctrl+click selection
+ * must copy its colors joined by the separator. Prints each failure and exits
+ * nonzero if there was any.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_context.h"
+#include "backend.h"
+#include "backend_null.h"
+#include "color_box.h"
+#include "dock.h"
+#include "render_cache.h"
+
+// The X backends are left out of this build; the registry only names them.
+const Backend xlib_backend = { .name = "xlib" };
+const Backend xcb_backend  = { .name = "xcb" };
+
+static size_t checks;
+static size_t failures;
+
+static void expect(bool ok, const char *what) {
+    checks++;
+    if (!ok) {
+        failures++;
+        (void)fprintf(stderr, "FAIL: %s\n", what);
+    }
+}
+
+static uint32_t pixel(uint32_t x, uint32_t y) {
+    const Raster *dock = null_backend_framebuffer(DOCK_SURFACE);
+    if (!dock || x >= dock->width || y >= dock->height) {
+        return UINT32_MAX;
+    }
+    return dock->pixels[((size_t)y * dock->stride) + x] & 0xFFFFFFU;
+}
+
+// The top left corner of a box, away from its label.
+static uint32_t box_corner(const ColorBox *box) {
+    return pixel(box->x + scaled(1), box->y + scaled(1));
+}
+
+static void run_events(void) {
+    DockEvent event;
+    while (wait_event(app.backend, &event)) {  // NOLINT
+        handle_event(&event);
+    }
+}
+
+static void click(const ColorBox *box, DockEventType type,
+                  uint32_t modifiers) {
+    int at = (int)(app.rect_size / 2);
+    DockEvent event = { .type      = type,
+                        .surface   = DOCK_SURFACE,
+                        .button    = BUTTON_LEFT,
+                        .modifiers = modifiers,
+                        .x         = (int)box->x + at,
+                        .y         = (int)box->y + at,
+                        .root_x    = (int)box->x + at,
+                        .root_y    = (int)box->y + at };
+    expect(null_backend_push_event(&event), "event queued");
+    run_events();
+}
+
+static void test_first_frame(void) {
+    expect(null_backend_framebuffer(DOCK_SURFACE) != nullptr,
+           "dock framebuffer exists");
+    for (size_t i = 0; i < PALETTE_LENGTH; i++) {  // NOLINT
+        const ColorBox *box = palette_box(i);
+        expect(box_corner(box) == box->color, "box painted in its color");
+    }
+}
+
+static void test_expose(void) {
+    const Raster *dock = null_backend_framebuffer(DOCK_SURFACE);
+    memset(dock->pixels, 0,
+           (size_t)dock->stride * dock->height * sizeof(*dock->pixels));
+    DockEvent expose = { .type = EVENT_EXPOSE, .surface = DOCK_SURFACE };
+    expect(null_backend_push_event(&expose), "event queued");
+    run_events();
+    const ColorBox *box = palette_box(0);
+    expect(box_corner(box) == box->color, "expose repaints the boxes");
+}
+
+static void test_click(void) {
+    ColorBox *box = palette_box(8);
+    click(box, EVENT_BUTTON_PRESS, 0);
+    expect(strcmp(null_backend_clipboard(), "#88C0D0") == 0,
+           "click copies the box color");
+    expect(box_corner(box) == BACKGROUND, "pressed box drawn smaller");
+    click(box, EVENT_BUTTON_RELEASE, 0);
+    expect(box_corner(box) == box->color, "released box drawn in full");
+}
+
+static void test_selection(void) {
+    click(palette_box(0), EVENT_BUTTON_PRESS, MOD_CONTROL);
+    click(palette_box(0), EVENT_BUTTON_RELEASE, MOD_CONTROL);
+    click(palette_box(11), EVENT_BUTTON_PRESS, MOD_CONTROL);
+    click(palette_box(11), EVENT_BUTTON_RELEASE, MOD_CONTROL);
+    expect(strcmp(null_backend_clipboard(), "#2E3440\n#BF616A") == 0,
+           "selection copies its colors in order");
+}
+
+int main(void) {
+    render_cache_disable();
+    app.backend = &null_backend;
+    if (app.backend->open() != 0 || !select_monitor(nullptr) ||
+        initialize_dock() != 0) {
+        (void)fprintf(stderr, "The null backend did not start.\n");
+        return EXIT_FAILURE;
+    }
+    initialize_color_boxes();
+    run_events();
+
+    test_first_frame();
+    test_expose();
+    test_click();
+    test_selection();
+    cleanup_dock();
+
+    if (failures) {
+        (void)fprintf(stderr, "%zu of %zu checks failed.\n", failures,
+                      checks);
+        return EXIT_FAILURE;
+    }
+    (void)printf("All %zu checks passed.\n", checks);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,349 @@
+/*
+ * Filename: selection_server_test.c
+ *
+ * Description: Tests for the selection server, built with its Xlib calls
+ * and clock replaced by stubs that record what it sends, so no X server is
+ * needed. INCR transfers must take turns one chunk per pass, starting one
+ * transfer later on each pass, and must deliver the whole text. A requestor
+ * that stops reading must be dropped once the timeout has passed and not
+ * before, and the timer must be armed for that moment. A destroyed
+ * requestor window must end its transfers. Prints each failure and exits
+ * nonzero if there was any.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <X11/Xlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+
+#include "selection_server.h"
+#include "stats.h"
+
+#define NS_PER_MS 1000000ULL
+
+// Requests of 1024 bytes leave 768-byte chunks after the request header.
+#define MAX_REQUEST_UNITS 256
+#define CHUNK 768U
+
+#define OWNER 1U
+#define CLIENTS 3U
+#define TEXT_LEN ((CHUNK * 2U) + 100U)
+
+#define MAX_CALLS 64
+
+#define ATOM_CLIPBOARD 100U
+#define ATOM_TARGETS 101U
+#define ATOM_UTF8 102U
+#define ATOM_COMPOUND 103U
+#define ATOM_INCR 104U
+#define ATOM_PROPERTY 105U
+
+// One XChangeProperty the server made.
+typedef struct {
+    Window window;
+    Atom type;
+    int count;
+} PropertyCall;
+
+static struct {
+    uint64_t now_ns;
+    PropertyCall props[MAX_CALLS];
+    size_t prop_count;
+    Window unselected[MAX_CALLS];  // Windows given NoEventMask.
+    size_t unselected_count;
+    size_t notifies;
+} x;
+
+static size_t checks;
+static size_t failures;
+
+DockStats stats;
+
+uint64_t stats_now_ns(void) {
+    return x.now_ns;
+}
+
+// Xlib, as far as the selection server uses it.
+long XExtendedMaxRequestSize(Display *display) {
+    (void)display;
+    return 0;
+}
+
+long XMaxRequestSize(Display *display) {
+    (void)display;
+    return MAX_REQUEST_UNITS;
+}
+
+XErrorHandler XSetErrorHandler(XErrorHandler handler) {
+    (void)handler;
+    return nullptr;
+}
+
+int XSetSelectionOwner(Display *display, Atom selection, Window owner,
+                       Time time) {
+    (void)display;
+    (void)selection;
+    (void)owner;
+    (void)time;
+    return 1;
+}
+
+Window XGetSelectionOwner(Display *display, Atom selection) {
+    (void)display;
+    (void)selection;
+    return OWNER;
+}
+
+int XChangeProperty(Display *display, Window window, Atom property,
+                    Atom type, int format, int mode,
+                    const unsigned char *data, int count) {
+    (void)display;
+    (void)property;
+    (void)format;
+    (void)mode;
+    (void)data;
+    if (x.prop_count < MAX_CALLS) {
+        x.props[x.prop_count++] =
+            (PropertyCall){ .window = window, .type = type, .count = count };
+    }
+    return 1;
+}
+
+int XSelectInput(Display *display, Window window, long mask) {
+    (void)display;
+    if (mask == NoEventMask && x.unselected_count < MAX_CALLS) {
+        x.unselected[x.unselected_count++] = window;
+    }
+    return 1;
+}
+
+Status XSendEvent(Display *display, Window window, Bool propagate,
+                  long mask, XEvent *event) {
+    (void)display;
+    (void)window;
+    (void)propagate;
+    (void)mask;
+    (void)event;
+    x.notifies++;
+    return 1;
+}
+
+int XFlush(Display *display) {
+    (void)display;
+    return 1;
+}
+
+static void expect(bool ok, const char *what) {
+    checks++;
+    if (!ok) {
+        failures++;
+        (void)fprintf(stderr, "FAIL: %s\n", what);
+    }
+}
+
+static void reset_calls(void) {
+    x.prop_count       = 0;
+    x.unselected_count = 0;
+    x.notifies         = 0;
+}
+
+static void set_up(SelectionServer *server) {
+    static const SelectionAtoms atoms = { .selection     = ATOM_CLIPBOARD,
+                                          .targets       = ATOM_TARGETS,
+                                          .utf8_string   = ATOM_UTF8,
+                                          .compound_text = ATOM_COMPOUND,
+                                          .incr          = ATOM_INCR };
+    static char text[TEXT_LEN];
+    memset(text, 'n', sizeof(text));
+    x.now_ns = NS_PER_MS;
+    selection_server_init(server, (Display *)&x, OWNER, &atoms);
+    expect(server->chunk == CHUNK, "chunk size from the request limit");
+    expect(selection_server_own(server, text, sizeof(text)) == 0,
+           "owning the selection");
+    reset_calls();
+}
+
+static void request(SelectionServer *server, Window requestor) {
+    XEvent event;
+    memset(&event, 0, sizeof(event));
+    event.xselectionrequest.type      = SelectionRequest;
+    event.xselectionrequest.owner     = OWNER;
+    event.xselectionrequest.requestor = requestor;
+    event.xselectionrequest.selection = ATOM_CLIPBOARD;
+    event.xselectionrequest.target    = ATOM_UTF8;
+    event.xselectionrequest.property  = ATOM_PROPERTY;
+    expect(selection_server_handle_event(server, &event),
+           "request consumed");
+}
+
+// The requestor deleted the property: it wants the next chunk.
+static void read_chunk(SelectionServer *server, Window requestor) {
+    XEvent event;
+    memset(&event, 0, sizeof(event));
+    event.xproperty.type   = PropertyNotify;
+    event.xproperty.window = requestor;
+    event.xproperty.atom   = ATOM_PROPERTY;
+    event.xproperty.state  = PropertyDelete;
+    expect(selection_server_handle_event(server, &event),
+           "property deletion consumed");
+}
+
+static size_t live_transfers(const SelectionServer *server) {
+    size_t live = 0;
+    for (size_t i = 0; i < SELECTION_MAX_TRANSFERS; i++) {  // NOLINT
+        live += server->transfers[i].requestor ? 1 : 0;
+    }
+    return live;
+}
+
+static bool unselected(Window window) {
+    for (size_t i = 0; i < x.unselected_count; i++) {  // NOLINT
+        if (x.unselected[i] == window) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint64_t timer_left_ns(const SelectionServer *server) {
+    struct itimerspec spec;
+    if (timerfd_gettime(server->timer_fd, &spec) != 0) {
+        return 0;
+    }
+    return ((uint64_t)spec.it_value.tv_sec * 1000000000ULL) +
+           (uint64_t)spec.it_value.tv_nsec;
+}
+
+// Three requestors read as fast as they can. Every pass sends one chunk to
+// each, starting one requestor later than the pass before, and each gets
+// the whole text followed by the empty chunk that ends INCR.
+static void test_round_robin(void) {
+    SelectionServer server;
+    set_up(&server);
+    for (Window w = 10; w < 10 + CLIENTS; w++) {  // NOLINT
+        request(&server, w);
+    }
+    expect(x.prop_count == CLIENTS && x.props[0].type == ATOM_INCR,
+           "large texts start INCR");
+    expect(x.notifies == CLIENTS, "every request answered");
+
+    size_t sent[CLIENTS] = { 0 };
+    size_t ends          = 0;
+    for (size_t pass = 0; pass < 4; pass++) {  // NOLINT
+        for (Window w = 10; w < 10 + CLIENTS; w++) {  // NOLINT
+            read_chunk(&server, w);
+        }
+        reset_calls();
+        selection_server_pump(&server);
+        expect(x.prop_count == CLIENTS, "one chunk per transfer and pass");
+        for (size_t i = 0; i < x.prop_count; i++) {  // NOLINT
+            size_t client = (size_t)(x.props[i].window - 10);
+            if (client >= CLIENTS) {
+                continue;
+            }
+            sent[client] += (size_t)x.props[i].count;
+            ends += x.props[i].count == 0 ? 1 : 0;
+        }
+        // Entries are filled in order, so the first chunk of pass p goes to
+        // the requestor in entry p, while there are entries to rotate to.
+        if (pass < CLIENTS) {
+            expect(x.props[0].window == 10 + pass,
+                   "each pass starts one transfer later");
+        }
+    }
+    for (size_t i = 0; i < CLIENTS; i++) {  // NOLINT
+        expect(sent[i] == TEXT_LEN, "whole text sent to each requestor");
+    }
+    expect(ends == CLIENTS, "each transfer ended by an empty chunk");
+    expect(live_transfers(&server) == 0, "finished transfers freed");
+    selection_server_free(&server);
+}
+
+// Only one requestor reads; the others get nothing while it moves on.
+static void test_slow_requestor(void) {
+    SelectionServer server;
+    set_up(&server);
+    request(&server, 20);
+    request(&server, 21);
+    read_chunk(&server, 21);
+    reset_calls();
+    selection_server_pump(&server);
+    expect(x.prop_count == 1 && x.props[0].window == 21,
+           "only the ready requestor is sent a chunk");
+    read_chunk(&server, 21);
+    reset_calls();
+    selection_server_pump(&server);
+    expect(x.prop_count == 1 && x.props[0].window == 21,
+           "a waiting requestor does not hold up the other");
+    selection_server_free(&server);
+}
+
+// A requestor that stops reading is dropped just after the timeout, and
+// the timer is armed so the event loop wakes up for it.
+static void test_timeout(void) {
+    SelectionServer server;
+    set_up(&server);
+    request(&server, 30);
+    selection_server_pump(&server);
+    uint64_t timeout_ns = SELECTION_TIMEOUT_MS * NS_PER_MS;
+    uint64_t left_ns    = timer_left_ns(&server);
+    expect(server.timer_fd >= 0, "timer created");
+    expect(left_ns > timeout_ns - (100 * NS_PER_MS) && left_ns <= timeout_ns,
+           "timer armed for the timeout");
+
+    x.now_ns += timeout_ns;
+    selection_server_pump(&server);
+    expect(live_transfers(&server) == 1, "kept until the timeout has passed");
+
+    x.now_ns += 1;
+    reset_calls();
+    selection_server_pump(&server);
+    expect(live_transfers(&server) == 0, "dropped after the timeout");
+    expect(unselected(30), "input withdrawn from the dropped requestor");
+    expect(timer_left_ns(&server) == 0, "timer disarmed with no transfers");
+    selection_server_free(&server);
+    expect(server.timer_fd == -1, "timer closed");
+}
+
+// A destroyed requestor window ends its transfers without touching the
+// window again.
+static void test_destroyed_requestor(void) {
+    SelectionServer server;
+    set_up(&server);
+    request(&server, 40);
+    request(&server, 41);
+    XEvent event;
+    memset(&event, 0, sizeof(event));
+    event.xdestroywindow.type   = DestroyNotify;
+    event.xdestroywindow.window = 40;
+    reset_calls();
+    expect(selection_server_handle_event(&server, &event),
+           "destruction consumed");
+    expect(live_transfers(&server) == 1, "destroyed requestor dropped");
+    expect(!unselected(40), "destroyed window left alone");
+    selection_server_free(&server);
+}
+
+int main(void) {
+    test_round_robin();
+    test_slow_requestor();
+    test_timeout();
+    test_destroyed_requestor();
+
+    if (failures) {
+        (void)fprintf(stderr, "%zu of %zu checks failed.\n", failures,
+                      checks);
+        return EXIT_FAILURE;
+    }
+    (void)printf("All %zu checks passed.\n", checks);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+#!/usr/bin/awk -f
+#
+# Filename: gen_names.awk
+#
+# Description: Turns color name files into a C header of static const
+# tables, one table per file: the colors and their names, with the tables
+# stored back to back. Two line formats are read, so the files can be used
+# as they are published:
+#
+#   aliceblue #F0F8FF          a name and #RRGGBB, as in xkcd's rgb.txt
+#   240 248 255  alice blue    decimal red, green and blue, as in X11's
+#
+# Lines starting with '!' or '#' are comments. Within a table only the
+# first name of each color is kept, since a lookup returns one name.
+#
+# Usage: awk -v titles="css x11" -f tools/gen_names.awk css.txt x11.txt \
+#            > name_tables.h
+#
+# Author: Michael Knap
+# Date: 2025-02-13
+# License: MIT
+
+function hex_value(text,    i, value) {
+    value = 0
+    text  = tolower(text)
+    for (i = 1; i <= length(text); i++) {
+        value = value * 16 + index("0123456789abcdef", substr(text, i, 1)) - 1
+    }
+    return value
+}
+
+# Fields first through last joined by single spaces.
+function join(first, last,    i, text) {
+    text = $first
+    for (i = first + 1; i <= last; i++) {
+        text = text " " $i
+    }
+    return text
+}
+
+function c_string(text) {
+    gsub(/\\/, "\\\\", text)
+    gsub(/"/, "\\\"", text)
+    return "\"" text "\""
+}
+
+BEGIN {
+    table_count = split(titles, title, " ")
+    table       = 0
+    count       = 0
+}
+
+FNR == 1 {
+    table++
+    start[table] = count
+    delete seen
+}
+
+/^[ \t]*([!#]|$)/ {
+    next
+}
+
+{
+    sub(/\r$/, "")
+    if (NF >= 2 && $NF ~ /^#[0-9A-Fa-f]+$/ && length($NF) == 7) {
+        value = hex_value(substr($NF, 2))
+        name  = join(1, NF - 1)
+    } else if (NF >= 4 && $1 ~ /^[0-9]+$/ && $2 ~ /^[0-9]+$/ &&
+               $3 ~ /^[0-9]+$/ && $1 < 256 && $2 < 256 && $3 < 256) {
+        value = ($1 * 65536) + ($2 * 256) + $3
+        name  = join(4, NF)
+    } else {
+        printf("%s:%d: expected a name and #RRGGBB, or R G B and a name\n",
+               FILENAME, FNR) > "/dev/stderr"
+        failed = 1
+        exit 1
+    }
+    if (value in seen) {
+        next
+    }
+    seen[value]  = 1
+    color[count] = value
+    label[count] = name
+    count++
+}
+
+END {
+    if (failed) {
+        exit 1
+    }
+    if (table != table_count) {
+        printf("gen_names.awk: %d files but %d titles\n", table,
+               table_count) > "/dev/stderr"
+        exit 1
+    }
+    start[table + 1] = count
+
+    print "// Generated by tools/gen_names.awk. Do not edit."
+    print ""
+    print "#ifndef NAME_TABLES_H"
+    print "#define NAME_TABLES_H"
+    print ""
+    print "#include <stdint.h>"
+    print ""
+    printf("#define NAME_TABLE_COUNT %d\n", table)
+    printf("#define NAME_COLOR_COUNT %d\n", count)
+    print ""
+    print "static const char *const name_table_titles[NAME_TABLE_COUNT] = {"
+    for (t = 1; t <= table; t++) {
+        printf("    %s,\n", c_string(title[t]))
+    }
+    print "};"
+    print ""
+    print "// Table t spans name_table_starts[t] to name_table_starts[t + 1]."
+    print "static const uint32_t name_table_starts[NAME_TABLE_COUNT + 1] = {"
+    for (t = 1; t <= table + 1; t++) {
+        printf("    %d,\n", start[t])
+    }
+    print "};"
+    print ""
+    print "static const uint32_t name_colors[NAME_COLOR_COUNT] = {"
+    for (i = 0; i < count; i++) {
+        printf("    0x%06X,\n", color[i])
+    }
+    print "};"
+    print ""
+    print "static const char *const name_labels[NAME_COLOR_COUNT] = {"
+    for (i = 0; i < count; i++) {
+        printf("    %s,\n", c_string(label[i]))
+    }
+    print "};"
+    print ""
+    print "#endif  // NAME_TABLES_H"
+}
@@ -0,0 +1,179 @@
+#!/usr/bin/awk -f
+#
+# Filename: gen_palette.awk
+#
+# Description: Turns a palette file into a C header of static const tables:
+# colors, labels, label lengths and the text of every color in every
+# NordFormat, so the dock does no formatting for its built-in palette. The
+# formatting mirrors nord_format_color() in lib/arctic_nord.c; make
+# check-palette compares the two.
+#
+# Usage: awk -f tools/gen_palette.awk src/nord.palette > palette_tables.h
+#
+# Author: Michael Knap
+# Date: 2025-02-13
+# License: MIT
+
+function hex_value(text,    i, value) {
+    value = 0
+    text  = tolower(text)
+    for (i = 1; i <= length(text); i++) {
+        value = value * 16 + index("0123456789abcdef", substr(text, i, 1)) - 1
+    }
+    return value
+}
+
+# round() for the non-negative values used here.
+function round_up_half(x) {
+    return int(x + 0.5)
+}
+
+function max3(a, b, c) {
+    return a > b ? (a > c ? a : c) : (b > c ? b : c)
+}
+
+function min3(a, b, c) {
+    return a < b ? (a < c ? a : c) : (b < c ? b : c)
+}
+
+function hsl(r, g, b,    max, min, delta, h, s, l) {
+    max   = max3(r, g, b)
+    min   = min3(r, g, b)
+    delta = max - min
+    h     = 0.0
+    s     = 0.0
+    l     = (max + min) / 2.0
+    if (delta != 0.0) {
+        s = l < 0.5 ? delta / (max + min) : delta / (2.0 - max - min)
+        if (max == r) {
+            h = (g - b) / delta
+        } else if (max == g) {
+            h = 2.0 + (b - r) / delta
+        } else {
+            h = 4.0 + (r - g) / delta
+        }
+        h *= 60.0
+        if (h < 0) {
+            h += 360.0
+        }
+    }
+    return sprintf("hsl(%d, %d%%, %d%%);", round_up_half(h),
+                   round_up_half(s * 100), round_up_half(l * 100))
+}
+
+# Every format of one color, in NordFormat order.
+function add_texts(n, color,    r, g, b, rn, gn, bn) {
+    r  = int(color / 65536)
+    g  = int(color / 256) % 256
+    b  = color % 256
+    rn = r / 255.0
+    gn = g / 255.0
+    bn = b / 255.0
+    text[0, n] = sprintf("#%02X%02X%02X", r, g, b)
+    text[1, n] = sprintf("0x%02x%02x%02x", r, g, b)
+    text[2, n] = sprintf("rgb(%d, %d, %d);", r, g, b)
+    text[3, n] = sprintf("rgba(%d, %d, %d, 1);", r, g, b)
+    text[4, n] = hsl(rn, gn, bn)
+    text[5, n] = sprintf("%.2ff, %.2ff, %.2ff", rn, gn, bn)
+    text[6, n] = sprintf("vec3(%.2ff, %.2ff, %.2ff)", rn, gn, bn)
+    text[7, n] = sprintf("vec4(%.2ff, %.2ff, %.2ff, 1.00f)", rn, gn, bn)
+}
+
+BEGIN {
+    FORMATS    = 8
+    count      = 0
+    label_size = 1
+    text_size  = 1
+}
+
+/^[ \t]*(#|$)/ {
+    next
+}
+
+{
+    if (NF != 2 || length($2) != 7 || $2 !~ /^#[0-9A-Fa-f]+$/) {
+        printf("%s:%d: expected a label and #RRGGBB\n", FILENAME, FNR) > "/dev/stderr"
+        failed = 1
+        exit 1
+    }
+    label[count] = $1
+    color[count] = hex_value(substr($2, 2))
+    add_texts(count, color[count])
+    if (length($1) >= label_size) {
+        label_size = length($1) + 1
+    }
+    for (f = 0; f < FORMATS; f++) {
+        if (length(text[f, count]) >= text_size) {
+            text_size = length(text[f, count]) + 1
+        }
+    }
+    count++
+}
+
+END {
+    if (failed) {
+        exit 1
+    }
+    source = FILENAME
+    print "// Generated from " source " by tools/gen_palette.awk. Do not edit."
+    print ""
+    print "#ifndef PALETTE_TABLES_H"
+    print "#define PALETTE_TABLES_H"
+    print ""
+    print "#include <assert.h>"
+    print "#include <stdint.h>"
+    print ""
+    print "#include \"arctic_nord.h\""
+    print ""
+    printf("#define PALETTE_TABLE_LENGTH %d\n", count)
+    printf("#define PALETTE_LABEL_SIZE %d\n", label_size)
+    printf("#define PALETTE_TEXT_SIZE %d\n", text_size)
+    print ""
+    printf("static_assert(NORD_FORMAT_COUNT == %d,\n", FORMATS)
+    print "              \"tools/gen_palette.awk is out of date\");"
+    print ""
+    print "static const uint32_t palette_colors[PALETTE_TABLE_LENGTH] = {"
+    for (i = 0; i < count; i++) {
+        printf("    0x%06X,\n", color[i])
+    }
+    print "};"
+    print ""
+    print "static const char"
+    print "    palette_labels[PALETTE_TABLE_LENGTH][PALETTE_LABEL_SIZE] = {"
+    for (i = 0; i < count; i++) {
+        printf("    \"%s\",\n", label[i])
+    }
+    print "};"
+    print ""
+    print "static const uint8_t palette_label_lengths[PALETTE_TABLE_LENGTH] = {"
+    for (i = 0; i < count; i++) {
+        printf("    %d,\n", length(label[i]))
+    }
+    print "};"
+    print ""
+    print "// Every color in every format, indexed by NordFormat and then" \
+          " color."
+    print "static const char palette_texts[NORD_FORMAT_COUNT]" \
+          "[PALETTE_TABLE_LENGTH][PALETTE_TEXT_SIZE] = {"
+    for (f = 0; f < FORMATS; f++) {
+        print "        {"
+        for (i = 0; i < count; i++) {
+            printf("            \"%s\",\n", text[f, i])
+        }
+        print "        },"
+    }
+    print "};"
+    print ""
+    print "static const uint8_t palette_text_lengths[NORD_FORMAT_COUNT]" \
+          "[PALETTE_TABLE_LENGTH] = {"
+    for (f = 0; f < FORMATS; f++) {
+        printf("    {")
+        for (i = 0; i < count; i++) {
+            printf("%s%d", i ? ", " : " ", length(text[f, i]))
+        }
+        print " },"
+    }
+    print "};"
+    print ""
+    print "#endif  // PALETTE_TABLES_H"
+}
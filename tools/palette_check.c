@@ -0,0 +1,52 @@
+/*
+ * Filename: palette_check.c
+ *
+ * Description: Checks the generated palette tables against
+ * nord_format_color(): every color in every format must match the runtime
+ * string and its stored length, and every label length must match its
+ * label. Run by make check-palette.
+ *
+ * Author: Michael Knap
+ * Date: 2025-02-13
+ * License: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arctic_nord.h"
+#include "palette_tables.h"
+
+int main(void) {
+    size_t failures = 0;
+    for (size_t i = 0; i < PALETTE_TABLE_LENGTH; i++) {  // NOLINT
+        if (strlen(palette_labels[i]) != palette_label_lengths[i]) {
+            (void)fprintf(stderr, "%s: label length %u\n", palette_labels[i],
+                          (unsigned)palette_label_lengths[i]);
+            failures++;
+        }
+        for (int f = 0; f < NORD_FORMAT_COUNT; f++) {  // NOLINT
+            char expected[PALETTE_TEXT_SIZE * 2];
+            nord_format_color(palette_colors[i], (NordFormat)f, expected,
+                              sizeof(expected));
+            const char *text = palette_texts[f][i];
+            if (strcmp(text, expected) != 0 ||
+                strlen(text) != palette_text_lengths[f][i]) {
+                (void)fprintf(stderr, "%s, %s: generated \"%s\" (%u), "
+                                      "nord_format_color \"%s\"\n",
+                              palette_labels[i],
+                              nord_format_name((NordFormat)f), text,
+                              (unsigned)palette_text_lengths[f][i], expected);
+                failures++;
+            }
+        }
+    }
+    if (failures) {
+        (void)fprintf(stderr, "%zu palette table mismatches.\n", failures);
+        return EXIT_FAILURE;
+    }
+    (void)printf("%u colors in %d formats match nord_format_color().\n",
+                 (unsigned)PALETTE_TABLE_LENGTH, NORD_FORMAT_COUNT);
+    return EXIT_SUCCESS;
+}